@@ -20,6 +20,16 @@
     BOOL _started;
     int _failCount;
     int _waitFrames;
+
+    NSInteger _numAllocations;
+    NSInteger _numMeasuredFrames;
+    NSInteger _lastAllocationCount;
+}
+
+static NSInteger geometryAllocationCount(void)
+{
+    // temporary geometry objects are the most common allocations within a frame
+    return [SPPoint numAllocations] + [SPRectangle numAllocations] + [SPMatrix numAllocations];
 }
 
 - (instancetype)init
@@ -58,6 +68,12 @@
     
     _elapsed += event.passedTime;
     ++_frameCount;
+
+    // everything between two 'enterFrame' events belongs to one frame (including rendering)
+    NSInteger allocationCount = geometryAllocationCount();
+    _numAllocations += allocationCount - _lastAllocationCount;
+    _lastAllocationCount = allocationCount;
+    ++_numMeasuredFrames;
     
     if (_frameCount % _waitFrames == 0)
     {
@@ -102,6 +118,8 @@
     _resultText = nil;
     
     _frameCount = 0;
+    _numAllocations = _numMeasuredFrames = 0;
+    _lastAllocationCount = geometryAllocationCount();
     [self addTestObjects:500];
 }
 
@@ -111,15 +129,17 @@
     _startButton.visible = YES;
     
     int frameRate = (int)Sparrow.currentController.framesPerSecond;
+    int allocationsPerFrame = _numMeasuredFrames ? (int)(_numAllocations / _numMeasuredFrames) : 0;
     
     NSLog(@"benchmark complete!");
     NSLog(@"fps: %d", frameRate);
     NSLog(@"number of objects: %ld", (long)_container.numChildren);
+    NSLog(@"geometry allocations per frame: %d", allocationsPerFrame);
     
-    NSString *resultString = [NSString stringWithFormat:@"Result:\n%ld objects\nwith %d fps", 
-                              (long)_container.numChildren, frameRate];
+    NSString *resultString = [NSString stringWithFormat:@"Result:\n%ld objects\nwith %d fps\n%d allocs/frame",
+                              (long)_container.numChildren, frameRate, allocationsPerFrame];
     
-    _resultText = [SPTextField textFieldWithWidth:250 height:200 text:resultString];
+    _resultText = [SPTextField textFieldWithWidth:250 height:220 text:resultString];
     _resultText.fontSize = 30;
     _resultText.color = 0x0;
     _resultText.x = (320 - _resultText.width) / 2;
@@ -26,6 +26,12 @@ NS_ASSUME_NONNULL_BEGIN
  Alpha and matrix uniforms will be passed to the program automatically, and the texture will be
  bound.
  
+ **Multiple textures**
+ 
+ An effect can sample from up to `maxNumTextures` textures at once. Assign them with
+ `setTexture:atSlot:` and set `numTextures` accordingly; each vertex then selects its texture via
+ the `attribTextureSlot` attribute. All textures need to use the same `premultipliedAlpha` setting.
+ 
 ------------------------------------------------------------------------------------------------- */
 
 @interface SPBaseEffect : NSObject
@@ -35,9 +41,19 @@ NS_ASSUME_NONNULL_BEGIN
 /// -------------
 
 /// Activates the optimal shader program for the current settings; alpha and matrix uniforms are
-/// passed to the program right away, and the texture (if available) is bound.
+/// passed to the program right away, and the textures (if available) are bound.
 - (void)prepareToDraw;
 
+/// Returns the texture at a certain slot; slot zero contains `texture`.
+- (nullable SPTexture *)textureAtSlot:(NSInteger)slot;
+
+/// Assigns the texture of a certain slot; slot zero contains `texture`.
+- (void)setTexture:(nullable SPTexture *)texture atSlot:(NSInteger)slot;
+
+/// The number of textures that can be bound at the same time, i.e. the number of texture units
+/// of the current device (but no more than `SP_MAX_NUM_TEXTURES`).
++ (NSInteger)maxNumTextures;
+
 /// ----------------
 /// @name Properties
 /// ----------------
@@ -53,6 +69,10 @@ NS_ASSUME_NONNULL_BEGIN
 /// The texture that's projected onto the quad, or `nil` if there is none. (Default: `nil`)
 @property (nonatomic, strong, nullable) SPTexture *texture;
 
+/// The number of texture slots that are bound when drawing. With more than one slot, the shader
+/// picks the texture of each vertex via the `attribTextureSlot` attribute. (Default: 1)
+@property (nonatomic, assign) NSInteger numTextures;
+
 /// Indicates if the color values of texture and vertices use premultiplied alpha. (Default: `NO`)
 @property (nonatomic, assign) BOOL premultipliedAlpha;
 
@@ -64,15 +84,23 @@ NS_ASSUME_NONNULL_BEGIN
 /// The alpha value with which every vertex color will be multiplied. (Default: 1)
 @property (nonatomic, assign) float alpha;
 
+/// If positive, textures and vertex colors are ignored, and every fragment is drawn in a gray of
+/// this brightness. Drawn additively, this shows how often each pixel is covered. (Default: 0)
+@property (nonatomic, assign) float overdrawBrightness;
+
 /// The index of the vertex attribute storing the position vector.
 @property (nonatomic, readonly) int attribPosition;
 
-/// The index of the vertex attribute storing the two texture coordinates.
+/// The index of the vertex attribute storing the two texture coordinates, or -1 while drawing
+/// overdraw.
 @property (nonatomic, readonly) int attribTexCoords;
 
-/// The index of the vertex attribute storing the color vector.
+/// The index of the vertex attribute storing the color vector, or -1 while drawing overdraw.
 @property (nonatomic, readonly) int attribColor;
 
+/// The index of the vertex attribute storing the texture slot, or -1 if only one texture is used.
+@property (nonatomic, readonly) int attribTextureSlot;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -18,9 +18,13 @@
 #import "SPProgram.h"
 #import "SPTexture.h"
 
-static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
+#define OVERDRAW_PROGRAM_NAME @"SPQuad#overdraw"
+
+static NSString *getProgramName(BOOL hasTexture, BOOL useTinting, NSInteger numTextures)
 {
-    if (hasTexture)
+    if (hasTexture && numTextures > 1)
+        return [NSString stringWithFormat:@"SPQuad#1%dx%ld", useTinting, (long)numTextures];
+    else if (hasTexture)
     {
         if (useTinting) return @"SPQuad#11";
         else            return @"SPQuad#10";
@@ -37,8 +41,10 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
 @implementation SPBaseEffect
 {
     SPMatrix3D *_mvpMatrix3D;
-    SPTexture *_texture;
+    SPTexture *_textures[SP_MAX_NUM_TEXTURES];
+    NSInteger _numTextures;
     float _alpha;
+    float _overdrawBrightness;
     BOOL _useTinting;
     BOOL _premultipliedAlpha;
     
@@ -46,6 +52,7 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
     int _aPosition;
     int _aColor;
     int _aTexCoords;
+    int _aTextureSlot;
     int _uMvpMatrix;
     int _uAlpha;
 }
@@ -53,6 +60,7 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
 @synthesize attribPosition = _aPosition;
 @synthesize attribColor = _aColor;
 @synthesize attribTexCoords = _aTexCoords;
+@synthesize attribTextureSlot = _aTextureSlot;
 
 #pragma mark Initialization
 
@@ -63,6 +71,7 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
         _mvpMatrix3D = [[SPMatrix3D alloc] init];
         _premultipliedAlpha = NO;
         _useTinting = YES;
+        _numTextures = 1;
         _alpha = 1.0f;
     }
     return self;
@@ -71,7 +80,9 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
 - (void)dealloc
 {
     [_mvpMatrix3D release];
-    [_texture release];
+    for (NSInteger i=0; i<SP_MAX_NUM_TEXTURES; ++i)
+        [_textures[i] release];
+
     [_program release];
     [super dealloc];
 }
@@ -80,27 +91,44 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
 
 - (void)prepareToDraw
 {
-    BOOL hasTexture = _texture != nil;
-    BOOL useTinting = _useTinting || !_texture || _alpha != 1.0f;
+    if (_overdrawBrightness > 0.0f)
+    {
+        [self prepareToDrawOverdraw];
+        return;
+    }
+
+    SPTexture *texture = _textures[0];
+    BOOL hasTexture = texture != nil;
+    BOOL useTinting = _useTinting || !texture || _alpha != 1.0f;
+    NSInteger numTextures = hasTexture ? _numTextures : 0;
 
     if (!_program)
     {
-        NSString *programName = getProgramName(hasTexture, useTinting);
+        NSString *programName = getProgramName(hasTexture, useTinting, numTextures);
         _program = [[Sparrow.currentController programByName:programName] retain];
         
         if (!_program)
         {
-            NSString *vertexShader   = [self vertexShaderForTexture:_texture   useTinting:useTinting];
-            NSString *fragmentShader = [self fragmentShaderForTexture:_texture useTinting:useTinting];
+            NSString *vertexShader   = [self vertexShaderForTexture:texture   useTinting:useTinting];
+            NSString *fragmentShader = [self fragmentShaderForTexture:texture useTinting:useTinting];
             _program = [[SPProgram alloc] initWithVertexShader:vertexShader fragmentShader:fragmentShader];
             [Sparrow.currentController registerProgram:_program name:programName];
+
+            // samplers default to unit zero; with several textures, each needs its own unit
+            if (numTextures > 1)
+            {
+                glUseProgram(_program.name);
+                for (NSInteger i=0; i<numTextures; ++i)
+                    glUniform1i([_program uniformByName:[NSString stringWithFormat:@"uTexture%ld", (long)i]], (GLint)i);
+            }
         }
         
-        _aPosition  = [_program attributeByName:@"aPosition"];
-        _aColor     = [_program attributeByName:@"aColor"];
-        _aTexCoords = [_program attributeByName:@"aTexCoords"];
-        _uMvpMatrix = [_program uniformByName:@"uMvpMatrix"];
-        _uAlpha     = [_program uniformByName:@"uAlpha"];
+        _aPosition    = [_program attributeByName:@"aPosition"];
+        _aColor       = [_program attributeByName:@"aColor"];
+        _aTexCoords   = [_program attributeByName:@"aTexCoords"];
+        _aTextureSlot = numTextures > 1 ? [_program attributeByName:@"aTextureSlot"] : -1;
+        _uMvpMatrix   = [_program uniformByName:@"uMvpMatrix"];
+        _uAlpha       = [_program uniformByName:@"uAlpha"];
     }
     
     glUseProgram(_program.name);
@@ -114,11 +142,45 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
     
     if (hasTexture)
     {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, _texture.name);
+        // bind in reverse order, so that unit zero is active afterwards (as it used to be)
+        for (NSInteger i=numTextures-1; i>=0; --i)
+        {
+            SPTexture *slotTexture = _textures[i] ?: texture;
+            glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+            glBindTexture(GL_TEXTURE_2D, slotTexture.name);
+        }
     }
 }
 
+- (SPTexture *)textureAtSlot:(NSInteger)slot
+{
+    if (slot < 0 || slot >= SP_MAX_NUM_TEXTURES)
+        [NSException raise:SPExceptionIndexOutOfBounds format:@"Invalid texture slot"];
+
+    return _textures[slot];
+}
+
+- (void)setTexture:(SPTexture *)texture atSlot:(NSInteger)slot
+{
+    if (slot < 0 || slot >= SP_MAX_NUM_TEXTURES)
+        [NSException raise:SPExceptionIndexOutOfBounds format:@"Invalid texture slot"];
+
+    if (slot == 0 && ((_textures[0] && !texture) || (!_textures[0] && texture)))
+        SP_RELEASE_AND_NIL(_program);
+
+    SP_RELEASE_AND_RETAIN(_textures[slot], texture);
+}
+
++ (NSInteger)maxNumTextures
+{
+    static GLint numTextureUnits = 0;
+
+    if (numTextureUnits <= 0)
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &numTextureUnits);
+
+    return MAX(1, MIN(numTextureUnits, SP_MAX_NUM_TEXTURES));
+}
+
 #pragma mark Properties
 
 - (SPMatrix *)mvpMatrix
@@ -144,6 +206,14 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
     _alpha = value;
 }
 
+- (void)setOverdrawBrightness:(float)value
+{
+    if ((value > 0.0f) != (_overdrawBrightness > 0.0f))
+        SP_RELEASE_AND_NIL(_program);
+
+    _overdrawBrightness = value;
+}
+
 - (void)setUseTinting:(BOOL)value
 {
     if (value != _useTinting)
@@ -153,19 +223,73 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
     }
 }
 
+- (SPTexture *)texture
+{
+    return _textures[0];
+}
+
 - (void)setTexture:(SPTexture *)value
 {
-    if ((_texture && !value) || (!_texture && value))
-        SP_RELEASE_AND_NIL(_program);
+    [self setTexture:value atSlot:0];
+}
 
-    SP_RELEASE_AND_RETAIN(_texture, value);
+- (void)setNumTextures:(NSInteger)value
+{
+    value = MAX(1, MIN(value, SP_MAX_NUM_TEXTURES));
+
+    if (value != _numTextures)
+    {
+        _numTextures = value;
+        SP_RELEASE_AND_NIL(_program);
+    }
 }
 
 #pragma mark Private
 
+- (void)prepareToDrawOverdraw
+{
+    if (!_program)
+    {
+        _program = [[Sparrow.currentController programByName:OVERDRAW_PROGRAM_NAME] retain];
+
+        if (!_program)
+        {
+            NSString *vertexShader =
+                @"attribute vec4 aPosition;\n"
+                @"uniform mat4 uMvpMatrix;\n"
+                @"void main() {\n"
+                @"  gl_Position = uMvpMatrix * aPosition;\n"
+                @"}";
+
+            NSString *fragmentShader =
+                @"uniform lowp vec4 uAlpha;\n"
+                @"void main() {\n"
+                @"  gl_FragColor = uAlpha;\n"
+                @"}";
+
+            _program = [[SPProgram alloc] initWithVertexShader:vertexShader fragmentShader:fragmentShader];
+            [Sparrow.currentController registerProgram:_program name:OVERDRAW_PROGRAM_NAME];
+        }
+
+        _aPosition    = [_program attributeByName:@"aPosition"];
+        _aColor       = -1;
+        _aTexCoords   = -1;
+        _aTextureSlot = -1;
+        _uMvpMatrix   = [_program uniformByName:@"uMvpMatrix"];
+        _uAlpha       = [_program uniformByName:@"uAlpha"];
+    }
+
+    float brightness = _overdrawBrightness;
+
+    glUseProgram(_program.name);
+    glUniformMatrix4fv(_uMvpMatrix, 1, NO, _mvpMatrix3D.rawData);
+    glUniform4f(_uAlpha, brightness, brightness, brightness, brightness);
+}
+
 - (NSString *)vertexShaderForTexture:(SPTexture *)texture useTinting:(BOOL)useTinting
 {
     BOOL hasTexture = texture != nil;
+    BOOL hasTextureSlot = hasTexture && _numTextures > 1;
     NSMutableString *source = [NSMutableString string];
     
     // variables
@@ -173,12 +297,14 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
     [source appendLine:@"attribute vec4 aPosition;"];
     if (useTinting) [source appendLine:@"attribute vec4 aColor;"];
     if (hasTexture) [source appendLine:@"attribute vec2 aTexCoords;"];
+    if (hasTextureSlot) [source appendLine:@"attribute float aTextureSlot;"];
 
     [source appendLine:@"uniform mat4 uMvpMatrix;"];
     if (useTinting) [source appendLine:@"uniform vec4 uAlpha;"];
     
     if (useTinting) [source appendLine:@"varying lowp vec4 vColor;"];
     if (hasTexture) [source appendLine:@"varying lowp vec2 vTexCoords;"];
+    if (hasTextureSlot) [source appendLine:@"varying mediump float vTextureSlot;"];
     
     // main
     
@@ -187,6 +313,7 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
     [source appendLine:@"  gl_Position = uMvpMatrix * aPosition;"];
     if (useTinting) [source appendLine:@"  vColor = aColor * uAlpha;"];
     if (hasTexture) [source appendLine:@"  vTexCoords  = aTexCoords;"];
+    if (hasTextureSlot) [source appendLine:@"  vTextureSlot = aTextureSlot;"];
     
     [source appendString:@"}"];
     
@@ -203,7 +330,15 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
     if (useTinting)
         [source appendLine:@"varying lowp vec4 vColor;"];
     
-    if (hasTexture)
+    if (hasTexture && _numTextures > 1)
+    {
+        [source appendLine:@"varying lowp vec2 vTexCoords;"];
+        [source appendLine:@"varying mediump float vTextureSlot;"];
+
+        for (NSInteger i=0; i<_numTextures; ++i)
+            [source appendFormat:@"uniform lowp sampler2D uTexture%ld;\n", (long)i];
+    }
+    else if (hasTexture)
     {
         [source appendLine:@"varying lowp vec2 vTexCoords;"];
         [source appendLine:@"uniform lowp sampler2D uTexture;"];
@@ -213,7 +348,23 @@ static NSString *getProgramName(BOOL hasTexture, BOOL useTinting)
     
     [source appendLine:@"void main() {"];
     
-    if (hasTexture)
+    if (hasTexture && _numTextures > 1)
+    {
+        // GLSL ES 2 can't index samplers dynamically. Branching on the varying would sample in
+        // non-uniform control flow (where derivatives, and thus mipmapping, are undefined), so all
+        // textures are sampled and weighted by whether they match the slot.
+        [source appendLine:@"  lowp vec4 texColor = vec4(0.0);"];
+
+        for (NSInteger i=0; i<_numTextures; ++i)
+            [source appendFormat:@"  texColor += texture2D(uTexture%ld, vTexCoords) * "
+                                  "(1.0 - step(0.5, abs(vTextureSlot - %ld.0)));\n", (long)i, (long)i];
+
+        if (useTinting)
+            [source appendLine:@"  gl_FragColor = texColor * vColor;"];
+        else
+            [source appendLine:@"  gl_FragColor = texColor;"];
+    }
+    else if (hasTexture)
     {
         if (useTinting)
             [source appendLine:@"  gl_FragColor = texture2D(uTexture, vTexCoords) * vColor;"];
@@ -179,10 +179,6 @@ NSString *const SPBitmapFontMiniName = @"mini";
 
     _helperImage.color = color;
 
-    if (charLocations.count > 8192)
-        [NSException raise:SPExceptionInvalidOperation
-                    format:@"Bitmap font text is limited to 8192 characters"];
-
     for (SPCharLocation *charLocation in charLocations)
     {
         _helperImage.texture = charLocation.bitmapChar.texture;
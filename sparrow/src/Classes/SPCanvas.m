@@ -11,6 +11,9 @@
 
 #import "SparrowClass.h"
 #import "SPCanvas.h"
+#import "SPContext.h"
+#import "SPContext_Internal.h"
+#import "SPDisplayObject_Internal.h"
 #import "SPIndexData.h"
 #import "SPMatrix.h"
 #import "SPMatrix3D.h"
@@ -19,21 +22,33 @@
 #import "SPPolygon.h"
 #import "SPProgram.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
+#import "SPTessellationCache.h"
 #import "SPVertexData.h"
 #import "SPViewController.h"
 
 #define PROGRAM_NAME @"Shape"
 
+// canvases up to this size are batched with other meshes instead of using buffers of their own
+#define MAX_BATCHED_VERTICES 256
+
+// --- class implementation ------------------------------------------------------------------------
+
 @implementation SPCanvas
 {
     BOOL _syncRequired;
     NSMutableArray<SPPolygon*> *_polygons;
+    NSMutableData *_polygonOffsets;
     SPProgram *_program;
     
     SPVertexData *_vertexData;
     uint _vertexBufferName;
+    NSInteger _vertexBufferCapacity;
+    NSInteger _numSyncedVertices;
     SPIndexData *_indexData;
     uint _indexBufferName;
+    NSInteger _indexBufferCapacity;
+    NSInteger _numSyncedIndices;
     
     uint _fillColor;
     float _fillAlpha;
@@ -46,6 +61,7 @@
     if (self = [super init])
     {
         _polygons = [[NSMutableArray alloc] init];
+        _polygonOffsets = [[NSMutableData alloc] init];
         _vertexData = [[SPVertexData alloc] init];
         _indexData = [[SPIndexData alloc] init];
         _syncRequired = NO;
@@ -63,6 +79,7 @@
     [self destroyBuffers];
     
     [_polygons release];
+    [_polygonOffsets release];
     [_program release];
     [_vertexData release];
     [_indexData release];
@@ -73,22 +90,24 @@
 
 - (void)drawCircleWithX:(float)x y:(float)y radius:(float)radius
 {
-    [self appendPolygon:[SPPolygon circleWithX:x y:y radius:radius]];
+    [self drawEllipseWithX:x y:y radiusX:radius radiusY:radius];
 }
 
 - (void)drawEllipseWithX:(float)x y:(float)y radiusX:(float)radiusX radiusY:(float)radiusY
 {
-    [self appendPolygon:[SPPolygon elipseWithX:x y:y radiusX:radiusX radiusY:radiusY]];
+    SPTessellationCache *cache = SPTessellationCache.sharedCache;
+    [self appendTessellation:[cache tessellationOfEllipseWithRadiusX:radiusX radiusY:radiusY] x:x y:y];
 }
 
 - (void)drawRectangleWithX:(float)x y:(float)y width:(float)width height:(float)height
 {
-    [self appendPolygon:[SPPolygon rectangleWithX:x y:y width:width height:height]];
+    SPTessellationCache *cache = SPTessellationCache.sharedCache;
+    [self appendTessellation:[cache tessellationOfRectangleWithWidth:width height:height] x:x y:y];
 }
 
 - (void)drawPolygon:(SPPolygon *)polygon
 {
-    [self appendPolygon:polygon];
+    [self appendTessellation:[SPTessellationCache.sharedCache tessellationOfPolygon:polygon] x:0 y:0];
 }
 
 - (void)beginFill:(uint)color
@@ -113,7 +132,12 @@
     _vertexData.numVertices = 0;
     _indexData.numIndices = 0;
     [_polygons removeAllObjects];
-    [self destroyBuffers];
+    _polygonOffsets.length = 0;
+    [self markDirty:SPDirtyFlagVertices];
+
+    // the buffers are kept; subsequent polygons are uploaded from the start
+    _numSyncedVertices = 0;
+    _numSyncedIndices = 0;
 }
 
 #pragma mark SPDisplayObject
@@ -121,9 +145,16 @@
 - (void)render:(SPRenderSupport *)support
 {
     if (_indexData.numIndices == 0) return;
+
+    if (_vertexData.numVertices <= MAX_BATCHED_VERTICES)
+    {
+        [support batchVertexData:_vertexData indexData:_indexData object:self];
+        return;
+    }
+
     if (_syncRequired) [self syncBuffers];
     
-    [support finishQuadBatch];
+    [support finishQuadBatchWithReason:SPBatchBreakReasonCustomRendering object:self];
     [support addDrawCalls:1];
     [support applyBlendModeForPremultipliedAlpha:NO];
     
@@ -134,7 +165,7 @@
     
     glUseProgram(_program.name);
     glUniformMatrix4fv(uMvpMatrix, 1, 0, support.mvpMatrix3D.rawData);
-    glUniform1f(uAlpha, support.alpha * self.alpha);
+    glUniform1f(uAlpha, support.alpha);
     
     glBindBuffer(GL_ARRAY_BUFFER, _vertexBufferName);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferName);
@@ -162,9 +193,16 @@
     if (forTouch && (!self.visible || !self.touchable))
         return nil;
     
+    // the polygons of cached shapes are located at the origin
+    const GLKVector2 *offsets = _polygonOffsets.bytes;
+    NSInteger index = 0;
+
     for (SPPolygon *polygon in _polygons)
-        if ([polygon containsPoint:localPoint])
+    {
+        GLKVector2 offset = offsets[index++];
+        if ([polygon containsPointWithX:localPoint.x - offset.x y:localPoint.y - offset.y])
             return self;
+    }
     
     return nil;
 }
@@ -178,8 +216,11 @@
     SP_RELEASE_AND_COPY(canvas->_vertexData, _vertexData);
     SP_RELEASE_AND_COPY(canvas->_indexData, _indexData);
     
+    // the polygons are never modified, so they can be shared
     [canvas->_polygons release];
-    canvas->_polygons = [[NSMutableArray alloc] initWithArray:_polygons copyItems:YES];
+    [canvas->_polygonOffsets release];
+    canvas->_polygons = [_polygons mutableCopy];
+    canvas->_polygonOffsets = [_polygonOffsets mutableCopy];
     
     canvas->_fillAlpha = _fillAlpha;
     canvas->_fillColor = _fillColor;
@@ -190,20 +231,39 @@
 
 #pragma mark Private
 
-- (void)appendPolygon:(SPPolygon *)polygon
+- (void)appendTessellation:(SPTessellation *)tessellation x:(float)x y:(float)y
 {
+    SPVertexData *vertexData = tessellation.vertexData;
+    SPIndexData *indexData = tessellation.indexData;
+
     NSInteger oldNumVertices = _vertexData.numVertices;
     NSInteger oldNumIndices = _indexData.numIndices;
-    
-    [polygon triangulate:_indexData];
-    [polygon copyToVertexData:_vertexData atIndex:oldNumVertices];
-    
-    NSInteger newNumIndices = _indexData.numIndices;
-    [_indexData offsetIndicesAtIndex:oldNumIndices numIndices:newNumIndices-oldNumIndices offset:oldNumVertices];
-    
-    [self applyFillColorAtIndex:oldNumVertices numVertices:polygon.numVertices];
-    
-    [_polygons addObject:polygon];
+    NSInteger numVertices = vertexData.numVertices;
+    NSInteger numIndices = indexData.numIndices;
+
+    _vertexData.numVertices = oldNumVertices + numVertices;
+    _indexData.numIndices = oldNumIndices + numIndices;
+
+    [vertexData copyToVertexData:_vertexData atIndex:oldNumVertices];
+    [indexData copyToIndexData:_indexData atIndex:oldNumIndices];
+    [_indexData offsetIndicesAtIndex:oldNumIndices numIndices:numIndices offset:oldNumVertices];
+
+    if (x || y)
+    {
+        SPVertex *vertices = _vertexData.vertices + oldNumVertices;
+        for (NSInteger i=0; i<numVertices; ++i)
+        {
+            vertices[i].position.x += x;
+            vertices[i].position.y += y;
+        }
+    }
+
+    [self applyFillColorAtIndex:oldNumVertices numVertices:numVertices];
+
+    GLKVector2 offset = GLKVector2Make(x, y);
+    [_polygons addObject:tessellation.polygon];
+    [_polygonOffsets appendBytes:&offset length:sizeof(GLKVector2)];
+    [self markDirty:SPDirtyFlagVertices];
     _syncRequired = YES;
 }
 
@@ -248,20 +308,47 @@
 
 - (void)syncBuffers
 {
-    [self destroyBuffers];
-    
+    // Polygons are only ever appended, so only the new vertices and indices are uploaded. The
+    // buffers are reallocated (and filled completely) only when they run out of capacity.
+
     NSInteger numVertices = _vertexData.numVertices;
     NSInteger numIndices  = _indexData.numIndices;
-    
-    glGenBuffers(1, &_vertexBufferName);
-    glGenBuffers(1, &_indexBufferName);
-    
+
+    if (!_vertexBufferName) glGenBuffers(1, &_vertexBufferName);
+    if (!_indexBufferName)  glGenBuffers(1, &_indexBufferName);
+
     glBindBuffer(GL_ARRAY_BUFFER, _vertexBufferName);
-    glBufferData(GL_ARRAY_BUFFER, numVertices * sizeof(SPVertex), _vertexData.vertices, GL_STATIC_DRAW);
-    
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferName);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(ushort), _indexData.indices, GL_STATIC_DRAW);
-    
+
+    if (numVertices > _vertexBufferCapacity)
+    {
+        _vertexBufferCapacity = SPExpandedCapacity(_vertexBufferCapacity, numVertices);
+        _numSyncedVertices = 0;
+        glBufferData(GL_ARRAY_BUFFER, _vertexBufferCapacity * sizeof(SPVertex), NULL, GL_DYNAMIC_DRAW);
+    }
+
+    if (numIndices > _indexBufferCapacity)
+    {
+        _indexBufferCapacity = SPExpandedCapacity(_indexBufferCapacity, numIndices);
+        _numSyncedIndices = 0;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexBufferCapacity * sizeof(ushort), NULL, GL_DYNAMIC_DRAW);
+    }
+
+    if (numVertices > _numSyncedVertices)
+    {
+        NSInteger numBytes = (numVertices - _numSyncedVertices) * sizeof(SPVertex);
+        glBufferSubData(GL_ARRAY_BUFFER, _numSyncedVertices * sizeof(SPVertex), numBytes,
+                        _vertexData.vertices + _numSyncedVertices);
+
+        SPContext.currentContext.numVertexBytesUploaded += numBytes;
+    }
+
+    if (numIndices > _numSyncedIndices)
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, _numSyncedIndices * sizeof(ushort),
+                        (numIndices - _numSyncedIndices) * sizeof(ushort), _indexData.indices + _numSyncedIndices);
+
+    _numSyncedVertices = numVertices;
+    _numSyncedIndices = numIndices;
     _syncRequired = NO;
 }
 
@@ -278,6 +365,9 @@
         glDeleteBuffers(1, &_indexBufferName);
         _indexBufferName = 0;
     }
+
+    _vertexBufferCapacity = _numSyncedVertices = 0;
+    _indexBufferCapacity = _numSyncedIndices = 0;
 }
 
 @end
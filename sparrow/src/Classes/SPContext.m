@@ -108,6 +108,24 @@
 
 @end
 
+// --- private constants ---------------------------------------------------------------------------
+
+// 65536 vertices: the most that can be addressed with 16 bit indices.
+#define MAX_QUAD_INDEX_BUFFER_CAPACITY 16384
+
+// The initial size of the streaming buffers (in bytes); they grow if a single upload needs more.
+#define STREAM_BUFFER_SIZE (512 * 1024)
+
+// --- private types -------------------------------------------------------------------------------
+
+// A buffer that data is appended to until it is full; see 'streamData:numBytes:target:buffer:offset:'.
+typedef struct
+{
+    uint name;
+    NSInteger size;
+    NSInteger position;
+} SPStreamBuffer;
+
 // --- context cache -------------------------------------------------------------------------------
 
 static SPCache<EAGLContext*, SPContext*> *contexts = nil;
@@ -130,6 +148,11 @@ static SPCache<EAGLContext*, SPContext*> *contexts = nil;
     uint _frameBuffer;
     uint _msaaFrameBuffer;
     uint _msaaColorRenderBuffer;
+    uint _quadIndexBuffer;
+    NSInteger _quadIndexBufferCapacity;
+    SPStreamBuffer _vertexStream;
+    SPStreamBuffer _indexStream;
+    NSInteger _numVertexBytesUploaded;
 }
 
 + (void)initialize
@@ -182,6 +205,15 @@ static SPCache<EAGLContext*, SPContext*> *contexts = nil;
 {
     [self destroyBuffers];
     
+    if (_quadIndexBuffer)
+        glDeleteBuffers(1, &_quadIndexBuffer);
+    
+    if (_vertexStream.name)
+        glDeleteBuffers(1, &_vertexStream.name);
+    
+    if (_indexStream.name)
+        glDeleteBuffers(1, &_indexStream.name);
+    
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glBindRenderbuffer(GL_RENDERBUFFER, 0);
     
@@ -607,4 +639,112 @@ static SPCache<EAGLContext*, SPContext*> *contexts = nil;
         [contexts[key]->_frameBuffers removeObjectForKey:texture];
 }
 
+- (uint)quadIndexBufferForNumQuads:(NSInteger)numQuads
+{
+    if (numQuads > MAX_QUAD_INDEX_BUFFER_CAPACITY)
+        [NSException raise:SPExceptionInvalidOperation
+                    format:@"16 bit indices can't address more than %d quads", MAX_QUAD_INDEX_BUFFER_CAPACITY];
+    
+    if (numQuads > _quadIndexBufferCapacity)
+    {
+        NSInteger capacity = MIN(SPExpandedCapacity(_quadIndexBufferCapacity, numQuads),
+                                 MAX_QUAD_INDEX_BUFFER_CAPACITY);
+        
+        if (!_quadIndexBuffer)
+            glGenBuffers(1, &_quadIndexBuffer);
+        
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadIndexBuffer);
+        [SPContext uploadQuadIndicesForNumQuads:capacity];
+        
+        _quadIndexBufferCapacity = capacity;
+    }
+    
+    return _quadIndexBuffer;
+}
+
++ (void)uploadQuadIndicesForNumQuads:(NSInteger)numQuads
+{
+    ushort *indices = malloc(sizeof(ushort) * numQuads * 6);
+    
+    for (NSInteger i=0; i<numQuads; ++i)
+    {
+        indices[i*6  ] = i*4;
+        indices[i*6+1] = i*4 + 1;
+        indices[i*6+2] = i*4 + 2;
+        indices[i*6+3] = i*4 + 1;
+        indices[i*6+4] = i*4 + 3;
+        indices[i*6+5] = i*4 + 2;
+    }
+    
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort) * numQuads * 6, indices, GL_STATIC_DRAW);
+    free(indices);
+}
+
+- (uint)streamVertexData:(const void *)data numBytes:(NSInteger)numBytes offset:(NSInteger *)offset
+{
+    _numVertexBytesUploaded += numBytes;
+    return [self streamData:data numBytes:numBytes target:GL_ARRAY_BUFFER buffer:&_vertexStream offset:offset];
+}
+
+- (uint)streamIndexData:(const ushort *)indices numIndices:(NSInteger)numIndices offset:(NSInteger *)offset
+{
+    return [self streamData:indices numBytes:sizeof(ushort) * numIndices target:GL_ELEMENT_ARRAY_BUFFER
+                     buffer:&_indexStream offset:offset];
+}
+
+- (uint)streamData:(const void *)data numBytes:(NSInteger)numBytes target:(GLenum)target
+            buffer:(SPStreamBuffer *)buffer offset:(NSInteger *)offset
+{
+    // Uploads are appended until the buffer is full. Then its storage is orphaned (via
+    // 'glBufferData' with a NULL pointer), so the driver can hand out fresh memory while the GPU
+    // is still reading from the old one. Between two orphanings, each range is written just once
+    // and is not in use by the GPU yet; thus, it is written through an unsynchronized mapping
+    // (GL_EXT_map_buffer_range). 'glBufferSubData' would make the driver wait for all pending
+    // draw calls that read from the same buffer.
+    
+    if (!buffer->name)
+        glGenBuffers(1, &buffer->name);
+    
+    glBindBuffer(target, buffer->name);
+    
+    // keep offsets aligned, as required by float attributes
+    NSInteger position = (buffer->position + 3) & ~3;
+    
+    if (position + numBytes > buffer->size)
+    {
+        NSInteger size = MAX(buffer->size, STREAM_BUFFER_SIZE);
+        while (size < numBytes) size *= 2;
+        
+        glBufferData(target, size, NULL, GL_STREAM_DRAW);
+        
+        buffer->size = size;
+        position = 0;
+    }
+    
+    GLbitfield access = GL_MAP_WRITE_BIT_EXT | GL_MAP_INVALIDATE_RANGE_BIT_EXT | GL_MAP_UNSYNCHRONIZED_BIT_EXT;
+    void *mapping = glMapBufferRangeEXT(target, position, numBytes, access);
+    
+    if (mapping)
+    {
+        memcpy(mapping, data, numBytes);
+        glUnmapBufferOES(target);
+    }
+    else glBufferSubData(target, position, numBytes, data); // mapping failed
+    
+    *offset = position;
+    buffer->position = position + numBytes;
+    
+    return buffer->name;
+}
+
+- (NSInteger)numVertexBytesUploaded
+{
+    return _numVertexBytesUploaded;
+}
+
+- (void)setNumVertexBytesUploaded:(NSInteger)numVertexBytesUploaded
+{
+    _numVertexBytesUploaded = numVertexBytesUploaded;
+}
+
 @end
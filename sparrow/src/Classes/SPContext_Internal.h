@@ -11,8 +11,40 @@
 
 #import "SPContext.h"
 
+/// Returns the capacity a growing buffer should be reallocated with to hold 'minCapacity'
+/// elements. Doubling the capacity keeps the number of reallocations logarithmic.
+SP_INLINE NSInteger SPExpandedCapacity(NSInteger capacity, NSInteger minCapacity)
+{
+    capacity = MAX(capacity, 64);
+    while (capacity < minCapacity) capacity *= 2;
+    return capacity;
+}
+
 @interface SPContext (Internal)
 
 + (void)clearFrameBuffersForTexture:(SPGLTexture *)texture;
 
+/// Returns an index buffer that contains the indices of at least 'numQuads' quads, in the order
+/// used by SPQuadBatch. The buffer is shared by all batches of the context and never shrinks;
+/// it can address up to 16384 quads.
+- (uint)quadIndexBufferForNumQuads:(NSInteger)numQuads;
+
+/// Uploads the indices of 'numQuads' quads, in the order used by `quadIndexBufferForNumQuads:`,
+/// into the buffer that is currently bound to `GL_ELEMENT_ARRAY_BUFFER`.
++ (void)uploadQuadIndicesForNumQuads:(NSInteger)numQuads;
+
+/// Uploads data into the streaming vertex buffer of the context and returns the name of that
+/// buffer, which is bound to `GL_ARRAY_BUFFER` afterwards. The byte offset of the data within the
+/// buffer is stored in 'offset'. Draw from it right away: once the buffer is full, its storage is
+/// orphaned and the offsets start over.
+- (uint)streamVertexData:(const void *)data numBytes:(NSInteger)numBytes offset:(NSInteger *)offset;
+
+/// Uploads indices into the streaming index buffer of the context, just like
+/// `streamVertexData:numBytes:offset:`; the buffer is bound to `GL_ELEMENT_ARRAY_BUFFER`
+/// afterwards. The byte offset of the indices is stored in 'offset'.
+- (uint)streamIndexData:(const ushort *)indices numIndices:(NSInteger)numIndices offset:(NSInteger *)offset;
+
+/// The total number of bytes that were uploaded to vertex buffers while this context was current.
+@property (nonatomic, assign) NSInteger numVertexBytesUploaded;
+
 @end
@@ -28,6 +28,38 @@ NS_ASSUME_NONNULL_BEGIN
 @class SPStage;
 @class SPVector3D;
 
+/// Describes the changes of a display object that are relevant for rendering. They are used to
+/// invalidate the render caches of display object containers.
+typedef NS_OPTIONS(NSInteger, SPDirtyFlags)
+{
+    /// Nothing changed.
+    SPDirtyFlagNone         = 0,
+
+    /// Position, scale, skew, rotation or pivot point changed.
+    SPDirtyFlagTransform    = 1 << 0,
+
+    /// The alpha value changed.
+    SPDirtyFlagAlpha        = 1 << 1,
+
+    /// The texture changed.
+    SPDirtyFlagTexture      = 1 << 2,
+
+    /// The visibility changed.
+    SPDirtyFlagVisibility   = 1 << 3,
+
+    /// A child was added, removed or reordered, or a descendant changed.
+    SPDirtyFlagChildren     = 1 << 4,
+
+    /// Vertex positions, colors or texture coordinates changed.
+    SPDirtyFlagVertices     = 1 << 5,
+
+    /// The blend mode, filter or mask changed.
+    SPDirtyFlagEffects      = 1 << 6,
+
+    /// All of the above.
+    SPDirtyFlagAll          = 0xff,
+};
+
 /** ------------------------------------------------------------------------------------------------
 
  The SPDisplayObject class is the base class for all objects that are rendered on the screen.
@@ -79,6 +111,9 @@ NS_ASSUME_NONNULL_BEGIN
  
  Have a look at SPQuad for a sample implementation of those methods. 
  
+ Containers cache the bounds of their children; when the bounds of your object change in a way
+ Sparrow cannot detect, call `setNeedsDisplay`.
+ 
 ------------------------------------------------------------------------------------------------- */
 
 @interface SPDisplayObject : SPEventDispatcher <NSCopying>
@@ -122,6 +157,11 @@ NS_ASSUME_NONNULL_BEGIN
 /// Transforms a point from global (stage) coordinates to the 3D local coordinate system.
 - (SPVector3D *)globalToLocal3D:(SPPoint *)globalPoint;
 
+/// Marks the object as changed, which invalidates the render caches of all containers it is part
+/// of. Sparrow does that automatically; you only need to call this method after changing an
+/// object in a way that cannot be detected, e.g. when modifying the vertex data of a subclass.
+- (void)setNeedsDisplay;
+
 /// Returns the object that is found topmost on a point in local coordinates, or nil if the test fails.
 /// Includes untouchable and invisible objects.
 - (nullable SPDisplayObject *)hitTestPoint:(SPPoint *)localPoint;
@@ -249,7 +289,8 @@ NS_ASSUME_NONNULL_BEGIN
 /// shapes) it is recommended to use a 'SPCanvas' instance.
 ///
 /// Beware that a mask will cause at least two additional draw calls: one to draw the mask to the
-/// stencil buffer and one to erase it.
+/// stencil buffer and one to erase it. The exception are quads that are not rotated (relative to
+/// the stage): they are cheap, because they are turned into clip rects.
 ///
 /// @see SPCanvas
 @property (nonatomic, strong, nullable) SPDisplayObject *mask;
@@ -257,6 +298,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// The blend mode determines how the object is blended with the objects underneath. Default: AUTO
 @property (nonatomic, assign) uint blendMode;
 
+/// The changes that happened since the object was last compiled into a render cache.
+@property (nonatomic, readonly) SPDirtyFlags dirtyFlags;
+
 /// Indicates if an object occupies any visible area. (Which is the case when its `alpha`,
 /// `scaleX` and `scaleY` values are not zero, and its `visible` property is enabled.)
 @property (nonatomic, readonly) BOOL hasVisibleArea;
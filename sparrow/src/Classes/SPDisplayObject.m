@@ -15,15 +15,37 @@
 #import "SPDisplayObjectContainer.h"
 #import "SPEnterFrameEvent.h"
 #import "SPEventDispatcher_Internal.h"
+#import "SPFragmentFilter.h"
 #import "SPMacros.h"
 #import "SPMatrix.h"
 #import "SPMatrix3D.h"
 #import "SPPoint.h"
+#import "SPQuad.h"
+#import "SPQuadBatch.h"
 #import "SPRectangle.h"
 #import "SPStage_Internal.h"
 #import "SPTouchEvent.h"
 #import "SPVector3D.h"
 
+// --- static members ------------------------------------------------------------------------------
+
+// Changes are stamped with the value of a global clock. The clock only advances when somebody has
+// taken a snapshot of it since the last change, so several changes between two frames share the
+// same stamp and propagation to the ancestors can stop early.
+//
+// The clocks are not synchronized, so they may only be used on the thread that owns the display
+// list. Objects that are modified on other threads (like the quad batches of a parallel render,
+// see SPDisplayObjectContainer) disable 'stampsChanges' and never touch them.
+static uint contentStampClock = 1;
+static BOOL contentStampObserved = NO;
+
+// Changes of the transformation (or of the parent) of an object are stamped the same way. A cached
+// world matrix stays valid as long as no stamp along the parent chain is newer than the stamp it
+// was computed with. If the clock hasn't advanced since a matrix was last validated, nothing has
+// been transformed at all, and the parent chain doesn't need to be checked.
+static uint transformStampClock = 1;
+static BOOL transformStampObserved = NO;
+
 // --- class implementation ------------------------------------------------------------------------
 
 @implementation SPDisplayObject
@@ -53,45 +75,201 @@
     
     SPDisplayObject *_mask;
     BOOL _isMask;
+
+    SPDirtyFlags _dirtyFlags;
+    uint _contentStamp;
+    BOOL _stampsChanges;
+    BOOL _tracksChildChanges;
+
+    uint _transformStamp;
+    uint _worldMatrixStamp;
+    uint _worldMatrixCheckStamp;
+    BOOL _worldMatrixValid;
+    BOOL _worldMatrixInverseValid;
+    SPMatrixValue _worldMatrix;
+    SPMatrixValue _worldMatrixInverse;
+    uint _worldMatrix3DStamp;
+    uint _worldMatrix3DCheckStamp;
+    BOOL _worldMatrix3DInverseValid;
+    SPMatrix3D *_worldMatrix3D;
+    SPMatrix3D *_worldMatrix3DInverse;
+    SPDisplayObject *__unsafe_unretained _worldBase;
 }
 
 // --- helpers -------------------------------------------------------------------------------------
 
-SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *object2)
+static void stampTransform(SPDisplayObject *object)
 {
-    // This method is used very often during touch testing, so we optimized the code.
-    // Instead of using an NSSet or NSArray (which would make the code much cleaner), we
-    // use a C array here to save the ancestors.
-    
-    static SPDisplayObject *ancestors[SP_MAX_DISPLAY_TREE_DEPTH];
-    
-    int count = 0;
-    SPDisplayObject *commonParent = nil;
-    SPDisplayObject *currentObject = object1;
-    while (currentObject && count < SP_MAX_DISPLAY_TREE_DEPTH)
+    if (transformStampObserved)
     {
-        ancestors[count++] = currentObject;
-        currentObject = currentObject->_parent;
+        ++transformStampClock;
+        transformStampObserved = NO;
     }
-    
-    currentObject = object2;
-    while (currentObject && !commonParent)
+
+    object->_transformStamp = transformStampClock;
+}
+
+static SPDisplayObject *baseOf(SPDisplayObject *object)
+{
+    while (object->_parent) object = object->_parent;
+    return object;
+}
+
+static uint updateWorldMatrix(SPDisplayObject *object)
+{
+    // returns the newest transformation stamp of the object and its ancestors. Validating the
+    // cache walks up the parent chain, but neither allocates nor multiplies any matrices.
+
+    if (object->_worldMatrixValid && object->_worldMatrixCheckStamp == transformStampClock)
+        return object->_worldMatrixStamp;
+
+    SPDisplayObject *parent = object->_parent;
+    uint stamp = object->_transformStamp;
+    if (parent) stamp = MAX(stamp, updateWorldMatrix(parent));
+
+    // re-parenting stamps the transformation, too; so the base is up to date as long as the cache
+    object->_worldBase = parent ? parent->_worldBase : object;
+
+    if (!object->_worldMatrixValid || stamp != object->_worldMatrixStamp)
+    {
+        SPMatrixValue localMatrix = object.transformationMatrix.matrixValue;
+        object->_worldMatrix = parent ? SPMatrixValueAppend(localMatrix, parent->_worldMatrix) : localMatrix;
+        object->_worldMatrixStamp = stamp;
+        object->_worldMatrixValid = YES;
+        object->_worldMatrixInverseValid = NO;
+    }
+
+    object->_worldMatrixCheckStamp = transformStampClock;
+    transformStampObserved = YES;
+
+    return stamp;
+}
+
+static SPMatrixValue worldMatrixInverse(SPDisplayObject *object)
+{
+    updateWorldMatrix(object);
+
+    if (!object->_worldMatrixInverseValid)
+    {
+        object->_worldMatrixInverse = SPMatrixValueInvert(object->_worldMatrix);
+        object->_worldMatrixInverseValid = YES;
+    }
+
+    return object->_worldMatrixInverse;
+}
+
+static SPMatrixValue transformationToSpace(SPDisplayObject *object, SPDisplayObject *targetSpace)
+{
+    // targetSpace 'nil' represents the target coordinate of the base object.
+
+    if (targetSpace == object)
+        return SPMatrixValueIdentity();
+
+    updateWorldMatrix(object);
+    if (targetSpace) updateWorldMatrix(targetSpace);
+
+    if (targetSpace && object->_worldBase != targetSpace->_worldBase)
+        [NSException raise:SPExceptionNotRelated format:@"Object not connected to target"];
+
+    if (!targetSpace) return object->_worldMatrix;
+    else return SPMatrixValueAppend(object->_worldMatrix, worldMatrixInverse(targetSpace));
+}
+
+static uint updateWorldMatrix3D(SPDisplayObject *object)
+{
+    if (object->_worldMatrix3D && object->_worldMatrix3DCheckStamp == transformStampClock)
+        return object->_worldMatrix3DStamp;
+
+    SPDisplayObject *parent = object->_parent;
+    uint stamp = object->_transformStamp;
+    if (parent) stamp = MAX(stamp, updateWorldMatrix3D(parent));
+
+    object->_worldBase = parent ? parent->_worldBase : object;
+
+    if (!object->_worldMatrix3D || stamp != object->_worldMatrix3DStamp)
     {
-        for (int i=0; i<count; ++i)
+        if (!object->_worldMatrix3D) object->_worldMatrix3D = [[SPMatrix3D alloc] init];
+
+        [object->_worldMatrix3D copyFromMatrix:object.transformationMatrix3D];
+        if (parent) [object->_worldMatrix3D appendMatrix:parent->_worldMatrix3D];
+
+        object->_worldMatrix3DStamp = stamp;
+        object->_worldMatrix3DInverseValid = NO;
+    }
+
+    object->_worldMatrix3DCheckStamp = transformStampClock;
+    transformStampObserved = YES;
+
+    return stamp;
+}
+
+static SPMatrix3D *worldMatrix3DInverse(SPDisplayObject *object)
+{
+    updateWorldMatrix3D(object);
+
+    if (!object->_worldMatrix3DInverseValid)
+    {
+        if (!object->_worldMatrix3DInverse) object->_worldMatrix3DInverse = [[SPMatrix3D alloc] init];
+
+        [object->_worldMatrix3DInverse copyFromMatrix:object->_worldMatrix3D];
+        [object->_worldMatrix3DInverse invert];
+        object->_worldMatrix3DInverseValid = YES;
+    }
+
+    return object->_worldMatrix3DInverse;
+}
+
+static void markDirty(SPDisplayObject *object, SPDirtyFlags flags)
+{
+    object->_dirtyFlags |= flags;
+
+    if (!object->_stampsChanges)
+    {
+        // without a new stamp, the cached world matrices have to be dropped explicitly
+        if (flags & SPDirtyFlagTransform)
         {
-            if (currentObject == ancestors[i])
-            {
-                commonParent = ancestors[i];
-                break;
-            }
+            object->_worldMatrixValid = NO;
+            object->_worldMatrix3DStamp = object->_worldMatrix3DCheckStamp = 0;
         }
-        currentObject = currentObject->_parent;
+        return;
+    }
+
+    if (flags & SPDirtyFlagTransform)
+        stampTransform(object);
+
+    if (contentStampObserved)
+    {
+        ++contentStampClock;
+        contentStampObserved = NO;
+    }
+
+    // a change of the object's own contents invalidates its own cache; all other changes are
+    // only visible to the caches of its ancestors. Every ancestor of an object that carries the
+    // current stamp carries it as well, so we can stop at the first one that does.
+
+    SPDisplayObject *currentObject = flags & (SPDirtyFlagChildren | SPDirtyFlagTexture | SPDirtyFlagVertices | SPDirtyFlagEffects) ?
+                                     object : object->_parent;
+
+    // containers that track their children are told about every child whose bounds might have
+    // changed. When propagation stops early, the ancestors further up have already been told
+    // since the clock was last observed -- and tracking containers observe it whenever they
+    // consume their notifications.
+
+    if (currentObject != object && currentObject && currentObject->_tracksChildChanges)
+        [currentObject childDidChange:object];
+
+    while (currentObject && currentObject->_contentStamp != contentStampClock)
+    {
+        SPDisplayObject *parent = currentObject->_parent;
+
+        if (currentObject != object) currentObject->_dirtyFlags |= SPDirtyFlagChildren;
+        currentObject->_contentStamp = contentStampClock;
+
+        if (parent && parent->_tracksChildChanges)
+            [parent childDidChange:currentObject];
+
+        currentObject = parent;
     }
-    
-    if (!commonParent)
-        [NSException raise:SPExceptionNotRelated format:@"Object not connected to target"];
-    
-    return commonParent;
 }
 
 #pragma mark Initialization
@@ -114,9 +292,11 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
         _scaleY = 1.0f;
         _visible = YES;
         _touchable = YES;
+        _stampsChanges = YES;
         _transformationMatrix = [[SPMatrix alloc] init];
         _orientationChanged = NO;
         _blendMode = SPBlendModeAuto;
+        _dirtyFlags = SPDirtyFlagAll;
     }
     return self;
 }
@@ -127,6 +307,8 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     [_filter release];
     [_physicsBody release];
     [_transformationMatrix release];
+    [_worldMatrix3D release];
+    [_worldMatrix3DInverse release];
     [_mask release];
     [super dealloc];
 }
@@ -138,6 +320,11 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     // override in subclass
 }
 
+- (void)setNeedsDisplay
+{
+    markDirty(self, SPDirtyFlagVertices);
+}
+
 - (void)removeFromParent
 {
     [_parent removeChild:self];
@@ -152,6 +339,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
 {
     SPRectangle* bounds = [self boundsInSpace:self];
     _orientationChanged = YES;
+    markDirty(self, SPDirtyFlagTransform);
 
     switch (hAlign)
     {
@@ -184,52 +372,17 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         return [[self.transformationMatrix copy] autorelease];
     }
-    else if (!targetSpace || targetSpace == self.base)
-    {
-        // targetSpace 'nil' represents the target coordinate of the base object.
-        // -> move up from self to base
-        SPMatrix *selfMatrix = [SPMatrix matrixWithIdentity];
-        SPDisplayObject *currentObject = self;
-        while (currentObject != targetSpace)
-        {
-            [selfMatrix appendMatrix:currentObject.transformationMatrix];
-            currentObject = currentObject->_parent;
-        }        
-        return selfMatrix; 
-    }
-    else if (targetSpace->_parent == self)
+    else if (targetSpace && targetSpace->_parent == self)
     {
         SPMatrix *targetMatrix = [[targetSpace.transformationMatrix copy] autorelease];
         [targetMatrix invert];
         return targetMatrix;
     }
-    
-    // 1.: Find a common parent of self and the target coordinate space.
-    SPDisplayObject *commonParent = findCommonParent(self, targetSpace);
-    
-    // 2.: Move up from self to common parent
-    SPMatrix *selfMatrix = [SPMatrix matrixWithIdentity];
-    SPDisplayObject *currentObject = self;
-    while (currentObject != commonParent)
-    {
-        [selfMatrix appendMatrix:currentObject.transformationMatrix];
-        currentObject = currentObject->_parent;
-    }
-    
-    // 3.: Now move up from target until we reach the common parent
-    SPMatrix *targetMatrix = [SPMatrix matrixWithIdentity];
-    currentObject = targetSpace;
-    while (currentObject && currentObject != commonParent)
-    {
-        [targetMatrix appendMatrix:currentObject.transformationMatrix];
-        currentObject = currentObject->_parent;
-    }    
-    
-    // 4.: Combine the two matrices
-    [targetMatrix invert];
-    [selfMatrix appendMatrix:targetMatrix];
-    
-    return selfMatrix;
+
+    // everything else is derived from the cached world matrices, which are only updated when a
+    // transformation along the parent chains has changed.
+
+    return [SPMatrix matrixWithValue:transformationToSpace(self, targetSpace)];
 }
 
 - (SPMatrix3D *)transformationMatrix3DToSpace:(nullable SPDisplayObject *)targetSpace
@@ -242,51 +395,22 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         return [[self.transformationMatrix3D copy] autorelease];
     }
-    else if (!targetSpace || targetSpace == self.base)
-    {
-        // targetSpace 'nil' represents the target coordinate of the base object.
-        // -> move up from self to base
-        SPMatrix3D *selfMatrix = [SPMatrix3D matrix3DWithIdentity];
-        SPDisplayObject *currentObject = self;
-        while (currentObject != targetSpace)
-        {
-            [selfMatrix appendMatrix:currentObject.transformationMatrix3D];
-            currentObject = currentObject->_parent;
-        }
-        return selfMatrix;
-    }
-    else if (targetSpace->_parent == self)
+    else if (targetSpace && targetSpace->_parent == self)
     {
         SPMatrix3D *targetMatrix = [[targetSpace.transformationMatrix3D copy] autorelease];
         [targetMatrix invert];
         return targetMatrix;
     }
-    
-    // 1.: Find a common parent of self and the target coordinate space.
-    SPDisplayObject *commonParent = findCommonParent(self, targetSpace);
-    
-    // 2.: Move up from self to common parent
-    SPMatrix3D *selfMatrix = [SPMatrix3D matrix3DWithIdentity];
-    SPDisplayObject *currentObject = self;
-    while (currentObject != commonParent)
-    {
-        [selfMatrix appendMatrix:currentObject.transformationMatrix3D];
-        currentObject = currentObject->_parent;
-    }
-    
-    // 3.: Now move up from target until we reach the common parent
-    SPMatrix3D *targetMatrix = [SPMatrix3D matrix3DWithIdentity];
-    currentObject = targetSpace;
-    while (currentObject && currentObject != commonParent)
-    {
-        [targetMatrix appendMatrix:currentObject.transformationMatrix3D];
-        currentObject = currentObject->_parent;
-    }
-    
-    // 4.: Combine the two matrices
-    [targetMatrix invert];
-    [selfMatrix appendMatrix:targetMatrix];
-    
+
+    updateWorldMatrix3D(self);
+    if (targetSpace) updateWorldMatrix3D(targetSpace);
+
+    if (targetSpace && _worldBase != targetSpace->_worldBase)
+        [NSException raise:SPExceptionNotRelated format:@"Object not connected to target"];
+
+    SPMatrix3D *selfMatrix = [[_worldMatrix3D copy] autorelease];
+    if (targetSpace) [selfMatrix appendMatrix:worldMatrix3DInverse(targetSpace)];
+
     return selfMatrix;
 }
 
@@ -346,8 +470,8 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     }
     else
     {
-        SPMatrix *matrix = [self transformationMatrixToSpace:self.base];
-        return [matrix transformPoint:localPoint];
+        SPMatrixValue matrix = transformationToSpace(self, baseOf(self));
+        return [SPPoint pointWithValue:SPMatrixValueTransformPoint(matrix, localPoint.x, localPoint.y)];
     }
 }
 
@@ -360,10 +484,8 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     }
     else
     {
-        
-        SPMatrix *matrix = [self transformationMatrixToSpace:self.base];
-        [matrix invert];
-        return [matrix transformPoint:globalPoint];
+        SPMatrixValue matrix = transformationToSpace(baseOf(self), self);
+        return [SPPoint pointWithValue:SPMatrixValueTransformPoint(matrix, globalPoint.x, globalPoint.y)];
     }
 }
 
@@ -500,6 +622,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _x = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -509,6 +632,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _y = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -526,6 +650,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _scaleX = _scaleY = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -535,6 +660,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _scaleX = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -544,6 +670,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _scaleY = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -553,6 +680,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _skewX = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -562,6 +690,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _skewY = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -571,6 +700,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _pivotX = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -580,6 +710,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     {
         _pivotY = value;
         _orientationChanged = YES;
+        markDirty(self, SPDirtyFlagTransform);
     }
 }
 
@@ -621,11 +752,45 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
     
     _rotation = value;
     _orientationChanged = YES;
+    markDirty(self, SPDirtyFlagTransform);
 }
 
 - (void)setAlpha:(float)value
 {
-    _alpha = SP_CLAMP(value, 0.0f, 1.0f);
+    value = SP_CLAMP(value, 0.0f, 1.0f);
+
+    if (value != _alpha)
+    {
+        _alpha = value;
+        markDirty(self, SPDirtyFlagAlpha);
+    }
+}
+
+- (void)setVisible:(BOOL)value
+{
+    if (value != _visible)
+    {
+        _visible = value;
+        markDirty(self, SPDirtyFlagVisibility);
+    }
+}
+
+- (void)setBlendMode:(uint)value
+{
+    if (value != _blendMode)
+    {
+        _blendMode = value;
+        markDirty(self, SPDirtyFlagEffects);
+    }
+}
+
+- (void)setFilter:(SPFragmentFilter *)value
+{
+    if (value != _filter)
+    {
+        SP_RELEASE_AND_RETAIN(_filter, value);
+        markDirty(self, SPDirtyFlagEffects);
+    }
 }
 
 - (SPRectangle *)bounds
@@ -723,6 +888,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
 
     _orientationChanged = NO;
     [_transformationMatrix copyFromMatrix:matrix];
+    markDirty(self, SPDirtyFlagTransform);
     
     _pivotX = 0.0f;
     _pivotY = 0.0f;
@@ -759,6 +925,7 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
         if (value) value->_isMask = YES;
         
         SP_RELEASE_AND_RETAIN(_mask, value);
+        markDirty(self, SPDirtyFlagEffects);
     }
 }
 
@@ -783,12 +950,75 @@ SPDisplayObject *findCommonParent(SPDisplayObject *object1, SPDisplayObject *obj
         [NSException raise:SPExceptionInvalidOperation 
                     format:@"An object cannot be added as a child to itself or one of its children"];
     else
+    {
         _parent = parent; // only assigned, not retained (to avoid a circular reference).
+        stampTransform(self);
+    }
 }
 
 - (void)setIs3D:(BOOL)is3D
 {
     _is3D = is3D;
+    stampTransform(self); // the matrices of 3D objects depend on their surroundings
+}
+
+- (void)markDirty:(SPDirtyFlags)flags
+{
+    markDirty(self, flags);
+}
+
+- (void)clearDirtyFlags
+{
+    _dirtyFlags = SPDirtyFlagNone;
+}
+
+- (uint)snapshotContentStamp
+{
+    contentStampObserved = YES;
+    return _contentStamp;
+}
+
+- (BOOL)stampsChanges
+{
+    return _stampsChanges;
+}
+
+- (void)setStampsChanges:(BOOL)stampsChanges
+{
+    _stampsChanges = stampsChanges;
+}
+
+- (BOOL)tracksChildChanges
+{
+    return _tracksChildChanges;
+}
+
+- (void)setTracksChildChanges:(BOOL)tracksChildChanges
+{
+    _tracksChildChanges = tracksChildChanges;
+}
+
+- (void)childDidChange:(SPDisplayObject *)child
+{
+    // override in subclass
+}
+
+- (void)applyPendingUpdates
+{
+    // override in subclass
+}
+
+- (BOOL)isRenderCacheable
+{
+    // only what 'SPQuadBatch' can compile may be cached; filters and masks need their own passes.
+    return !_filter && !_mask && ([self isKindOfClass:[SPQuad class]] ||
+                                  [self isKindOfClass:[SPQuadBatch class]] ||
+                                  [self isKindOfClass:[SPDisplayObjectContainer class]]);
+}
+
+- (SPRectValue)boundsValueInParent
+{
+    return [self boundsInSpace:_parent].rectValue;
 }
 
 @end
@@ -59,6 +59,50 @@ NS_ASSUME_NONNULL_BEGIN
 	    else return NSOrderedSame;
 	}];
  
+ **Render cache**
+ 
+ Enable `cachesRendering` on containers with mostly static content (e.g. a user interface). The
+ container then compiles its children into a few quad batches and keeps drawing those, until one
+ of its descendants changes. As long as nothing changes, no vertex data is copied and nothing is
+ uploaded to the GPU. In contrast to `[SPSprite flatten]`, changes are picked up automatically.
+ 
+ The cache is bypassed if the container has descendants with filters, masks or clip rects, or
+ descendants that cannot be compiled into quad batches (like `SPSprite3D` or `SPCanvas`).
+ 
+ **Parallel rendering**
+ 
+ Containers with many children whose content changes every frame (e.g. particles or the units of
+ a strategy game) can enable `rendersInParallel`. The children are then split into one range per
+ CPU core, and each range is collected on a worker thread: the transformed vertices are written
+ into quad batches owned by that range. Afterwards, the main thread only submits those batches to
+ OpenGL. Each range needs at least one draw call of its own. If none of the children changed,
+ the batches of the previous frame are drawn once again.
+ 
+ The requirements are the same as for the render cache; if they are not met, the container
+ silently falls back to the normal rendering. While collecting, the display list must not be
+ modified from another thread. Note that the children are neither culled (see `cullsChildren`)
+ nor tested for occlusion (see `[SPRenderSupport cullsOccludedObjects]`) while they are rendered in
+ parallel.
+ 
+ **Bounds**
+ 
+ The bounds of a container in its own coordinate system are cached until one of its descendants
+ changes. Queries in a space that is only translated or scaled relative to the container are
+ answered from that cache; in rotated or skewed spaces, the children are measured one by one.
+ 
+ **Spatial index**
+ 
+ Hit testing a container normally means transforming the touch position into the coordinate
+ system of each child, one after the other. With `usesSpatialIndex` enabled, the container sorts
+ its children into a uniform grid, based on their bounds. A hit test then only looks at the
+ children that share a grid cell with the touch position (still from front to back).
+ 
+ The grid follows moving children automatically; only those children that changed are moved to
+ their new cells. Adding, removing or reordering children rebuilds the grid with the next hit test,
+ so it's best suited for containers whose children move a lot, but are rarely added or removed.
+ Since the grid relies on the bounds of the children, subclasses that can be hit outside of their
+ bounds must not be added to such a container.
+ 
 ------------------------------------------------------------------------------------------------- */
 
 @interface SPDisplayObjectContainer : SPDisplayObject <NSFastEnumeration>
@@ -131,6 +175,26 @@ NS_ASSUME_NONNULL_BEGIN
 /// 'mouseChildren' in Flash, but with inverted logic). Default: `NO`
 @property (nonatomic, assign) BOOL touchGroup;
 
+/// Indicates if the container draws its children from a render cache that is only rebuilt when
+/// one of them changes. Default: `NO`
+@property (nonatomic, assign) BOOL cachesRendering;
+
+/// Indicates if children that lie completely outside the visible area (the stage or the current
+/// clip rect) are skipped when rendering, including all their descendants. Children with filters
+/// are never culled, since the filter might extend beyond their bounds. The test uses the bounds
+/// of each child, so it is only worth it when a large part of the children is usually off screen
+/// (e.g. in a scrolling world). Default: `NO`
+@property (nonatomic, assign) BOOL cullsChildren;
+
+/// Indicates if the container collects its children on several threads before drawing them.
+/// This pays off only for containers with hundreds of children. Disables culling and occlusion
+/// tests for those children. Default: `NO`
+@property (nonatomic, assign) BOOL rendersInParallel;
+
+/// Indicates if the container sorts its children into a grid to speed up hit tests. Useful for
+/// containers with thousands of children, like the tiles and units of a map. Default: `NO`
+@property (nonatomic, assign) BOOL usesSpatialIndex;
+
 @end
 
 NS_ASSUME_NONNULL_END
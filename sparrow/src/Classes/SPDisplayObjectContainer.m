@@ -17,13 +17,31 @@
 #import "SPMacros.h"
 #import "SPMatrix.h"
 #import "SPPoint.h"
+#import "SPQuadBatch.h"
+#import "SPQuadBatch_Internal.h"
 #import "SPRectangle.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
+#import "SPSpatialIndex.h"
 
 #import <objc/runtime.h>
 
+// --- private constants ---------------------------------------------------------------------------
+
+// Below that, dispatching the work costs more than it saves.
+#define MIN_CHILDREN_PER_THREAD 64
+
 // --- C functions ---------------------------------------------------------------------------------
 
+SP_INLINE NSInteger previousChildIndex(NSIndexSet *candidates, NSInteger index)
+{
+    // without a spatial index, all children are candidates
+    if (!candidates) return index - 1;
+
+    NSUInteger previousIndex = [candidates indexLessThanIndex:index];
+    return previousIndex == NSNotFound ? -1 : (NSInteger)previousIndex;
+}
+
 static void getDescendantEventListeners(SPDisplayObject *object, NSString *eventType,
                                         NSMutableArray<SPDisplayObject*> *listeners)
 {
@@ -44,6 +62,20 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
 {
     NSMutableArray<SPDisplayObject*> *_children;
     BOOL _touchGroup;
+    BOOL _cachesRendering;
+    BOOL _renderCacheValid;
+    uint _renderCacheStamp;
+    NSMutableArray<SPQuadBatch*> *_renderCache;
+    BOOL _rendersInParallel;
+    BOOL _cullsChildren;
+    NSMutableArray<NSMutableArray<SPQuadBatch*>*> *_collectArenas;
+    NSInteger _numCollectedRanges;
+    BOOL _collectFailed;
+    uint _collectStamp;
+    SPRectValue _boundsCache;
+    uint _boundsCacheStamp;
+    BOOL _boundsCacheValid;
+    SPSpatialIndex *_spatialIndex;
 }
 
 #pragma mark Initialization
@@ -71,6 +103,9 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
     // 'self' is becoming invalid; thus, we have to remove any references to it.
     [_children makeObjectsPerformSelector:@selector(setParent:) withObject:nil];
     [_children release];
+    [_renderCache release];
+    [_collectArenas release];
+    [_spatialIndex release];
     [super dealloc];
 }
 
@@ -95,6 +130,8 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
             [child removeFromParent];
             [_children insertObject:child atIndex:MIN(_children.count, index)];
             child.parent = self;
+            [self markDirty:SPDirtyFlagChildren];
+            [_spatialIndex invalidate];
             
             [child dispatchEventWithType:SPEventTypeAdded];
             
@@ -151,6 +188,8 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
         [_children removeObjectAtIndex:oldIndex];
         [_children insertObject:child atIndex:MIN(_children.count, index)];
         [child release];
+        [self markDirty:SPDirtyFlagChildren];
+        [_spatialIndex invalidate];
     }
 }
 
@@ -174,6 +213,8 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
         child.parent = nil; 
         NSUInteger newIndex = [_children indexOfObject:child]; // index might have changed in event handler
         if (newIndex != NSNotFound) [_children removeObjectAtIndex:newIndex];
+        [self markDirty:SPDirtyFlagChildren];
+        [_spatialIndex invalidate];
     }
     else [NSException raise:SPExceptionIndexOutOfBounds format:@"Invalid child index"];        
 }
@@ -192,12 +233,18 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
         [NSException raise:SPExceptionInvalidOperation format:@"invalid child indices"];
     
     [_children exchangeObjectAtIndex:index1 withObjectAtIndex:index2];
+    [self markDirty:SPDirtyFlagChildren];
+    [_spatialIndex invalidate];
 }
 
 - (void)sortChildren:(NSComparator)comparator
 {
     if ([_children respondsToSelector:@selector(sortWithOptions:usingComparator:)])
+    {
         [_children sortWithOptions:NSSortStable usingComparator:comparator];
+        [self markDirty:SPDirtyFlagChildren];
+        [_spatialIndex invalidate];
+    }
     else
         [NSException raise:SPExceptionInvalidOperation 
                     format:@"sortChildren is only available in iOS 4 and above"];
@@ -247,10 +294,15 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
     SPDisplayObjectContainer *container = [super copy];
     
     container->_touchGroup = _touchGroup;
+    container->_cachesRendering = _cachesRendering;
+    container->_rendersInParallel = _rendersInParallel;
+    container->_cullsChildren = _cullsChildren;
     [container->_children release];
     
+    // changes of the copied children must invalidate the caches of the copy, not of the original
     container->_children = [[NSMutableArray alloc] initWithArray:_children copyItems:YES];
-    [container->_children makeObjectsPerformSelector:@selector(setParent:) withObject:self];
+    [container->_children makeObjectsPerformSelector:@selector(setParent:) withObject:container];
+    container.usesSpatialIndex = self.usesSpatialIndex;
     
     return container;
 }
@@ -259,6 +311,12 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
 
 - (void)render:(SPRenderSupport *)support
 {
+    if (_cachesRendering && [self renderCacheWithSupport:support])
+        return;
+
+    if (_rendersInParallel && [self renderInParallelWithSupport:support])
+        return;
+
     for (SPDisplayObject *child in _children)
     {
         if (child.hasVisibleArea)
@@ -266,6 +324,15 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
             SPDisplayObject *mask = child.mask;
             SPFragmentFilter *filter = child.filter;
             
+            if (_cullsChildren && !filter && ![support isRectValueVisible:[child boundsValueInParent]])
+            {
+                [support addCulledObjects:1];
+                continue;
+            }
+
+            if ([support isObjectOccluded:child])
+                continue;
+            
             [support pushStateWithMatrix:child.transformationMatrix
                                    alpha:child.alpha
                                blendMode:child.blendMode];
@@ -289,11 +356,23 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
     if (numChildren == 0)
     {
         SPMatrix *transformationMatrix = [self transformationMatrixToSpace:targetSpace];
-        SPPoint *transformedPoint = [transformationMatrix transformPointWithX:self.x y:self.y];
+        SPPointValue transformedPoint = SPMatrixValueTransformPoint(transformationMatrix.matrixValue,
+                                                                    self.x, self.y);
         return [SPRectangle rectangleWithX:transformedPoint.x y:transformedPoint.y
                                      width:0.0f height:0.0f];
     }
-    else if (numChildren == 1)
+    
+    // the bounds in our own coordinate system change only if one of our descendants changes; thus,
+    // they are cached. Axis-aligned transformations map them exactly to the target space, too.
+
+    if (targetSpace == self)
+        return [SPRectangle rectangleWithValue:[self localBounds]];
+
+    SPMatrixValue transformationMatrix = [self transformationMatrixToSpace:targetSpace].matrixValue;
+    if (transformationMatrix.b == 0.0f && transformationMatrix.c == 0.0f)
+        return [SPRectangle rectangleWithValue:SPMatrixValueTransformRect(transformationMatrix, [self localBounds])];
+
+    if (numChildren == 1)
     {
         return [_children[0] boundsInSpace:targetSpace];
     }
@@ -312,16 +391,33 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
     }
 }
 
+- (SPRectValue)boundsValueInParent
+{
+    // the cached local bounds just need to be transformed; for rotated containers, that's an
+    // upper limit of the exact bounds.
+
+    if (_children.count == 0 || self.is3D) return [super boundsValueInParent];
+    else return SPMatrixValueTransformRect(self.transformationMatrix.matrixValue, [self localBounds]);
+}
+
 - (SPDisplayObject *)hitTestPoint:(SPPoint *)localPoint forTouch:(BOOL)forTouch
 {
     if (forTouch && (!self.visible || !self.touchable))
         return nil;
 
-    for (NSInteger i=_children.count-1; i>=0; --i) // front to back!
+    // all children are tested with the same point object; only its coordinates change.
+    SPPoint *transformedPoint = [SPPoint point];
+    SPPointValue point = localPoint.pointValue;
+
+    // the spatial index (if any) narrows the search down to the children close to the point.
+    NSIndexSet *candidates = [_spatialIndex childIndicesAtX:point.x y:point.y];
+
+    for (NSInteger i=previousChildIndex(candidates, _children.count); i>=0;
+         i=previousChildIndex(candidates, i)) // front to back!
     {
         SPDisplayObject *child = _children[i];
-        SPMatrix *transformationMatrix = [self transformationMatrixToSpace:child];
-        SPPoint  *transformedPoint = [transformationMatrix transformPoint:localPoint];
+        SPMatrixValue transformationMatrix = SPMatrixValueInvert(child.transformationMatrix.matrixValue);
+        transformedPoint.pointValue = SPMatrixValueTransformPoint(transformationMatrix, point.x, point.y);
         SPDisplayObject *target = [child hitTestPoint:transformedPoint forTouch:forTouch];
 
         if (target)
@@ -356,6 +452,173 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
     [event release];
 }
 
+#pragma mark Render Cache
+
+- (BOOL)renderCacheWithSupport:(SPRenderSupport *)support
+{
+    if (!_renderCacheValid || [self snapshotContentStamp] != _renderCacheStamp)
+    {
+        // pending updates (e.g. of text fields) change the children, so we apply them first
+        // and take the stamp only afterwards.
+
+        BOOL cacheable = YES;
+        for (SPDisplayObject *child in _children)
+        {
+            [child applyPendingUpdates];
+
+            if (![child isRenderCacheable])
+            {
+                cacheable = NO;
+                break;
+            }
+        }
+
+        if (cacheable)
+        {
+            _renderCache = [[SPQuadBatch compileObject:self intoArray:[_renderCache autorelease]] retain];
+            [self clearDirtyFlags];
+        }
+        else SP_RELEASE_AND_NIL(_renderCache);
+
+        _renderCacheStamp = [self snapshotContentStamp];
+        _renderCacheValid = YES;
+    }
+
+    if (!_renderCache) return NO;
+
+    [support renderQuadBatches:_renderCache];
+    return YES;
+}
+
+#pragma mark Bounds Cache
+
+- (SPRectValue)localBounds
+{
+    if (!_boundsCacheValid || [self snapshotContentStamp] != _boundsCacheStamp)
+    {
+        // like above, the children might update themselves while being measured.
+
+        float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX;
+        for (SPDisplayObject *child in _children)
+        {
+            SPRectangle *childBounds = [child boundsInSpace:self];
+            minX = MIN(minX, childBounds.x);
+            maxX = MAX(maxX, childBounds.x + childBounds.width);
+            minY = MIN(minY, childBounds.y);
+            maxY = MAX(maxY, childBounds.y + childBounds.height);
+        }
+
+        _boundsCache = SPRectValueMake(minX, minY, maxX-minX, maxY-minY);
+        _boundsCacheStamp = [self snapshotContentStamp];
+        _boundsCacheValid = YES;
+    }
+
+    return _boundsCache;
+}
+
+#pragma mark Parallel Rendering
+
+- (BOOL)renderInParallelWithSupport:(SPRenderSupport *)support
+{
+    static NSInteger numProcessors = 0;
+    if (!numProcessors) numProcessors = [NSProcessInfo processInfo].activeProcessorCount;
+
+    // as long as nothing changed, the result of the last frame still applies
+
+    if ((_numCollectedRanges || _collectFailed) && [self snapshotContentStamp] == _collectStamp)
+    {
+        for (NSInteger i=0; i<_numCollectedRanges; ++i)
+            [support renderQuadBatches:_collectArenas[i]];
+
+        return !_collectFailed;
+    }
+
+    NSInteger numChildren = _children.count;
+    NSInteger numRanges = MIN(numProcessors, numChildren / MIN_CHILDREN_PER_THREAD);
+    _numCollectedRanges = 0;
+    _collectFailed = NO;
+
+    if (numRanges < 2) return NO;
+
+    // pending updates (e.g. of text fields) must be applied on this thread, before compiling;
+    // the stamp is taken only afterwards.
+
+    [self applyPendingUpdates];
+    _collectStamp = [self snapshotContentStamp];
+
+    if (!_collectArenas) _collectArenas = [[NSMutableArray alloc] init];
+    while (_collectArenas.count < numRanges) [_collectArenas addObject:[NSMutableArray array]];
+
+    // collect: each worker writes the vertices of its range into its own batches
+
+    NSArray<NSMutableArray<SPQuadBatch*>*> *arenas = _collectArenas;
+    NSInteger rangeLength = (numChildren + numRanges - 1) / numRanges;
+    BOOL *compiled = calloc(numRanges, sizeof(BOOL));
+
+    dispatch_apply(numRanges, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^(size_t i)
+    {
+        @autoreleasepool
+        {
+            NSInteger location = i * rangeLength;
+            NSRange range = NSMakeRange(location, MIN(rangeLength, numChildren - location));
+            compiled[i] = [SPQuadBatch compileChildrenOfContainer:self inRange:range intoArray:arenas[i]];
+        }
+    });
+
+    BOOL compiledAll = YES;
+    for (NSInteger i=0; i<numRanges; ++i) compiledAll &= compiled[i];
+    free(compiled);
+
+    if (!compiledAll)
+    {
+        _collectFailed = YES;
+        return NO;
+    }
+
+    // submit: the GL calls are issued on this thread, in the original order
+
+    for (NSInteger i=0; i<numRanges; ++i)
+        [support renderQuadBatches:arenas[i]];
+
+    _numCollectedRanges = numRanges;
+    return YES;
+}
+
+#pragma mark Properties
+
+- (void)setRendersInParallel:(BOOL)value
+{
+    _rendersInParallel = value;
+    _numCollectedRanges = 0;
+    _collectFailed = NO;
+    if (!value) SP_RELEASE_AND_NIL(_collectArenas);
+}
+
+- (void)setCachesRendering:(BOOL)value
+{
+    if (value != _cachesRendering)
+    {
+        _cachesRendering = value;
+        _renderCacheValid = NO;
+        if (!value) SP_RELEASE_AND_NIL(_renderCache);
+    }
+}
+
+- (BOOL)usesSpatialIndex
+{
+    return _spatialIndex != nil;
+}
+
+- (void)setUsesSpatialIndex:(BOOL)value
+{
+    if (value && !_spatialIndex)
+        _spatialIndex = [[SPSpatialIndex alloc] initWithContainer:self];
+    else if (!value)
+        SP_RELEASE_AND_NIL(_spatialIndex);
+
+    self.tracksChildChanges = value;
+}
+
 #pragma mark NSFastEnumeration
 
 - (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
@@ -377,4 +640,30 @@ static void getDescendantEventListeners(SPDisplayObject *object, NSString *event
     getDescendantEventListeners(object, type, listeners);
 }
 
+- (void)clearDirtyFlags
+{
+    [super clearDirtyFlags];
+    [_children makeObjectsPerformSelector:@selector(clearDirtyFlags)];
+}
+
+- (void)childDidChange:(SPDisplayObject *)child
+{
+    [_spatialIndex markChildDirty:child];
+}
+
+- (void)applyPendingUpdates
+{
+    [_children makeObjectsPerformSelector:@selector(applyPendingUpdates)];
+}
+
+- (BOOL)isRenderCacheable
+{
+    if (![super isRenderCacheable]) return NO;
+
+    for (SPDisplayObject *child in _children)
+        if (![child isRenderCacheable]) return NO;
+
+    return YES;
+}
+
 @end
@@ -10,6 +10,7 @@
 //
 
 #import "SPDisplayObject.h"
+#import "SPGeometryValues.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -18,6 +19,43 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)setParent:(nullable SPDisplayObjectContainer *)parent;
 - (void)setIs3D:(BOOL)is3D;
 
+/// Records a change. Changes that affect the object's own contents invalidate the render caches of
+/// the object and its ancestors; all others invalidate only those of its ancestors.
+- (void)markDirty:(SPDirtyFlags)flags;
+
+/// Resets the dirty flags of the object (and of its descendants).
+- (void)clearDirtyFlags;
+
+/// Returns the stamp of the latest change of the object's contents (i.e. its descendants).
+/// Any change made after this call will get a new, higher stamp.
+- (uint)snapshotContentStamp;
+
+/// Indicates if changes are stamped with the global clock and propagated to the ancestors (see
+/// `markDirty:`); otherwise, only the dirty flags are set. Objects that are not part of the display
+/// list and are modified on a worker thread must disable this. Default: YES.
+@property (nonatomic, assign) BOOL stampsChanges;
+
+/// Indicates if 'childDidChange:' is called whenever a child is transformed or the contents of a
+/// child change. Only containers that keep track of the bounds of their children enable this.
+@property (nonatomic, assign) BOOL tracksChildChanges;
+
+/// Called for each child whose bounds might have changed, as long as `tracksChildChanges` is
+/// enabled. The default implementation does nothing.
+- (void)childDidChange:(SPDisplayObject *)child;
+
+/// Applies changes that are otherwise deferred until the object is rendered (e.g. the redraw of
+/// a text field). Containers call this on the main thread before compiling their children without
+/// rendering them. The default implementation does nothing; containers forward it to their children.
+- (void)applyPendingUpdates;
+
+/// Indicates if the object can be compiled into the render cache of a container.
+- (BOOL)isRenderCacheable;
+
+/// Returns the bounds of the object in the coordinate system of its parent, without allocating a
+/// rectangle where the subclass allows it. The result may be larger than the one of
+/// `boundsInSpace:`, e.g. for rotated containers, so it's only suitable for culling.
+- (SPRectValue)boundsValueInParent;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -17,9 +17,11 @@
 #import "SPMatrix.h"
 #import "SPMatrix3D.h"
 #import "SPOpenGL.h"
+#import "SPProfiler.h"
 #import "SPQuadBatch.h"
 #import "SPRectangle.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
 #import "SPRenderTexture.h"
 #import "SPFragmentFilter.h"
 #import "SPStage.h"
@@ -302,6 +304,8 @@
                                 support:(SPRenderSupport *)support
                               intoCache:(BOOL)intoCache
 {
+    SP_PROFILE_ZONE("SPFragmentFilter.renderPasses");
+
     SPTexture *passTexture = nil;
     SPTexture *cacheTexture = nil;
     SPDisplayObject *targetSpace = object.stage;
@@ -330,7 +334,7 @@
     [self updateBuffers:boundsPot];
     [self updatePassTexturesWithWidth:boundsPot.width height:boundsPot.height scale:_resolution * scale];
     
-    [support finishQuadBatch];
+    [support finishQuadBatchWithReason:SPBatchBreakReasonFilter object:object];
     [support addDrawCalls:_numPasses];
     [support pushStateWithMatrix:[SPMatrix matrixWithIdentity] alpha:1.0f blendMode:SPBlendModeAuto];
     [support pushMatrix3D];
@@ -354,7 +358,7 @@
     [support setProjectionMatrixWithX:bounds.x y:boundsPot.bottom width:boundsPot.width height:-boundsPot.height
                            stageWidth:stage.width stageHeight:stage.height cameraPos:stage.cameraPosition];
     [object render:support];
-    [support finishQuadBatch];
+    [support finishQuadBatchWithReason:SPBatchBreakReasonFilter object:object];
     
     // prepare drawing of actual filter passes
     [support applyBlendModeForPremultipliedAlpha:_premultipliedAlpha];
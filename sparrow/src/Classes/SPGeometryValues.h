@@ -0,0 +1,187 @@
+//
+//  SPGeometryValues.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import <Sparrow/SparrowBase.h>
+
+/** ------------------------------------------------------------------------------------------------
+
+ Value types that mirror `SPPoint`, `SPRectangle` and `SPMatrix`.
+
+ The geometry classes are pooled, but every temporary object still costs a trip through the pool
+ and the autorelease pool. Code that runs for each object, vertex or touch in every frame uses
+ these structs instead; they live on the stack and all operations are inlined. The classes convert
+ from and to them via `pointWithValue:`/`pointValue` and their counterparts, and use the very same
+ functions internally, so both variants produce identical results.
+
+------------------------------------------------------------------------------------------------- */
+
+/// A two dimensional point or vector.
+typedef struct
+{
+    float x;
+    float y;
+} SPPointValue;
+
+/// A rectangle, described by its top-left corner and its size.
+typedef struct
+{
+    float x;
+    float y;
+    float width;
+    float height;
+} SPRectValue;
+
+/// An affine 2D transformation matrix with the same layout as `SPMatrix`.
+typedef struct
+{
+    float a, b, c, d;
+    float tx, ty;
+} SPMatrixValue;
+
+// --- points --------------------------------------------------------------------------------------
+
+/// Creates a point value.
+SP_INLINE SPPointValue SPPointValueMake(float x, float y)
+{
+    return (SPPointValue){ x, y };
+}
+
+// --- rectangles ----------------------------------------------------------------------------------
+
+/// Creates a rectangle value.
+SP_INLINE SPRectValue SPRectValueMake(float x, float y, float width, float height)
+{
+    return (SPRectValue){ x, y, width, height };
+}
+
+/// Indicates if a point lies within a rectangle (including its edges).
+SP_INLINE BOOL SPRectValueContainsPoint(SPRectValue rect, float x, float y)
+{
+    return x >= rect.x && y >= rect.y && x <= rect.x + rect.width && y <= rect.y + rect.height;
+}
+
+/// Indicates if a rectangle lies completely within another one (including its edges).
+SP_INLINE BOOL SPRectValueContainsRect(SPRectValue rect, SPRectValue other)
+{
+    return other.x >= rect.x && other.y >= rect.y &&
+           other.x + other.width  <= rect.x + rect.width &&
+           other.y + other.height <= rect.y + rect.height;
+}
+
+/// Indicates if two rectangles intersect; rectangles that merely touch each other don't.
+SP_INLINE BOOL SPRectValueIntersects(SPRectValue rect, SPRectValue other)
+{
+    BOOL outside =
+        (other.x <= rect.x && other.x + other.width <= rect.x) ||
+        (other.x >= rect.x + rect.width && other.x + other.width >= rect.x + rect.width) ||
+        (other.y <= rect.y && other.y + other.height <= rect.y) ||
+        (other.y >= rect.y + rect.height && other.y + other.height >= rect.y + rect.height);
+    return !outside;
+}
+
+/// Returns the area two rectangles have in common, or an empty rectangle at the origin.
+SP_INLINE SPRectValue SPRectValueIntersection(SPRectValue rect, SPRectValue other)
+{
+    float left   = MAX(rect.x, other.x);
+    float right  = MIN(rect.x + rect.width, other.x + other.width);
+    float top    = MAX(rect.y, other.y);
+    float bottom = MIN(rect.y + rect.height, other.y + other.height);
+
+    if (left > right || top > bottom) return (SPRectValue){ 0.0f, 0.0f, 0.0f, 0.0f };
+    else return (SPRectValue){ left, top, right - left, bottom - top };
+}
+
+/// Returns the smallest rectangle that contains both rectangles.
+SP_INLINE SPRectValue SPRectValueUnion(SPRectValue rect, SPRectValue other)
+{
+    float left   = MIN(rect.x, other.x);
+    float right  = MAX(rect.x + rect.width, other.x + other.width);
+    float top    = MIN(rect.y, other.y);
+    float bottom = MAX(rect.y + rect.height, other.y + other.height);
+    return (SPRectValue){ left, top, right - left, bottom - top };
+}
+
+// --- matrices ------------------------------------------------------------------------------------
+
+/// Creates a matrix value.
+SP_INLINE SPMatrixValue SPMatrixValueMake(float a, float b, float c, float d, float tx, float ty)
+{
+    return (SPMatrixValue){ a, b, c, d, tx, ty };
+}
+
+/// Returns the identity matrix.
+SP_INLINE SPMatrixValue SPMatrixValueIdentity(void)
+{
+    return (SPMatrixValue){ 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+}
+
+/// Concatenates two matrices; the result applies 'matrix' first, then 'lhs'.
+SP_INLINE SPMatrixValue SPMatrixValueAppend(SPMatrixValue matrix, SPMatrixValue lhs)
+{
+    return (SPMatrixValue){ lhs.a * matrix.a  + lhs.c * matrix.b,
+                            lhs.b * matrix.a  + lhs.d * matrix.b,
+                            lhs.a * matrix.c  + lhs.c * matrix.d,
+                            lhs.b * matrix.c  + lhs.d * matrix.d,
+                            lhs.a * matrix.tx + lhs.c * matrix.ty + lhs.tx,
+                            lhs.b * matrix.tx + lhs.d * matrix.ty + lhs.ty };
+}
+
+/// Concatenates two matrices; the result applies 'rhs' first, then 'matrix'.
+SP_INLINE SPMatrixValue SPMatrixValuePrepend(SPMatrixValue matrix, SPMatrixValue rhs)
+{
+    return (SPMatrixValue){ matrix.a * rhs.a + matrix.c * rhs.b,
+                            matrix.b * rhs.a + matrix.d * rhs.b,
+                            matrix.a * rhs.c + matrix.c * rhs.d,
+                            matrix.b * rhs.c + matrix.d * rhs.d,
+                            matrix.tx + matrix.a * rhs.tx + matrix.c * rhs.ty,
+                            matrix.ty + matrix.b * rhs.tx + matrix.d * rhs.ty };
+}
+
+/// Returns the inverse of a matrix.
+SP_INLINE SPMatrixValue SPMatrixValueInvert(SPMatrixValue m)
+{
+    float det = m.a * m.d - m.c * m.b;
+    return (SPMatrixValue){ m.d / det, -m.b / det, -m.c / det, m.a / det,
+                            (m.c * m.ty - m.d * m.tx) / det, (m.b * m.tx - m.a * m.ty) / det };
+}
+
+/// Transforms a point by a matrix.
+SP_INLINE SPPointValue SPMatrixValueTransformPoint(SPMatrixValue m, float x, float y)
+{
+    return (SPPointValue){ m.a * x + m.c * y + m.tx, m.b * x + m.d * y + m.ty };
+}
+
+/// Returns the bounds of a rectangle after transforming it by a matrix.
+SP_INLINE SPRectValue SPMatrixValueTransformRect(SPMatrixValue m, SPRectValue rect)
+{
+    float xs[2] = { rect.x, rect.x + rect.width };
+    float ys[2] = { rect.y, rect.y + rect.height };
+    float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX;
+
+    for (int i=0; i<4; ++i)
+    {
+        SPPointValue point = SPMatrixValueTransformPoint(m, xs[i & 1], ys[i >> 1]);
+        minX = MIN(minX, point.x);
+        maxX = MAX(maxX, point.x);
+        minY = MIN(minY, point.y);
+        maxY = MAX(maxY, point.y);
+    }
+
+    return (SPRectValue){ minX, minY, maxX - minX, maxY - minY };
+}
+
+/// Converts a matrix value to the 3x3 matrix expected by the vertex kernels.
+SP_INLINE GLKMatrix3 SPMatrixValueToGLKMatrix3(SPMatrixValue m)
+{
+    return GLKMatrix3Make(m.a,  m.b,  0.0f,
+                          m.c,  m.d,  0.0f,
+                          m.tx, m.ty, 1.0f);
+}
@@ -11,6 +11,7 @@
 
 #import "SparrowClass.h"
 #import "SPContext.h"
+#import "SPDisplayObject_Internal.h"
 #import "SPGLTexture.h"
 #import "SPImage.h"
 #import "SPMacros.h"
@@ -140,6 +141,7 @@
 
 - (void)vertexDataDidChange
 {
+    [super vertexDataDidChange];
     _vertexDataCacheInvalid = YES;
 }
 
@@ -168,6 +170,7 @@
         [_vertexData setPremultipliedAlpha:_texture.premultipliedAlpha updateVertices:YES];
         [_vertexDataCache setPremultipliedAlpha:_texture.premultipliedAlpha updateVertices:NO];
         [self vertexDataDidChange];
+        [self markDirty:SPDirtyFlagTexture];
     }
 }
 
@@ -131,7 +131,7 @@
             else           _indices = realloc(_indices, sizeof(ushort) * numIndices);
 
             if (numIndices > _numIndices)
-                memset(_indices + _numIndices, 0, numIndices - _numIndices);
+                memset(_indices + _numIndices, 0, sizeof(ushort) * (numIndices - _numIndices));
         }
         else
         {
@@ -13,6 +13,7 @@
 #import "SPDelayedInvocation.h"
 #import "SPEventDispatcher.h"
 #import "SPJuggler.h"
+#import "SPProfiler.h"
 #import "SPTween.h"
 
 @implementation SPJuggler
@@ -168,6 +169,8 @@
 
     if (seconds > 0.0)
     {
+        SP_PROFILE_ZONE("SPJuggler.advanceTime");
+
         _elapsedTime += seconds;
 
         // we need work with a copy, since user-code could modify the collection while enumerating
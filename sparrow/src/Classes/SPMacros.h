@@ -25,6 +25,17 @@ typedef unsigned char uchar;
 
 #define SP_FLOAT_EPSILON            0.0001f
 #define SP_MAX_DISPLAY_TREE_DEPTH   32
+#define SP_MAX_NUM_TEXTURES         8
+
+// render diagnostics (see SPRenderDiagnostics); compiled into debug builds only by default
+
+#ifndef SP_RENDER_DIAGNOSTICS
+  #if DEBUG
+    #define SP_RENDER_DIAGNOSTICS   1
+  #else
+    #define SP_RENDER_DIAGNOSTICS   0
+  #endif
+#endif
 
 // colors
 
@@ -10,6 +10,7 @@
 //
 
 #import <Sparrow/SparrowBase.h>
+#import <Sparrow/SPGeometryValues.h>
 #import <Sparrow/SPPoolObject.h>
 
 NS_ASSUME_NONNULL_BEGIN
@@ -62,6 +63,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// Factory method.
 + (instancetype)matrixWithTranslationX:(float)tx translationY:(float)ty;
 
+/// Factory method.
++ (instancetype)matrixWithValue:(SPMatrixValue)value;
+
 /// -------------
 /// @name Methods
 /// -------------
@@ -144,6 +148,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// The ty component of the matrix.
 @property (nonatomic, assign) float ty;
 
+/// The matrix as a value type.
+@property (nonatomic, assign) SPMatrixValue matrixValue;
+
 /// The determinant of the matrix.
 @property (nonatomic, readonly) float determinant;
 
@@ -30,6 +30,16 @@ static inline void setValues(SPMatrix *matrix, float a, float b, float c, float
     matrix->_ty = ty;    
 }
 
+static inline SPMatrixValue getValue(SPMatrix *matrix)
+{
+    return (SPMatrixValue){ matrix->_a, matrix->_b, matrix->_c, matrix->_d, matrix->_tx, matrix->_ty };
+}
+
+static inline void setValue(SPMatrix *matrix, SPMatrixValue value)
+{
+    setValues(matrix, value.a, value.b, value.c, value.d, value.tx, value.ty);
+}
+
 #pragma mark Initialization
 
 - (instancetype)initWithA:(float)a b:(float)b c:(float)c d:(float)d tx:(float)tx ty:(float)ty
@@ -73,6 +83,11 @@ static inline void setValues(SPMatrix *matrix, float a, float b, float c, float
     return [[[self alloc] initWithA:1 b:0 c:0 d:1 tx:tx ty:ty] autorelease];
 }
 
++ (instancetype)matrixWithValue:(SPMatrixValue)value
+{
+    return [[[self alloc] initWithA:value.a b:value.b c:value.c d:value.d tx:value.tx ty:value.ty] autorelease];
+}
+
 #pragma mark Methods
 
 - (void)setA:(float)a b:(float)b c:(float)c d:(float)d tx:(float)tx ty:(float)ty
@@ -95,22 +110,12 @@ static inline void setValues(SPMatrix *matrix, float a, float b, float c, float
 
 - (void)appendMatrix:(SPMatrix *)lhs
 {
-    setValues(self, lhs->_a * _a  + lhs->_c * _b, 
-                    lhs->_b * _a  + lhs->_d * _b, 
-                    lhs->_a * _c  + lhs->_c * _d,
-                    lhs->_b * _c  + lhs->_d * _d,
-                    lhs->_a * _tx + lhs->_c * _ty + lhs->_tx,
-                    lhs->_b * _tx + lhs->_d * _ty + lhs->_ty);
+    setValue(self, SPMatrixValueAppend(getValue(self), getValue(lhs)));
 }
 
 - (void)prependMatrix:(SPMatrix *)rhs
 {
-    setValues(self, _a * rhs->_a + _c * rhs->_b,
-                    _b * rhs->_a + _d * rhs->_b,
-                    _a * rhs->_c + _c * rhs->_d,
-                    _b * rhs->_c + _d * rhs->_d,
-                    _tx + _a * rhs->_tx + _c * rhs->_ty,
-                    _ty + _b * rhs->_tx + _d * rhs->_ty);
+    setValue(self, SPMatrixValuePrepend(getValue(self), getValue(rhs)));
 }
 
 - (void)translateXBy:(float)dx yBy:(float)dy
@@ -175,8 +180,7 @@ static inline void setValues(SPMatrix *matrix, float a, float b, float c, float
 
 - (void)invert
 {
-    float det = self.determinant;
-    setValues(self, _d/det, -_b/det, -_c/det, _a/det, (_c*_ty-_d*_tx)/det, (_b*_tx-_a*_ty)/det);
+    setValue(self, SPMatrixValueInvert(getValue(self)));
 }
 
 - (void)copyFromMatrix:(SPMatrix *)matrix
@@ -213,21 +217,17 @@ static inline void setValues(SPMatrix *matrix, float a, float b, float c, float
 
 - (GLKMatrix3)convertToGLKMatrix3
 {
-    return GLKMatrix3Make(_a,  _b,  0.0f,
-                          _c,  _d,  0.0f,
-                          _tx, _ty, 1.0f);
+    return SPMatrixValueToGLKMatrix3(getValue(self));
 }
 
 - (SPPoint *)transformPoint:(SPPoint *)point
 {
-    return [SPPoint pointWithX:_a*point.x + _c*point.y + _tx
-                             y:_b*point.x + _d*point.y + _ty];
+    return [self transformPointWithX:point.x y:point.y];
 }
 
 - (SPPoint *)transformPointWithX:(float)x y:(float)y
 {
-    return [SPPoint pointWithX:_a*x + _c*y + _tx
-                             y:_b*x + _d*y + _ty];
+    return [SPPoint pointWithValue:SPMatrixValueTransformPoint(getValue(self), x, y)];
 }
 
 #pragma mark NSObject
@@ -264,6 +264,16 @@ static inline void setValues(SPMatrix *matrix, float a, float b, float c, float
 
 #pragma mark Properties
 
+- (SPMatrixValue)matrixValue
+{
+    return getValue(self);
+}
+
+- (void)setMatrixValue:(SPMatrixValue)value
+{
+    setValue(self, value);
+}
+
 - (float)determinant
 {
     return _a * _d - _c * _b;
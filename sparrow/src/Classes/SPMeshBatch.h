@@ -0,0 +1,85 @@
+//
+//  SPMeshBatch.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import <Sparrow/SparrowBase.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class SPIndexData;
+@class SPMatrix;
+@class SPMatrix3D;
+@class SPQuad;
+@class SPQuadBatch;
+@class SPVertexData;
+
+/** ------------------------------------------------------------------------------------------------
+
+ Collects untextured, indexed triangles with an identical blend mode, so that they can be drawn
+ with a single draw call.
+
+ Other than `SPQuadBatch`, a mesh batch is not restricted to quads: any triangles described by
+ an `SPVertexData` and an `SPIndexData` instance can be added, e.g. the polygons of an `SPCanvas`.
+ Untextured quads may be added as well. SPRenderSupport uses a mesh batch to combine canvases and
+ the plain quads in between them (see `[SPRenderSupport batchVertexData:indexData:object:]`).
+
+ Colors are always stored with premultiplied alpha, so that data with and without premultiplied
+ alpha can be mixed. Since indices are 16 bit values, a batch holds up to 65536 vertices.
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPMeshBatch : NSObject
+
+/// -------------
+/// @name Methods
+/// -------------
+
+/// Removes all triangles. The allocated memory is kept, so that it can be reused.
+- (void)reset;
+
+/// Adds the triangles described by the given vertex and index data. The vertex positions are
+/// transformed by 'matrix' (if it is not nil); the vertex colors are multiplied with 'alpha'.
+/// Texture coordinates are ignored.
+- (void)addVertexData:(SPVertexData *)vertexData indexData:(SPIndexData *)indexData
+                alpha:(float)alpha blendMode:(uint)blendMode matrix:(nullable SPMatrix *)matrix;
+
+/// Adds an untextured quad, using custom alpha and blend mode values (ignoring the quad's
+/// original values) and transforming each vertex by a certain matrix.
+- (void)addQuad:(SPQuad *)quad alpha:(float)alpha blendMode:(uint)blendMode
+         matrix:(nullable SPMatrix *)matrix;
+
+/// Adds the quads of an untextured quad batch, using custom alpha and blend mode values (ignoring
+/// the batch's original values) and transforming each vertex by a certain matrix.
+- (void)addQuadBatch:(SPQuadBatch *)quadBatch alpha:(float)alpha blendMode:(uint)blendMode
+              matrix:(nullable SPMatrix *)matrix;
+
+/// Indicates if the given number of vertices with a certain blend mode can be added to the batch
+/// without causing a state change, i.e. without having to draw the batch first.
+- (BOOL)isStateChangeWithBlendMode:(uint)blendMode numVertices:(NSInteger)numVertices;
+
+/// Renders the batch with a custom 3D mvp matrix.
+- (void)renderWithMvpMatrix3D:(SPMatrix3D *)matrix;
+
+/// ----------------
+/// @name Properties
+/// ----------------
+
+/// The number of vertices that have been added to the batch.
+@property (nonatomic, readonly) NSInteger numVertices;
+
+/// The number of indices that have been added to the batch (three per triangle).
+@property (nonatomic, readonly) NSInteger numIndices;
+
+/// The blend mode of all triangles in the batch.
+@property (nonatomic, readonly) uint blendMode;
+
+@end
+
+NS_ASSUME_NONNULL_END
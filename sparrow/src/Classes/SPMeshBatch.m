@@ -0,0 +1,238 @@
+//
+//  SPMeshBatch.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPBaseEffect.h"
+#import "SPBlendMode.h"
+#import "SPContext.h"
+#import "SPContext_Internal.h"
+#import "SPIndexData.h"
+#import "SPMacros.h"
+#import "SPMatrix.h"
+#import "SPMatrix3D.h"
+#import "SPMeshBatch.h"
+#import "SPOpenGL.h"
+#import "SPProfiler.h"
+#import "SPQuad.h"
+#import "SPQuadBatch.h"
+#import "SPQuadBatch_Internal.h"
+#import "SPVertexData.h"
+
+#define MAX_NUM_VERTICES 65536
+
+// --- C functions ---------------------------------------------------------------------------------
+
+static void premultiplyColors(SPVertex *vertices, NSInteger numVertices, float alpha, BOOL pma)
+{
+    // rgb values that are already premultiplied just need to be scaled like the alpha value
+    for (NSInteger i=0; i<numVertices; ++i)
+    {
+        SPVertexColor color = vertices[i].color;
+        float factor = pma ? alpha : alpha * color.a / 255.0f;
+
+        vertices[i].color = SPVertexColorMake(color.r * factor + 0.5f, color.g * factor + 0.5f,
+                                              color.b * factor + 0.5f, color.a * alpha + 0.5f);
+    }
+}
+
+// --- class implementation ------------------------------------------------------------------------
+
+@implementation SPMeshBatch
+{
+    SPVertexData *_vertexData;
+    SPIndexData *_indexData;
+    NSInteger _numVertices;
+    NSInteger _numIndices;
+    uint _blendMode;
+
+    SPBaseEffect *_baseEffect;
+    uint _vertexBufferName;
+    uint _indexBufferName;
+}
+
+#pragma mark Initialization
+
+- (instancetype)init
+{
+    if ((self = [super init]))
+    {
+        _vertexData = [[SPVertexData alloc] initWithSize:0 premultipliedAlpha:YES];
+        _indexData = [[SPIndexData alloc] init];
+        _baseEffect = [[SPBaseEffect alloc] init];
+        _blendMode = SPBlendModeNormal;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_vertexBufferName) glDeleteBuffers(1, &_vertexBufferName);
+    if (_indexBufferName)  glDeleteBuffers(1, &_indexBufferName);
+
+    [_vertexData release];
+    [_indexData release];
+    [_baseEffect release];
+    [super dealloc];
+}
+
+#pragma mark Methods
+
+- (void)reset
+{
+    _numVertices = 0;
+    _numIndices = 0;
+}
+
+- (void)addVertexData:(SPVertexData *)vertexData indexData:(SPIndexData *)indexData
+                alpha:(float)alpha blendMode:(uint)blendMode matrix:(SPMatrix *)matrix
+{
+    NSInteger numVertices = vertexData.numVertices;
+    NSInteger numIndices = indexData.numIndices;
+    NSInteger vertexID = [self reserveNumVertices:numVertices numIndices:numIndices blendMode:blendMode];
+
+    [vertexData copyTransformedToVertexData:_vertexData atIndex:vertexID matrix:matrix
+                                  fromIndex:0 numVertices:numVertices];
+    premultiplyColors(_vertexData.vertices + vertexID, numVertices, alpha, vertexData.premultipliedAlpha);
+
+    ushort *indices = _indexData.indices + _numIndices;
+    const ushort *sourceIndices = indexData.indices;
+
+    for (NSInteger i=0; i<numIndices; ++i)
+        indices[i] = sourceIndices[i] + vertexID;
+
+    _numVertices += numVertices;
+    _numIndices += numIndices;
+}
+
+- (void)addQuad:(SPQuad *)quad alpha:(float)alpha blendMode:(uint)blendMode matrix:(SPMatrix *)matrix
+{
+    NSInteger vertexID = [self reserveNumVertices:4 numIndices:6 blendMode:blendMode];
+
+    [quad copyTransformedVertexDataTo:_vertexData atIndex:vertexID matrix:matrix];
+    premultiplyColors(_vertexData.vertices + vertexID, 4, alpha, quad.premultipliedAlpha);
+    [self addQuadIndicesForNumQuads:1];
+}
+
+- (void)addQuadBatch:(SPQuadBatch *)quadBatch alpha:(float)alpha blendMode:(uint)blendMode
+              matrix:(SPMatrix *)matrix
+{
+    NSInteger numQuads = quadBatch.numQuads;
+    NSInteger vertexID = [self reserveNumVertices:numQuads * 4 numIndices:numQuads * 6 blendMode:blendMode];
+
+    [quadBatch.vertexData copyTransformedToVertexData:_vertexData atIndex:vertexID matrix:matrix
+                                            fromIndex:0 numVertices:numQuads * 4];
+    premultiplyColors(_vertexData.vertices + vertexID, numQuads * 4, alpha, quadBatch.premultipliedAlpha);
+    [self addQuadIndicesForNumQuads:numQuads];
+}
+
+- (BOOL)isStateChangeWithBlendMode:(uint)blendMode numVertices:(NSInteger)numVertices
+{
+    if (_numVertices == 0) return NO;
+    else if (_numVertices + numVertices > MAX_NUM_VERTICES) return YES;
+    else return blendMode != _blendMode;
+}
+
+- (void)renderWithMvpMatrix3D:(SPMatrix3D *)matrix
+{
+    if (!_numIndices) return;
+
+    SP_PROFILE_ZONE("SPMeshBatch.render");
+
+    _baseEffect.texture = nil;
+    _baseEffect.numTextures = 1;
+    _baseEffect.premultipliedAlpha = YES;
+    _baseEffect.mvpMatrix3D = matrix;
+    _baseEffect.useTinting = YES;
+    _baseEffect.alpha = 1.0f;
+
+    [_baseEffect prepareToDraw];
+    [SPBlendMode applyBlendFactorsForBlendMode:_blendMode premultipliedAlpha:YES];
+
+    int attribPosition = _baseEffect.attribPosition;
+    int attribColor    = _baseEffect.attribColor;
+
+    // vertices and indices go into the context's streaming buffers, like those of dynamic quad
+    // batches; without a context, the batch's own buffers are refilled each time
+    SPContext *context = SPContext.currentContext;
+    NSInteger numBytes = sizeof(SPVertex) * _numVertices;
+    NSInteger vertexOffset = 0;
+    NSInteger indexOffset = 0;
+
+    if (context)
+    {
+        [context streamIndexData:_indexData.indices numIndices:_numIndices offset:&indexOffset];
+        [context streamVertexData:_vertexData.vertices numBytes:numBytes offset:&vertexOffset];
+    }
+    else
+    {
+        if (!_vertexBufferName) glGenBuffers(1, &_vertexBufferName);
+        if (!_indexBufferName)  glGenBuffers(1, &_indexBufferName);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexBufferName);
+        glBufferData(GL_ARRAY_BUFFER, numBytes, _vertexData.vertices, GL_STREAM_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferName);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort) * _numIndices, _indexData.indices, GL_STREAM_DRAW);
+    }
+
+    glEnableVertexAttribArray(attribPosition);
+    glVertexAttribPointer(attribPosition, 2, GL_FLOAT, GL_FALSE, sizeof(SPVertex),
+                          (char *)vertexOffset + offsetof(SPVertex, position));
+
+    if (attribColor >= 0)
+    {
+        glEnableVertexAttribArray(attribColor);
+        glVertexAttribPointer(attribColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SPVertex),
+                              (char *)vertexOffset + offsetof(SPVertex, color));
+    }
+
+    glDrawElements(GL_TRIANGLES, (int)_numIndices, GL_UNSIGNED_SHORT, (char *)indexOffset);
+}
+
+#pragma mark Private
+
+- (NSInteger)reserveNumVertices:(NSInteger)numVertices numIndices:(NSInteger)numIndices
+                      blendMode:(uint)blendMode
+{
+    if (_numVertices + numVertices > MAX_NUM_VERTICES)
+        [NSException raise:SPExceptionIndexOutOfBounds format:@"mesh batch exceeds %d vertices",
+         MAX_NUM_VERTICES];
+
+    if (_numVertices + numVertices > _vertexData.numVertices)
+        _vertexData.numVertices = SPExpandedCapacity(_vertexData.numVertices, _numVertices + numVertices);
+
+    if (_numIndices + numIndices > _indexData.numIndices)
+        _indexData.numIndices = SPExpandedCapacity(_indexData.numIndices, _numIndices + numIndices);
+
+    if (_numVertices == 0) _blendMode = blendMode;
+    return _numVertices;
+}
+
+- (void)addQuadIndicesForNumQuads:(NSInteger)numQuads
+{
+    ushort *indices = _indexData.indices + _numIndices;
+
+    for (NSInteger i=0; i<numQuads; ++i)
+    {
+        ushort vertexID = _numVertices + i * 4;
+
+        indices[i*6  ] = vertexID;
+        indices[i*6+1] = vertexID + 1;
+        indices[i*6+2] = vertexID + 2;
+        indices[i*6+3] = vertexID + 1;
+        indices[i*6+4] = vertexID + 3;
+        indices[i*6+5] = vertexID + 2;
+    }
+
+    _numVertices += numQuads * 4;
+    _numIndices += numQuads * 6;
+}
+
+@end
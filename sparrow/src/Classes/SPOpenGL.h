@@ -21,6 +21,117 @@
 
 #define SP_ENABLE_GL_STATE_CACHE 0
 
+// ------------------------------------------------------------------------------------
+// OpenGL calls can be routed through an exchangeable backend (see 'SGLBackend'), which
+// is what 'SGLRecorder' relies on. Since that adds an indirect call to each OpenGL call,
+// it is only enabled in debug builds (and thus in the unit tests) per default; release
+// builds call the native OpenGL ES functions directly. Define this as '1' to record
+// release builds, too. Sparrow and the code including this header must agree on it.
+// ------------------------------------------------------------------------------------
+
+#ifndef SP_ENABLE_GL_BACKEND
+  #if DEBUG
+    #define SP_ENABLE_GL_BACKEND 1
+  #else
+    #define SP_ENABLE_GL_BACKEND 0
+  #endif
+#endif
+
+/// A table of the OpenGL entry points used by Sparrow. Per default, all calls are forwarded to
+/// the native OpenGL ES implementation; a custom backend can be used to intercept, record or
+/// replace them (e.g. to run the rendering pipeline without a GPU).
+typedef struct SGLBackend
+{
+    void        (*activeTexture)(GLenum texture);
+    void        (*attachShader)(GLuint program, GLuint shader);
+    void        (*bindBuffer)(GLenum target, GLuint buffer);
+    void        (*bindFramebuffer)(GLenum target, GLuint framebuffer);
+    void        (*bindRenderbuffer)(GLenum target, GLuint renderbuffer);
+    void        (*bindTexture)(GLenum target, GLuint texture);
+    void        (*bindVertexArray)(GLuint array);
+    void        (*blendFunc)(GLenum sfactor, GLenum dfactor);
+    void        (*bufferData)(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+    void        (*bufferSubData)(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+    GLenum      (*checkFramebufferStatus)(GLenum target);
+    void        (*clear)(GLbitfield mask);
+    void        (*clearColor)(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+    void        (*clearDepthf)(GLclampf depth);
+    void        (*clearStencil)(GLint s);
+    void        (*compileShader)(GLuint shader);
+    void        (*compressedTexImage2D)(GLenum target, GLint level, GLenum internalformat, GLsizei width,
+                                        GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data);
+    GLuint      (*createProgram)(void);
+    GLuint      (*createShader)(GLenum type);
+    void        (*deleteBuffers)(GLsizei n, const GLuint* buffers);
+    void        (*deleteFramebuffers)(GLsizei n, const GLuint* framebuffers);
+    void        (*deleteProgram)(GLuint program);
+    void        (*deleteRenderbuffers)(GLsizei n, const GLuint* renderbuffers);
+    void        (*deleteShader)(GLuint shader);
+    void        (*deleteTextures)(GLsizei n, const GLuint* textures);
+    void        (*deleteVertexArrays)(GLsizei n, const GLuint* arrays);
+    void        (*depthFunc)(GLenum func);
+    void        (*depthMask)(GLboolean flag);
+    void        (*detachShader)(GLuint program, GLuint shader);
+    void        (*disable)(GLenum cap);
+    void        (*disableVertexAttribArray)(GLuint index);
+    void        (*discardFramebuffer)(GLenum target, GLsizei numAttachments, const GLenum* attachments);
+    void        (*drawArrays)(GLenum mode, GLint first, GLsizei count);
+    void        (*drawElements)(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
+    void        (*enable)(GLenum cap);
+    void        (*enableVertexAttribArray)(GLuint index);
+    void        (*framebufferRenderbuffer)(GLenum target, GLenum attachment, GLenum renderbuffertarget,
+                                           GLuint renderbuffer);
+    void        (*framebufferTexture2D)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture,
+                                        GLint level);
+    void        (*genBuffers)(GLsizei n, GLuint* buffers);
+    void        (*generateMipmap)(GLenum target);
+    void        (*genFramebuffers)(GLsizei n, GLuint* framebuffers);
+    void        (*genRenderbuffers)(GLsizei n, GLuint* renderbuffers);
+    void        (*genTextures)(GLsizei n, GLuint* textures);
+    void        (*genVertexArrays)(GLsizei n, GLuint* arrays);
+    void        (*getActiveAttrib)(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length,
+                                   GLint* size, GLenum* type, GLchar* name);
+    void        (*getActiveUniform)(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length,
+                                    GLint* size, GLenum* type, GLchar* name);
+    GLint       (*getAttribLocation)(GLuint program, const GLchar* name);
+    GLenum      (*getError)(void);
+    void        (*getIntegerv)(GLenum pname, GLint* params);
+    void        (*getProgramInfoLog)(GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog);
+    void        (*getProgramiv)(GLuint program, GLenum pname, GLint* params);
+    void        (*getRenderbufferParameteriv)(GLenum target, GLenum pname, GLint* params);
+    void        (*getShaderInfoLog)(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* infolog);
+    void        (*getShaderiv)(GLuint shader, GLenum pname, GLint* params);
+    const GLubyte* (*getString)(GLenum name);
+    GLint       (*getUniformLocation)(GLuint program, const GLchar* name);
+    GLboolean   (*isEnabled)(GLenum cap);
+    void        (*linkProgram)(GLuint program);
+    GLvoid*     (*mapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+    void        (*pixelStorei)(GLenum pname, GLint param);
+    void        (*readPixels)(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                              GLvoid* pixels);
+    void        (*renderbufferStorage)(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+    void        (*renderbufferStorageMultisample)(GLenum target, GLsizei samples, GLenum internalformat,
+                                                  GLsizei width, GLsizei height);
+    void        (*scissor)(GLint x, GLint y, GLsizei width, GLsizei height);
+    void        (*shaderSource)(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+    void        (*stencilFunc)(GLenum func, GLint ref, GLuint mask);
+    void        (*stencilOp)(GLenum fail, GLenum zfail, GLenum zpass);
+    void        (*texImage2D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                              GLint border, GLenum format, GLenum type, const GLvoid* pixels);
+    void        (*texParameterf)(GLenum target, GLenum pname, GLfloat param);
+    void        (*texParameteri)(GLenum target, GLenum pname, GLint param);
+    void        (*uniform1f)(GLint location, GLfloat x);
+    void        (*uniform1i)(GLint location, GLint x);
+    void        (*uniform4f)(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+    void        (*uniform4fv)(GLint location, GLsizei count, const GLfloat* v);
+    void        (*uniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    GLboolean   (*unmapBuffer)(GLenum target);
+    void        (*useProgram)(GLuint program);
+    void        (*vertexAttribPointer)(GLuint indx, GLint size, GLenum type, GLboolean normalized,
+                                       GLsizei stride, const GLvoid* ptr);
+    void        (*viewport)(GLint x, GLint y, GLsizei width, GLsizei height);
+} SGLBackend;
+
 /// Sparrow's OpenGL state cache reference type.
 typedef struct SGLStateCache *SGLStateCacheRef;
 
@@ -42,6 +153,16 @@ SP_EXTERN SGLStateCacheRef sglStateCacheGetCurrent(void);
 /// Sets the current global state cache, if NULL will use a default state cache.
 SP_EXTERN void sglStateCacheSetCurrent(SGLStateCacheRef stateCache);
 
+/// Returns the backend that forwards all calls to the native OpenGL ES implementation.
+SP_EXTERN const SGLBackend* sglBackendGetDefault(void);
+
+/// Returns the backend all OpenGL calls are currently routed through.
+SP_EXTERN const SGLBackend* sglBackendGetCurrent(void);
+
+/// Sets the backend all OpenGL calls are routed through; if NULL, will use the default backend.
+/// The backend is not copied, so it must stay valid as long as it is in use.
+SP_EXTERN void sglBackendSetCurrent(const SGLBackend* backend);
+
 /// Returns a string representing an OpenGL error code.
 SP_EXTERN const char* sglGetErrorString(uint error);
 
@@ -57,7 +178,7 @@ SP_EXTERN const char* sglGetErrorString(uint error);
 #endif
 
 /// OpenGL remappings
-#if SP_ENABLE_GL_STATE_CACHE
+#if SP_ENABLE_GL_STATE_CACHE || SP_ENABLE_GL_BACKEND
     #undef  glBindVertexArray
     #undef  glDeleteVertexArrays
 
@@ -101,3 +222,129 @@ SP_EXTERN const char* sglGetErrorString(uint error);
     SP_EXTERN void                      sglUseProgram(GLuint program);
     SP_EXTERN void                      sglViewport(GLint x, GLint y, GLsizei width, GLsizei height);
 #endif
+
+#if SP_ENABLE_GL_BACKEND
+    #undef  glGenVertexArrays
+
+    #define glAttachShader                      sglAttachShader
+    #define glBufferData                        sglBufferData
+    #define glBufferSubData                     sglBufferSubData
+    #define glCheckFramebufferStatus            sglCheckFramebufferStatus
+    #define glClear                             sglClear
+    #define glClearColor                        sglClearColor
+    #define glClearDepthf                       sglClearDepthf
+    #define glClearStencil                      sglClearStencil
+    #define glCompileShader                     sglCompileShader
+    #define glCompressedTexImage2D              sglCompressedTexImage2D
+    #define glCreateProgram                     sglCreateProgram
+    #define glCreateShader                      sglCreateShader
+    #define glDeleteShader                      sglDeleteShader
+    #define glDepthFunc                         sglDepthFunc
+    #define glDepthMask                         sglDepthMask
+    #define glDetachShader                      sglDetachShader
+    #define glDisableVertexAttribArray          sglDisableVertexAttribArray
+    #define glDiscardFramebufferEXT             sglDiscardFramebuffer
+    #define glDrawArrays                        sglDrawArrays
+    #define glDrawElements                      sglDrawElements
+    #define glEnableVertexAttribArray           sglEnableVertexAttribArray
+    #define glFramebufferRenderbuffer           sglFramebufferRenderbuffer
+    #define glFramebufferTexture2D              sglFramebufferTexture2D
+    #define glGenBuffers                        sglGenBuffers
+    #define glGenerateMipmap                    sglGenerateMipmap
+    #define glGenFramebuffers                   sglGenFramebuffers
+    #define glGenRenderbuffers                  sglGenRenderbuffers
+    #define glGenTextures                       sglGenTextures
+    #define glGenVertexArrays                   sglGenVertexArrays
+    #define glGetActiveAttrib                   sglGetActiveAttrib
+    #define glGetActiveUniform                  sglGetActiveUniform
+    #define glGetAttribLocation                 sglGetAttribLocation
+    #define glGetError                          sglGetError
+    #define glGetProgramInfoLog                 sglGetProgramInfoLog
+    #define glGetProgramiv                      sglGetProgramiv
+    #define glGetRenderbufferParameteriv        sglGetRenderbufferParameteriv
+    #define glGetShaderInfoLog                  sglGetShaderInfoLog
+    #define glGetShaderiv                       sglGetShaderiv
+    #define glGetString                         sglGetString
+    #define glGetUniformLocation                sglGetUniformLocation
+    #define glIsEnabled                         sglIsEnabled
+    #define glLinkProgram                       sglLinkProgram
+    #define glMapBufferRangeEXT                 sglMapBufferRange
+    #define glPixelStorei                       sglPixelStorei
+    #define glReadPixels                        sglReadPixels
+    #define glRenderbufferStorage               sglRenderbufferStorage
+    #define glRenderbufferStorageMultisampleAPPLE sglRenderbufferStorageMultisample
+    #define glShaderSource                      sglShaderSource
+    #define glStencilFunc                       sglStencilFunc
+    #define glStencilOp                         sglStencilOp
+    #define glTexImage2D                        sglTexImage2D
+    #define glTexParameterf                     sglTexParameterf
+    #define glTexParameteri                     sglTexParameteri
+    #define glUniform1f                         sglUniform1f
+    #define glUniform1i                         sglUniform1i
+    #define glUniform4f                         sglUniform4f
+    #define glUniform4fv                        sglUniform4fv
+    #define glUniformMatrix4fv                  sglUniformMatrix4fv
+    #define glUnmapBufferOES                    sglUnmapBuffer
+    #define glVertexAttribPointer               sglVertexAttribPointer
+
+    SP_EXTERN void                      sglAttachShader(GLuint program, GLuint shader);
+    SP_EXTERN void                      sglBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+    SP_EXTERN void                      sglBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+    SP_EXTERN GLenum                    sglCheckFramebufferStatus(GLenum target);
+    SP_EXTERN void                      sglClear(GLbitfield mask);
+    SP_EXTERN void                      sglClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+    SP_EXTERN void                      sglClearDepthf(GLclampf depth);
+    SP_EXTERN void                      sglClearStencil(GLint s);
+    SP_EXTERN void                      sglCompileShader(GLuint shader);
+    SP_EXTERN void                      sglCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data);
+    SP_EXTERN GLuint                    sglCreateProgram(void);
+    SP_EXTERN GLuint                    sglCreateShader(GLenum type);
+    SP_EXTERN void                      sglDeleteShader(GLuint shader);
+    SP_EXTERN void                      sglDepthFunc(GLenum func);
+    SP_EXTERN void                      sglDepthMask(GLboolean flag);
+    SP_EXTERN void                      sglDetachShader(GLuint program, GLuint shader);
+    SP_EXTERN void                      sglDisableVertexAttribArray(GLuint index);
+    SP_EXTERN void                      sglDiscardFramebuffer(GLenum target, GLsizei numAttachments, const GLenum* attachments);
+    SP_EXTERN void                      sglDrawArrays(GLenum mode, GLint first, GLsizei count);
+    SP_EXTERN void                      sglDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
+    SP_EXTERN void                      sglEnableVertexAttribArray(GLuint index);
+    SP_EXTERN void                      sglFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+    SP_EXTERN void                      sglFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+    SP_EXTERN void                      sglGenBuffers(GLsizei n, GLuint* buffers);
+    SP_EXTERN void                      sglGenerateMipmap(GLenum target);
+    SP_EXTERN void                      sglGenFramebuffers(GLsizei n, GLuint* framebuffers);
+    SP_EXTERN void                      sglGenRenderbuffers(GLsizei n, GLuint* renderbuffers);
+    SP_EXTERN void                      sglGenTextures(GLsizei n, GLuint* textures);
+    SP_EXTERN void                      sglGenVertexArrays(GLsizei n, GLuint* arrays);
+    SP_EXTERN void                      sglGetActiveAttrib(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+    SP_EXTERN void                      sglGetActiveUniform(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+    SP_EXTERN GLint                     sglGetAttribLocation(GLuint program, const GLchar* name);
+    SP_EXTERN GLenum                    sglGetError(void);
+    SP_EXTERN void                      sglGetProgramInfoLog(GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog);
+    SP_EXTERN void                      sglGetProgramiv(GLuint program, GLenum pname, GLint* params);
+    SP_EXTERN void                      sglGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params);
+    SP_EXTERN void                      sglGetShaderInfoLog(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* infolog);
+    SP_EXTERN void                      sglGetShaderiv(GLuint shader, GLenum pname, GLint* params);
+    SP_EXTERN const GLubyte*            sglGetString(GLenum name);
+    SP_EXTERN GLint                     sglGetUniformLocation(GLuint program, const GLchar* name);
+    SP_EXTERN GLboolean                 sglIsEnabled(GLenum cap);
+    SP_EXTERN void                      sglLinkProgram(GLuint program);
+    SP_EXTERN GLvoid*                   sglMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+    SP_EXTERN void                      sglPixelStorei(GLenum pname, GLint param);
+    SP_EXTERN void                      sglReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels);
+    SP_EXTERN void                      sglRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+    SP_EXTERN void                      sglRenderbufferStorageMultisample(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height);
+    SP_EXTERN void                      sglShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+    SP_EXTERN void                      sglStencilFunc(GLenum func, GLint ref, GLuint mask);
+    SP_EXTERN void                      sglStencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+    SP_EXTERN void                      sglTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
+    SP_EXTERN void                      sglTexParameterf(GLenum target, GLenum pname, GLfloat param);
+    SP_EXTERN void                      sglTexParameteri(GLenum target, GLenum pname, GLint param);
+    SP_EXTERN void                      sglUniform1f(GLint location, GLfloat x);
+    SP_EXTERN void                      sglUniform1i(GLint location, GLint x);
+    SP_EXTERN void                      sglUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+    SP_EXTERN void                      sglUniform4fv(GLint location, GLsizei count, const GLfloat* v);
+    SP_EXTERN void                      sglUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    SP_EXTERN GLboolean                 sglUnmapBuffer(GLenum target);
+    SP_EXTERN void                      sglVertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* ptr);
+#endif
@@ -27,38 +27,654 @@ const char* sglGetErrorString(uint error)
 }
 
 /** --------------------------------------------------------------------------------------------- */
-#pragma mark - OpenGL State Cache
+#pragma mark - OpenGL Backend
 /** --------------------------------------------------------------------------------------------- */
 
-#if SP_ENABLE_GL_STATE_CACHE
+#if SP_ENABLE_GL_STATE_CACHE || SP_ENABLE_GL_BACKEND
 
 // undefine previous 'shims'
 #undef glActiveTexture
+#undef glAttachShader
 #undef glBindBuffer
 #undef glBindFramebuffer
 #undef glBindRenderbuffer
 #undef glBindTexture
 #undef glBindVertexArray
 #undef glBlendFunc
+#undef glBufferData
+#undef glBufferSubData
+#undef glCheckFramebufferStatus
+#undef glClear
 #undef glClearColor
+#undef glClearDepthf
+#undef glClearStencil
+#undef glCompileShader
+#undef glCompressedTexImage2D
 #undef glCreateProgram
+#undef glCreateShader
 #undef glDeleteBuffers
 #undef glDeleteFramebuffers
 #undef glDeleteProgram
 #undef glDeleteRenderbuffers
+#undef glDeleteShader
 #undef glDeleteTextures
 #undef glDeleteVertexArrays
+#undef glDepthFunc
+#undef glDepthMask
+#undef glDetachShader
 #undef glDisable
+#undef glDisableVertexAttribArray
+#undef glDiscardFramebufferEXT
+#undef glDrawArrays
+#undef glDrawElements
 #undef glEnable
+#undef glEnableVertexAttribArray
+#undef glFramebufferRenderbuffer
+#undef glFramebufferTexture2D
+#undef glGenBuffers
+#undef glGenFramebuffers
+#undef glGenRenderbuffers
+#undef glGenTextures
+#undef glGenVertexArrays
+#undef glGenerateMipmap
+#undef glGetActiveAttrib
+#undef glGetActiveUniform
+#undef glGetAttribLocation
+#undef glGetError
 #undef glGetIntegerv
+#undef glGetProgramInfoLog
+#undef glGetProgramiv
+#undef glGetRenderbufferParameteriv
+#undef glGetShaderInfoLog
+#undef glGetShaderiv
+#undef glGetString
+#undef glGetUniformLocation
+#undef glIsEnabled
 #undef glLinkProgram
+#undef glMapBufferRangeEXT
+#undef glPixelStorei
+#undef glReadPixels
+#undef glRenderbufferStorage
+#undef glRenderbufferStorageMultisampleAPPLE
 #undef glScissor
+#undef glShaderSource
+#undef glStencilFunc
+#undef glStencilOp
+#undef glTexImage2D
+#undef glTexParameterf
+#undef glTexParameteri
+#undef glUniform1f
+#undef glUniform1i
+#undef glUniform4f
+#undef glUniform4fv
+#undef glUniformMatrix4fv
+#undef glUnmapBufferOES
 #undef glUseProgram
+#undef glVertexAttribPointer
 #undef glViewport
 
 // redefine extension mappings
 #define glBindVertexArray       glBindVertexArrayOES
 #define glDeleteVertexArrays    glDeleteVertexArraysOES
+#define glGenVertexArrays       glGenVertexArraysOES
+
+#endif
+
+#if SP_ENABLE_GL_BACKEND
+
+static const SGLBackend defaultBackend =
+{
+    .activeTexture                  = glActiveTexture,
+    .attachShader                   = glAttachShader,
+    .bindBuffer                     = glBindBuffer,
+    .bindFramebuffer                = glBindFramebuffer,
+    .bindRenderbuffer               = glBindRenderbuffer,
+    .bindTexture                    = glBindTexture,
+    .bindVertexArray                = glBindVertexArray,
+    .blendFunc                      = glBlendFunc,
+    .bufferData                     = glBufferData,
+    .bufferSubData                  = glBufferSubData,
+    .checkFramebufferStatus         = glCheckFramebufferStatus,
+    .clear                          = glClear,
+    .clearColor                     = glClearColor,
+    .clearDepthf                    = glClearDepthf,
+    .clearStencil                   = glClearStencil,
+    .compileShader                  = glCompileShader,
+    .compressedTexImage2D           = glCompressedTexImage2D,
+    .createProgram                  = glCreateProgram,
+    .createShader                   = glCreateShader,
+    .deleteBuffers                  = glDeleteBuffers,
+    .deleteFramebuffers             = glDeleteFramebuffers,
+    .deleteProgram                  = glDeleteProgram,
+    .deleteRenderbuffers            = glDeleteRenderbuffers,
+    .deleteShader                   = glDeleteShader,
+    .deleteTextures                 = glDeleteTextures,
+    .deleteVertexArrays             = glDeleteVertexArrays,
+    .depthFunc                      = glDepthFunc,
+    .depthMask                      = glDepthMask,
+    .detachShader                   = glDetachShader,
+    .disable                        = glDisable,
+    .disableVertexAttribArray       = glDisableVertexAttribArray,
+    .discardFramebuffer             = glDiscardFramebufferEXT,
+    .drawArrays                     = glDrawArrays,
+    .drawElements                   = glDrawElements,
+    .enable                         = glEnable,
+    .enableVertexAttribArray        = glEnableVertexAttribArray,
+    .framebufferRenderbuffer        = glFramebufferRenderbuffer,
+    .framebufferTexture2D           = glFramebufferTexture2D,
+    .genBuffers                     = glGenBuffers,
+    .generateMipmap                 = glGenerateMipmap,
+    .genFramebuffers                = glGenFramebuffers,
+    .genRenderbuffers               = glGenRenderbuffers,
+    .genTextures                    = glGenTextures,
+    .genVertexArrays                = glGenVertexArrays,
+    .getActiveAttrib                = glGetActiveAttrib,
+    .getActiveUniform               = glGetActiveUniform,
+    .getAttribLocation              = glGetAttribLocation,
+    .getError                       = glGetError,
+    .getIntegerv                    = glGetIntegerv,
+    .getProgramInfoLog              = glGetProgramInfoLog,
+    .getProgramiv                   = glGetProgramiv,
+    .getRenderbufferParameteriv     = glGetRenderbufferParameteriv,
+    .getShaderInfoLog               = glGetShaderInfoLog,
+    .getShaderiv                    = glGetShaderiv,
+    .getString                      = glGetString,
+    .getUniformLocation             = glGetUniformLocation,
+    .isEnabled                      = glIsEnabled,
+    .linkProgram                    = glLinkProgram,
+    .mapBufferRange                 = glMapBufferRangeEXT,
+    .pixelStorei                    = glPixelStorei,
+    .readPixels                     = glReadPixels,
+    .renderbufferStorage            = glRenderbufferStorage,
+    .renderbufferStorageMultisample = glRenderbufferStorageMultisampleAPPLE,
+    .scissor                        = glScissor,
+    .shaderSource                   = glShaderSource,
+    .stencilFunc                    = glStencilFunc,
+    .stencilOp                      = glStencilOp,
+    .texImage2D                     = glTexImage2D,
+    .texParameterf                  = glTexParameterf,
+    .texParameteri                  = glTexParameteri,
+    .uniform1f                      = glUniform1f,
+    .uniform1i                      = glUniform1i,
+    .uniform4f                      = glUniform4f,
+    .uniform4fv                     = glUniform4fv,
+    .uniformMatrix4fv               = glUniformMatrix4fv,
+    .unmapBuffer                    = glUnmapBufferOES,
+    .useProgram                     = glUseProgram,
+    .vertexAttribPointer            = glVertexAttribPointer,
+    .viewport                       = glViewport,
+};
+
+static const SGLBackend *currentBackend = &defaultBackend;
+
+const SGLBackend* sglBackendGetDefault(void)
+{
+    return &defaultBackend;
+}
+
+const SGLBackend* sglBackendGetCurrent(void)
+{
+    return currentBackend;
+}
+
+void sglBackendSetCurrent(const SGLBackend* backend)
+{
+    currentBackend = backend ? backend : &defaultBackend;
+}
+
+// backend entry points (used by the state cache)
+#define __glActiveTexture         currentBackend->activeTexture
+#define __glBindBuffer            currentBackend->bindBuffer
+#define __glBindFramebuffer       currentBackend->bindFramebuffer
+#define __glBindRenderbuffer      currentBackend->bindRenderbuffer
+#define __glBindTexture           currentBackend->bindTexture
+#define __glBindVertexArray       currentBackend->bindVertexArray
+#define __glBlendFunc             currentBackend->blendFunc
+#define __glDeleteBuffers         currentBackend->deleteBuffers
+#define __glDeleteFramebuffers    currentBackend->deleteFramebuffers
+#define __glDeleteProgram         currentBackend->deleteProgram
+#define __glDeleteRenderbuffers   currentBackend->deleteRenderbuffers
+#define __glDeleteTextures        currentBackend->deleteTextures
+#define __glDeleteVertexArrays    currentBackend->deleteVertexArrays
+#define __glDisable               currentBackend->disable
+#define __glEnable                currentBackend->enable
+#define __glGetIntegerv           currentBackend->getIntegerv
+#define __glScissor               currentBackend->scissor
+#define __glUseProgram            currentBackend->useProgram
+#define __glViewport              currentBackend->viewport
+
+void sglAttachShader(GLuint program, GLuint shader)
+{
+    currentBackend->attachShader(program, shader);
+}
+
+void sglBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    currentBackend->bufferData(target, size, data, usage);
+}
+
+void sglBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    currentBackend->bufferSubData(target, offset, size, data);
+}
+
+GLenum sglCheckFramebufferStatus(GLenum target)
+{
+    return currentBackend->checkFramebufferStatus(target);
+}
+
+void sglClear(GLbitfield mask)
+{
+    currentBackend->clear(mask);
+}
+
+void sglClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    currentBackend->clearColor(red, green, blue, alpha);
+}
+
+void sglClearDepthf(GLclampf depth)
+{
+    currentBackend->clearDepthf(depth);
+}
+
+void sglClearStencil(GLint s)
+{
+    currentBackend->clearStencil(s);
+}
+
+void sglCompileShader(GLuint shader)
+{
+    currentBackend->compileShader(shader);
+}
+
+void sglCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data)
+{
+    currentBackend->compressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+}
+
+GLuint sglCreateProgram(void)
+{
+    return currentBackend->createProgram();
+}
+
+GLuint sglCreateShader(GLenum type)
+{
+    return currentBackend->createShader(type);
+}
+
+void sglDeleteShader(GLuint shader)
+{
+    currentBackend->deleteShader(shader);
+}
+
+void sglDepthFunc(GLenum func)
+{
+    currentBackend->depthFunc(func);
+}
+
+void sglDepthMask(GLboolean flag)
+{
+    currentBackend->depthMask(flag);
+}
+
+void sglDetachShader(GLuint program, GLuint shader)
+{
+    currentBackend->detachShader(program, shader);
+}
+
+void sglDisableVertexAttribArray(GLuint index)
+{
+    currentBackend->disableVertexAttribArray(index);
+}
+
+void sglDiscardFramebuffer(GLenum target, GLsizei numAttachments, const GLenum* attachments)
+{
+    currentBackend->discardFramebuffer(target, numAttachments, attachments);
+}
+
+void sglDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    currentBackend->drawArrays(mode, first, count);
+}
+
+void sglDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+    currentBackend->drawElements(mode, count, type, indices);
+}
+
+void sglEnableVertexAttribArray(GLuint index)
+{
+    currentBackend->enableVertexAttribArray(index);
+}
+
+void sglFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+    currentBackend->framebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+}
+
+void sglFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+    currentBackend->framebufferTexture2D(target, attachment, textarget, texture, level);
+}
+
+void sglGenBuffers(GLsizei n, GLuint* buffers)
+{
+    currentBackend->genBuffers(n, buffers);
+}
+
+void sglGenerateMipmap(GLenum target)
+{
+    currentBackend->generateMipmap(target);
+}
+
+void sglGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    currentBackend->genFramebuffers(n, framebuffers);
+}
+
+void sglGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    currentBackend->genRenderbuffers(n, renderbuffers);
+}
+
+void sglGenTextures(GLsizei n, GLuint* textures)
+{
+    currentBackend->genTextures(n, textures);
+}
+
+void sglGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    currentBackend->genVertexArrays(n, arrays);
+}
+
+void sglGetActiveAttrib(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    currentBackend->getActiveAttrib(program, index, bufsize, length, size, type, name);
+}
+
+void sglGetActiveUniform(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    currentBackend->getActiveUniform(program, index, bufsize, length, size, type, name);
+}
+
+GLint sglGetAttribLocation(GLuint program, const GLchar* name)
+{
+    return currentBackend->getAttribLocation(program, name);
+}
+
+GLenum sglGetError(void)
+{
+    return currentBackend->getError();
+}
+
+void sglGetProgramInfoLog(GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog)
+{
+    currentBackend->getProgramInfoLog(program, bufsize, length, infolog);
+}
+
+void sglGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    currentBackend->getProgramiv(program, pname, params);
+}
+
+void sglGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    currentBackend->getRenderbufferParameteriv(target, pname, params);
+}
+
+void sglGetShaderInfoLog(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* infolog)
+{
+    currentBackend->getShaderInfoLog(shader, bufsize, length, infolog);
+}
+
+void sglGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    currentBackend->getShaderiv(shader, pname, params);
+}
+
+const GLubyte*sglGetString(GLenum name)
+{
+    return currentBackend->getString(name);
+}
+
+GLint sglGetUniformLocation(GLuint program, const GLchar* name)
+{
+    return currentBackend->getUniformLocation(program, name);
+}
+
+GLboolean sglIsEnabled(GLenum cap)
+{
+    return currentBackend->isEnabled(cap);
+}
+
+void sglLinkProgram(GLuint program)
+{
+    currentBackend->linkProgram(program);
+}
+
+GLvoid* sglMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    return currentBackend->mapBufferRange(target, offset, length, access);
+}
+
+void sglPixelStorei(GLenum pname, GLint param)
+{
+    currentBackend->pixelStorei(pname, param);
+}
+
+void sglReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels)
+{
+    currentBackend->readPixels(x, y, width, height, format, type, pixels);
+}
+
+void sglRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    currentBackend->renderbufferStorage(target, internalformat, width, height);
+}
+
+void sglRenderbufferStorageMultisample(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    currentBackend->renderbufferStorageMultisample(target, samples, internalformat, width, height);
+}
+
+void sglShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    currentBackend->shaderSource(shader, count, string, length);
+}
+
+void sglStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    currentBackend->stencilFunc(func, ref, mask);
+}
+
+void sglStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    currentBackend->stencilOp(fail, zfail, zpass);
+}
+
+void sglTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    currentBackend->texImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+void sglTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    currentBackend->texParameterf(target, pname, param);
+}
+
+void sglTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    currentBackend->texParameteri(target, pname, param);
+}
+
+void sglUniform1f(GLint location, GLfloat x)
+{
+    currentBackend->uniform1f(location, x);
+}
+
+void sglUniform1i(GLint location, GLint x)
+{
+    currentBackend->uniform1i(location, x);
+}
+
+void sglUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
+{
+    currentBackend->uniform4f(location, x, y, z, w);
+}
+
+void sglUniform4fv(GLint location, GLsizei count, const GLfloat* v)
+{
+    currentBackend->uniform4fv(location, count, v);
+}
+
+void sglUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    currentBackend->uniformMatrix4fv(location, count, transpose, value);
+}
+
+GLboolean sglUnmapBuffer(GLenum target)
+{
+    return currentBackend->unmapBuffer(target);
+}
+
+void sglVertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* ptr)
+{
+    currentBackend->vertexAttribPointer(indx, size, type, normalized, stride, ptr);
+}
+
+#if !SP_ENABLE_GL_STATE_CACHE
+
+void sglActiveTexture(GLenum texture)
+{
+    currentBackend->activeTexture(texture);
+}
+
+void sglBindBuffer(GLenum target, GLuint buffer)
+{
+    currentBackend->bindBuffer(target, buffer);
+}
+
+void sglBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    currentBackend->bindFramebuffer(target, framebuffer);
+}
+
+void sglBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    currentBackend->bindRenderbuffer(target, renderbuffer);
+}
+
+void sglBindTexture(GLenum target, GLuint texture)
+{
+    currentBackend->bindTexture(target, texture);
+}
+
+void sglBindVertexArray(GLuint array)
+{
+    currentBackend->bindVertexArray(array);
+}
+
+void sglBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    currentBackend->blendFunc(sfactor, dfactor);
+}
+
+void sglDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    currentBackend->deleteBuffers(n, buffers);
+}
+
+void sglDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    currentBackend->deleteFramebuffers(n, framebuffers);
+}
+
+void sglDeleteProgram(GLuint program)
+{
+    currentBackend->deleteProgram(program);
+}
+
+void sglDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+    currentBackend->deleteRenderbuffers(n, renderbuffers);
+}
+
+void sglDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    currentBackend->deleteTextures(n, textures);
+}
+
+void sglDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    currentBackend->deleteVertexArrays(n, arrays);
+}
+
+void sglDisable(GLenum cap)
+{
+    currentBackend->disable(cap);
+}
+
+void sglEnable(GLenum cap)
+{
+    currentBackend->enable(cap);
+}
+
+void sglGetIntegerv(GLenum pname, GLint* params)
+{
+    currentBackend->getIntegerv(pname, params);
+}
+
+void sglScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    currentBackend->scissor(x, y, width, height);
+}
+
+void sglUseProgram(GLuint program)
+{
+    currentBackend->useProgram(program);
+}
+
+void sglViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    currentBackend->viewport(x, y, width, height);
+}
+
+#endif // !SP_ENABLE_GL_STATE_CACHE
+
+#else
+
+#define __glActiveTexture         glActiveTexture
+#define __glBindBuffer            glBindBuffer
+#define __glBindFramebuffer       glBindFramebuffer
+#define __glBindRenderbuffer      glBindRenderbuffer
+#define __glBindTexture           glBindTexture
+#define __glBindVertexArray       glBindVertexArray
+#define __glBlendFunc             glBlendFunc
+#define __glDeleteBuffers         glDeleteBuffers
+#define __glDeleteFramebuffers    glDeleteFramebuffers
+#define __glDeleteProgram         glDeleteProgram
+#define __glDeleteRenderbuffers   glDeleteRenderbuffers
+#define __glDeleteTextures        glDeleteTextures
+#define __glDeleteVertexArrays    glDeleteVertexArrays
+#define __glDisable               glDisable
+#define __glEnable                glEnable
+#define __glGetIntegerv           glGetIntegerv
+#define __glScissor               glScissor
+#define __glUseProgram            glUseProgram
+#define __glViewport              glViewport
+
+const SGLBackend* sglBackendGetDefault(void)                                    { return NULL; }
+const SGLBackend* sglBackendGetCurrent(void)                                    { return NULL; }
+void              sglBackendSetCurrent(const SGLBackend* backend __unused)      {}
+
+#endif // SP_ENABLE_GL_BACKEND
+
+/** --------------------------------------------------------------------------------------------- */
+#pragma mark - OpenGL State Cache
+/** --------------------------------------------------------------------------------------------- */
+
+#if SP_ENABLE_GL_STATE_CACHE
 
 // constants
 #define MAX_TEXTURE_UNITS   32
@@ -131,7 +747,7 @@ SP_INLINE void __getChar(GLenum pname, GLchar* state, GLint* outParam)
     if (*state == INVALID_STATE)
     {
         GLint i;
-        glGetIntegerv(pname, &i);
+        __glGetIntegerv(pname, &i);
         *state = (GLchar)i;
     }
 
@@ -141,7 +757,7 @@ SP_INLINE void __getChar(GLenum pname, GLchar* state, GLint* outParam)
 SP_INLINE void __getInt(GLenum pname, GLint* state, GLint* outParam)
 {
     if (*state == INVALID_STATE)
-        glGetIntegerv(pname, state);
+        __glGetIntegerv(pname, state);
 
     *outParam = *state;
 }
@@ -149,7 +765,7 @@ SP_INLINE void __getInt(GLenum pname, GLint* state, GLint* outParam)
 SP_INLINE void __getIntv(GLenum pname, GLint count, GLint statev[], GLint* outParams)
 {
     if (*statev == INVALID_STATE)
-        glGetIntegerv(pname, statev);
+        __glGetIntegerv(pname, statev);
 
     memcpy(outParams, statev, sizeof(GLint)*count);
 }
@@ -292,7 +908,7 @@ void sglActiveTexture(GLenum texture)
     if (textureUnit != currentStateCache->textureUnit)
     {
         currentStateCache->textureUnit = textureUnit;
-        glActiveTexture(texture);
+        __glActiveTexture(texture);
     }
 }
 
@@ -304,7 +920,7 @@ void sglBindBuffer(GLenum target, GLuint buffer)
     if (buffer != currentStateCache->buffer[index])
     {
         currentStateCache->buffer[index] = buffer;
-        glBindBuffer(target, buffer);
+        __glBindBuffer(target, buffer);
     }
 }
 
@@ -314,7 +930,7 @@ void sglBindFramebuffer(GLenum target, GLuint framebuffer)
     if (framebuffer != currentStateCache->framebuffer)
     {
         currentStateCache->framebuffer = framebuffer;
-        glBindFramebuffer(target, framebuffer);
+        __glBindFramebuffer(target, framebuffer);
     }
 }
 
@@ -324,7 +940,7 @@ void sglBindRenderbuffer(GLenum target, GLuint renderbuffer)
     if (renderbuffer != currentStateCache->renderbuffer)
     {
         currentStateCache->renderbuffer = renderbuffer;
-        glBindRenderbuffer(target, renderbuffer);
+        __glBindRenderbuffer(target, renderbuffer);
     }
 }
 
@@ -337,7 +953,7 @@ void sglBindTexture(GLenum target, GLuint texture)
     if (texture != currentStateCache->texture[currentStateCache->textureUnit])
     {
         currentStateCache->texture[currentStateCache->textureUnit] = texture;
-        glBindTexture(target, texture);
+        __glBindTexture(target, texture);
     }
 }
 
@@ -347,7 +963,7 @@ void sglBindVertexArray(GLuint array)
     if (array != currentStateCache->vertexArray)
     {
         currentStateCache->vertexArray = array;
-        glBindVertexArray(array);
+        __glBindVertexArray(array);
     }
 }
 
@@ -358,7 +974,7 @@ void sglBlendFunc(GLenum sfactor, GLenum dfactor)
     {
         currentStateCache->blendSrc = sfactor;
         currentStateCache->blendDst = dfactor;
-        glBlendFunc(sfactor, dfactor);
+        __glBlendFunc(sfactor, dfactor);
     }
 }
 
@@ -371,7 +987,7 @@ void sglDeleteBuffers(GLsizei n, const GLuint* buffers)
         if (currentStateCache->buffer[1] == buffers[i]) currentStateCache->buffer[1] = INVALID_STATE;
     }
 
-    glDeleteBuffers(n, buffers);
+    __glDeleteBuffers(n, buffers);
 }
 
 void sglDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
@@ -383,7 +999,7 @@ void sglDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
             currentStateCache->framebuffer = INVALID_STATE;
     }
 
-    glDeleteFramebuffers(n, framebuffers);
+    __glDeleteFramebuffers(n, framebuffers);
 }
 
 void sglDeleteProgram(GLuint program)
@@ -392,7 +1008,7 @@ void sglDeleteProgram(GLuint program)
     if (currentStateCache->program == program)
         currentStateCache->program = INVALID_STATE;
 
-    glDeleteProgram(program);
+    __glDeleteProgram(program);
 }
 
 void sglDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
@@ -404,7 +1020,7 @@ void sglDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
             currentStateCache->renderbuffer = INVALID_STATE;
     }
 
-    glDeleteRenderbuffers(n, renderbuffers);
+    __glDeleteRenderbuffers(n, renderbuffers);
 }
 
 void sglDeleteTextures(GLsizei n, const GLuint* textures)
@@ -419,7 +1035,7 @@ void sglDeleteTextures(GLsizei n, const GLuint* textures)
         }
     }
 
-    glDeleteTextures(n, textures);
+    __glDeleteTextures(n, textures);
 }
 
 void sglDeleteVertexArrays(GLsizei n, const GLuint* arrays)
@@ -431,7 +1047,7 @@ void sglDeleteVertexArrays(GLsizei n, const GLuint* arrays)
             currentStateCache->vertexArray = INVALID_STATE;
     }
 
-    glDeleteVertexArrays(n, arrays);
+    __glDeleteVertexArrays(n, arrays);
 }
 
 void sglDisable(GLenum cap)
@@ -442,7 +1058,7 @@ void sglDisable(GLenum cap)
     if (currentStateCache->enabledCaps[index] != false)
     {
         currentStateCache->enabledCaps[index] = false;
-        glDisable(cap);
+        __glDisable(cap);
     }
 }
 
@@ -454,7 +1070,7 @@ void sglEnable(GLenum cap)
     if (currentStateCache->enabledCaps[index] != true)
     {
         currentStateCache->enabledCaps[index] = true;
-        glEnable(cap);
+        __glEnable(cap);
     }
 }
 
@@ -517,7 +1133,7 @@ void sglGetIntegerv(GLenum pname, GLint* params)
             return;
     }
 
-    glGetIntegerv(pname, params);
+    __glGetIntegerv(pname, params);
 }
 
 void sglScissor(GLint x, GLint y, GLsizei width, GLsizei height)
@@ -533,7 +1149,7 @@ void sglScissor(GLint x, GLint y, GLsizei width, GLsizei height)
         currentStateCache->scissor[2] = width;
         currentStateCache->scissor[3] = height;
 
-        glScissor(x, y, width, height);
+        __glScissor(x, y, width, height);
     }
 }
 
@@ -543,7 +1159,7 @@ void sglUseProgram(GLuint program)
     if (program != currentStateCache->program)
     {
         currentStateCache->program = program;
-        glUseProgram(program);
+        __glUseProgram(program);
     }
 }
 
@@ -560,7 +1176,7 @@ void sglViewport(GLint x, GLint y, GLsizei width, GLsizei height)
         currentStateCache->viewport[2] = width;
         currentStateCache->viewport[3] = height;
         
-        glViewport(x, y, width, height);
+        __glViewport(x, y, width, height);
     }
 }
 
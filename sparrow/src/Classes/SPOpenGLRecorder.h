@@ -0,0 +1,108 @@
+//
+//  SPOpenGLRecorder.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import <Sparrow/SparrowBase.h>
+#import <Sparrow/SPOpenGL.h>
+
+/// The category of a recorded OpenGL command.
+typedef NS_ENUM(uint, SGLCommandType)
+{
+    /// glDrawElements and glDrawArrays.
+    SGLCommandTypeDraw,
+    /// glClear.
+    SGLCommandTypeClear,
+    /// Buffer and texture uploads.
+    SGLCommandTypeUpload,
+    /// Buffer, texture, framebuffer, renderbuffer, vertex array and program bindings.
+    SGLCommandTypeBind,
+    /// Changes of capabilities, blend, stencil, depth, scissor and viewport state.
+    SGLCommandTypeState,
+    /// Uniform updates.
+    SGLCommandTypeUniform,
+    /// Vertex attribute setup.
+    SGLCommandTypeAttribute,
+    /// Creation and deletion of objects, shader compilation.
+    SGLCommandTypeResource,
+    /// Any 'glGet*' call.
+    SGLCommandTypeQuery,
+};
+
+/// A single OpenGL call captured by a recorder.
+typedef struct
+{
+    /// The category of the command.
+    SGLCommandType type;
+    /// The name of the OpenGL function, e.g. "glDrawElements".
+    const char *name;
+    /// The target, mode or capability the command refers to.
+    GLenum target;
+    /// Command specific parameters, e.g. the index count and type of a draw call.
+    GLint params[4];
+    /// The number of bytes uploaded (upload commands only).
+    GLsizeiptr numBytes;
+} SGLCommand;
+
+/// Sparrow's OpenGL recorder reference type.
+typedef struct SGLRecorder *SGLRecorderRef;
+
+/// Allocates a new recorder. Per default, the recorder does not forward any calls, which makes it
+/// a headless backend: the complete rendering pipeline can run without a GPU.
+SP_EXTERN SGLRecorderRef sglRecorderCreate(void);
+
+/// Deallocates a recorder. If it is still recording, the previous backend is restored.
+SP_EXTERN void sglRecorderRelease(SGLRecorderRef recorder);
+
+/// Installs the recorder as the current OpenGL backend. Recorders may be nested; the calls are
+/// then recorded by the innermost one. Builds without 'SP_ENABLE_GL_BACKEND' (i.e. release builds,
+/// per default) can't record anything; there, this function fails an assertion.
+SP_EXTERN void sglRecorderBegin(SGLRecorderRef recorder);
+
+/// Restores the backend that was active before 'sglRecorderBegin' was called. Nested recorders
+/// must be ended in the reverse order in which they were begun; anything else raises an exception.
+SP_EXTERN void sglRecorderEnd(SGLRecorderRef recorder);
+
+/// Clears the command log and all counters (e.g. at the beginning of a frame). The emulated
+/// OpenGL state is kept.
+SP_EXTERN void sglRecorderReset(SGLRecorderRef recorder);
+
+/// Indicates if the recorded calls are forwarded to the backend that was active before recording
+/// started. Use this to trace a real device; the default is 'NO'.
+SP_EXTERN BOOL sglRecorderGetForwardsCalls(SGLRecorderRef recorder);
+
+/// Enables or disables forwarding of the recorded calls.
+SP_EXTERN void sglRecorderSetForwardsCalls(SGLRecorderRef recorder, BOOL forwardsCalls);
+
+/// Returns the number of commands in the log.
+SP_EXTERN NSInteger sglRecorderGetNumCommands(SGLRecorderRef recorder);
+
+/// Returns the command at a certain index of the log.
+SP_EXTERN const SGLCommand* sglRecorderGetCommandAtIndex(SGLRecorderRef recorder, NSInteger index);
+
+/// Returns the number of commands of a certain type in the log.
+SP_EXTERN NSInteger sglRecorderGetNumCommandsOfType(SGLRecorderRef recorder, SGLCommandType type);
+
+/// Returns the number of draw calls since the last reset.
+SP_EXTERN NSInteger sglRecorderGetNumDrawCalls(SGLRecorderRef recorder);
+
+/// Returns the number of vertices (or indices) that were drawn since the last reset.
+SP_EXTERN NSInteger sglRecorderGetNumElementsDrawn(SGLRecorderRef recorder);
+
+/// Returns the number of bytes uploaded to vertex and index buffers since the last reset.
+SP_EXTERN NSInteger sglRecorderGetNumBytesUploaded(SGLRecorderRef recorder);
+
+/// Returns the number of bytes uploaded to textures since the last reset.
+SP_EXTERN NSInteger sglRecorderGetNumTextureBytesUploaded(SGLRecorderRef recorder);
+
+/// Returns the number of binds and state changes since the last reset.
+SP_EXTERN NSInteger sglRecorderGetNumStateChanges(SGLRecorderRef recorder);
+
+/// Returns a string representing a command type.
+SP_EXTERN const char* sglGetCommandTypeString(SGLCommandType type);
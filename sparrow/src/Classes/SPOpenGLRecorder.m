@@ -0,0 +1,998 @@
+//
+//  SPOpenGLRecorder.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPOpenGLRecorder.h"
+
+// constants
+#define MAX_TEXTURE_UNITS   32
+#define NUM_CAPABILITIES    9
+#define MIN_COMMAND_CAPACITY 256
+
+// recorder definition
+struct SGLRecorder
+{
+    const SGLBackend *forwardBackend;
+    SGLRecorderRef previousRecorder;
+    BOOL forwardsCalls;
+    BOOL recording;
+
+    SGLCommand *commands;
+    NSInteger numCommands;
+    NSInteger commandCapacity;
+
+    NSInteger numDrawCalls;
+    NSInteger numElementsDrawn;
+    NSInteger numBytesUploaded;
+    NSInteger numTextureBytesUploaded;
+    NSInteger numStateChanges;
+
+    // memory handed out by 'glMapBufferRange' when calls are not forwarded
+    void *mappedData;
+    GLsizeiptr mappedCapacity;
+
+    // emulated state
+    GLuint nextName;
+    GLint  textureUnit;
+    GLint  texture[MAX_TEXTURE_UNITS];
+    GLint  buffer[2];
+    GLint  program;
+    GLint  framebuffer;
+    GLint  renderbuffer;
+    GLint  vertexArray;
+    GLint  viewport[4];
+    GLint  scissor[4];
+    GLint  renderbufferSize[2];
+    GLint  packAlignment;
+    GLint  unpackAlignment;
+    BOOL   enabledCaps[NUM_CAPABILITIES];
+};
+
+// the recorder that is currently installed
+static SGLRecorderRef currentRecorder = NULL;
+
+/** --------------------------------------------------------------------------------------------- */
+#pragma mark Internal
+/** --------------------------------------------------------------------------------------------- */
+
+SP_INLINE int __getIndexForCapability(GLenum cap)
+{
+    switch (cap)
+    {
+        case GL_BLEND:                      return 0;
+        case GL_CULL_FACE:                  return 1;
+        case GL_DEPTH_TEST:                 return 2;
+        case GL_DITHER:                     return 3;
+        case GL_POLYGON_OFFSET_FILL:        return 4;
+        case GL_SAMPLE_ALPHA_TO_COVERAGE:   return 5;
+        case GL_SAMPLE_COVERAGE:            return 6;
+        case GL_SCISSOR_TEST:               return 7;
+        case GL_STENCIL_TEST:               return 8;
+    }
+
+    return -1;
+}
+
+SP_INLINE GLsizeiptr __getBytesPerPixel(GLenum format, GLenum type)
+{
+    switch (type)
+    {
+        case GL_UNSIGNED_SHORT_5_6_5:
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:     return 2;
+    }
+
+    switch (format)
+    {
+        case GL_RGB:                        return 3;
+        case GL_LUMINANCE_ALPHA:            return 2;
+        case GL_ALPHA:
+        case GL_LUMINANCE:                  return 1;
+    }
+
+    return 4;
+}
+
+SP_INLINE void __record(SGLCommandType type, const char *name, GLenum target,
+                        GLint p0, GLint p1, GLint p2, GLint p3, GLsizeiptr numBytes)
+{
+    SGLRecorderRef recorder = currentRecorder;
+
+    if (recorder->numCommands == recorder->commandCapacity)
+    {
+        recorder->commandCapacity = MAX(MIN_COMMAND_CAPACITY, recorder->commandCapacity * 2);
+        recorder->commands = realloc(recorder->commands, sizeof(SGLCommand) * recorder->commandCapacity);
+    }
+
+    SGLCommand *command = &recorder->commands[recorder->numCommands++];
+    command->type = type;
+    command->name = name;
+    command->target = target;
+    command->params[0] = p0;
+    command->params[1] = p1;
+    command->params[2] = p2;
+    command->params[3] = p3;
+    command->numBytes = numBytes;
+
+    if (type == SGLCommandTypeBind || type == SGLCommandTypeState)
+        ++recorder->numStateChanges;
+}
+
+SP_INLINE void __generateNames(GLsizei n, GLuint* names)
+{
+    for (int i=0; i<n; ++i)
+        names[i] = currentRecorder->nextName++;
+}
+
+#define FORWARDS            (currentRecorder->forwardsCalls)
+#define FORWARD(call)       if (FORWARDS) currentRecorder->forwardBackend->call
+
+/** --------------------------------------------------------------------------------------------- */
+#pragma mark Recording Backend
+/** --------------------------------------------------------------------------------------------- */
+
+static void __recActiveTexture(GLenum texture)
+{
+    __record(SGLCommandTypeBind, "glActiveTexture", texture, 0, 0, 0, 0, 0);
+    currentRecorder->textureUnit = texture - GL_TEXTURE0;
+    FORWARD(activeTexture(texture));
+}
+
+static void __recAttachShader(GLuint program, GLuint shader)
+{
+    __record(SGLCommandTypeResource, "glAttachShader", 0, program, shader, 0, 0, 0);
+    FORWARD(attachShader(program, shader));
+}
+
+static void __recBindBuffer(GLenum target, GLuint buffer)
+{
+    __record(SGLCommandTypeBind, "glBindBuffer", target, buffer, 0, 0, 0, 0);
+    currentRecorder->buffer[target == GL_ELEMENT_ARRAY_BUFFER ? 1 : 0] = buffer;
+    FORWARD(bindBuffer(target, buffer));
+}
+
+static void __recBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    __record(SGLCommandTypeBind, "glBindFramebuffer", target, framebuffer, 0, 0, 0, 0);
+    currentRecorder->framebuffer = framebuffer;
+    FORWARD(bindFramebuffer(target, framebuffer));
+}
+
+static void __recBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    __record(SGLCommandTypeBind, "glBindRenderbuffer", target, renderbuffer, 0, 0, 0, 0);
+    currentRecorder->renderbuffer = renderbuffer;
+    FORWARD(bindRenderbuffer(target, renderbuffer));
+}
+
+static void __recBindTexture(GLenum target, GLuint texture)
+{
+    SGLRecorderRef recorder = currentRecorder;
+    __record(SGLCommandTypeBind, "glBindTexture", target, texture, recorder->textureUnit, 0, 0, 0);
+
+    if (recorder->textureUnit >= 0 && recorder->textureUnit < MAX_TEXTURE_UNITS)
+        recorder->texture[recorder->textureUnit] = texture;
+
+    FORWARD(bindTexture(target, texture));
+}
+
+static void __recBindVertexArray(GLuint array)
+{
+    __record(SGLCommandTypeBind, "glBindVertexArray", 0, array, 0, 0, 0, 0);
+    currentRecorder->vertexArray = array;
+    FORWARD(bindVertexArray(array));
+}
+
+static void __recBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    __record(SGLCommandTypeState, "glBlendFunc", 0, sfactor, dfactor, 0, 0, 0);
+    FORWARD(blendFunc(sfactor, dfactor));
+}
+
+static void __recBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    __record(SGLCommandTypeUpload, "glBufferData", target, usage, 0, 0, 0, data ? size : 0);
+    if (data) currentRecorder->numBytesUploaded += size; // no data: orphaning or allocation
+    FORWARD(bufferData(target, size, data, usage));
+}
+
+static void __recBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    __record(SGLCommandTypeUpload, "glBufferSubData", target, (GLint)offset, 0, 0, 0, size);
+    currentRecorder->numBytesUploaded += size;
+    FORWARD(bufferSubData(target, offset, size, data));
+}
+
+static GLenum __recCheckFramebufferStatus(GLenum target)
+{
+    __record(SGLCommandTypeQuery, "glCheckFramebufferStatus", target, 0, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->checkFramebufferStatus(target);
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static void __recClear(GLbitfield mask)
+{
+    __record(SGLCommandTypeClear, "glClear", 0, mask, 0, 0, 0, 0);
+    FORWARD(clear(mask));
+}
+
+static void __recClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    __record(SGLCommandTypeState, "glClearColor", 0, red * 255, green * 255, blue * 255, alpha * 255, 0);
+    FORWARD(clearColor(red, green, blue, alpha));
+}
+
+static void __recClearDepthf(GLclampf depth)
+{
+    __record(SGLCommandTypeState, "glClearDepthf", 0, 0, 0, 0, 0, 0);
+    FORWARD(clearDepthf(depth));
+}
+
+static void __recClearStencil(GLint s)
+{
+    __record(SGLCommandTypeState, "glClearStencil", 0, s, 0, 0, 0, 0);
+    FORWARD(clearStencil(s));
+}
+
+static void __recCompileShader(GLuint shader)
+{
+    __record(SGLCommandTypeResource, "glCompileShader", 0, shader, 0, 0, 0, 0);
+    FORWARD(compileShader(shader));
+}
+
+static void __recCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width,
+                                      GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data)
+{
+    __record(SGLCommandTypeUpload, "glCompressedTexImage2D", target, level, width, height, 0, imageSize);
+    currentRecorder->numTextureBytesUploaded += imageSize;
+    FORWARD(compressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data));
+}
+
+static GLuint __recCreateProgram(void)
+{
+    GLuint program = FORWARDS ? currentRecorder->forwardBackend->createProgram() : currentRecorder->nextName++;
+    __record(SGLCommandTypeResource, "glCreateProgram", 0, program, 0, 0, 0, 0);
+    return program;
+}
+
+static GLuint __recCreateShader(GLenum type)
+{
+    GLuint shader = FORWARDS ? currentRecorder->forwardBackend->createShader(type) : currentRecorder->nextName++;
+    __record(SGLCommandTypeResource, "glCreateShader", type, shader, 0, 0, 0, 0);
+    return shader;
+}
+
+static void __recDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    __record(SGLCommandTypeResource, "glDeleteBuffers", 0, n, n ? buffers[0] : 0, 0, 0, 0);
+    FORWARD(deleteBuffers(n, buffers));
+}
+
+static void __recDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    __record(SGLCommandTypeResource, "glDeleteFramebuffers", 0, n, n ? framebuffers[0] : 0, 0, 0, 0);
+    FORWARD(deleteFramebuffers(n, framebuffers));
+}
+
+static void __recDeleteProgram(GLuint program)
+{
+    __record(SGLCommandTypeResource, "glDeleteProgram", 0, program, 0, 0, 0, 0);
+    FORWARD(deleteProgram(program));
+}
+
+static void __recDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+    __record(SGLCommandTypeResource, "glDeleteRenderbuffers", 0, n, n ? renderbuffers[0] : 0, 0, 0, 0);
+    FORWARD(deleteRenderbuffers(n, renderbuffers));
+}
+
+static void __recDeleteShader(GLuint shader)
+{
+    __record(SGLCommandTypeResource, "glDeleteShader", 0, shader, 0, 0, 0, 0);
+    FORWARD(deleteShader(shader));
+}
+
+static void __recDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    __record(SGLCommandTypeResource, "glDeleteTextures", 0, n, n ? textures[0] : 0, 0, 0, 0);
+    FORWARD(deleteTextures(n, textures));
+}
+
+static void __recDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    __record(SGLCommandTypeResource, "glDeleteVertexArrays", 0, n, n ? arrays[0] : 0, 0, 0, 0);
+    FORWARD(deleteVertexArrays(n, arrays));
+}
+
+static void __recDepthFunc(GLenum func)
+{
+    __record(SGLCommandTypeState, "glDepthFunc", func, 0, 0, 0, 0, 0);
+    FORWARD(depthFunc(func));
+}
+
+static void __recDepthMask(GLboolean flag)
+{
+    __record(SGLCommandTypeState, "glDepthMask", 0, flag, 0, 0, 0, 0);
+    FORWARD(depthMask(flag));
+}
+
+static void __recDetachShader(GLuint program, GLuint shader)
+{
+    __record(SGLCommandTypeResource, "glDetachShader", 0, program, shader, 0, 0, 0);
+    FORWARD(detachShader(program, shader));
+}
+
+static void __recDisable(GLenum cap)
+{
+    int index = __getIndexForCapability(cap);
+    __record(SGLCommandTypeState, "glDisable", cap, 0, 0, 0, 0, 0);
+    if (index >= 0) currentRecorder->enabledCaps[index] = NO;
+    FORWARD(disable(cap));
+}
+
+static void __recDisableVertexAttribArray(GLuint index)
+{
+    __record(SGLCommandTypeAttribute, "glDisableVertexAttribArray", 0, index, 0, 0, 0, 0);
+    FORWARD(disableVertexAttribArray(index));
+}
+
+static void __recDiscardFramebuffer(GLenum target, GLsizei numAttachments, const GLenum* attachments)
+{
+    __record(SGLCommandTypeState, "glDiscardFramebufferEXT", target, numAttachments, 0, 0, 0, 0);
+    FORWARD(discardFramebuffer(target, numAttachments, attachments));
+}
+
+static void __recDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    SGLRecorderRef recorder = currentRecorder;
+    __record(SGLCommandTypeDraw, "glDrawArrays", mode, count, first, 0, 0, 0);
+    ++recorder->numDrawCalls;
+    recorder->numElementsDrawn += count;
+    FORWARD(drawArrays(mode, first, count));
+}
+
+static void __recDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+    SGLRecorderRef recorder = currentRecorder;
+    __record(SGLCommandTypeDraw, "glDrawElements", mode, count, type, (GLint)(intptr_t)indices, 0, 0);
+    ++recorder->numDrawCalls;
+    recorder->numElementsDrawn += count;
+    FORWARD(drawElements(mode, count, type, indices));
+}
+
+static void __recEnable(GLenum cap)
+{
+    int index = __getIndexForCapability(cap);
+    __record(SGLCommandTypeState, "glEnable", cap, 0, 0, 0, 0, 0);
+    if (index >= 0) currentRecorder->enabledCaps[index] = YES;
+    FORWARD(enable(cap));
+}
+
+static void __recEnableVertexAttribArray(GLuint index)
+{
+    __record(SGLCommandTypeAttribute, "glEnableVertexAttribArray", 0, index, 0, 0, 0, 0);
+    FORWARD(enableVertexAttribArray(index));
+}
+
+static void __recFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget,
+                                         GLuint renderbuffer)
+{
+    __record(SGLCommandTypeResource, "glFramebufferRenderbuffer", target, attachment, renderbuffer, 0, 0, 0);
+    FORWARD(framebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer));
+}
+
+static void __recFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture,
+                                      GLint level)
+{
+    __record(SGLCommandTypeResource, "glFramebufferTexture2D", target, attachment, texture, level, 0, 0);
+    FORWARD(framebufferTexture2D(target, attachment, textarget, texture, level));
+}
+
+static void __recGenBuffers(GLsizei n, GLuint* buffers)
+{
+    if (FORWARDS) currentRecorder->forwardBackend->genBuffers(n, buffers);
+    else __generateNames(n, buffers);
+    __record(SGLCommandTypeResource, "glGenBuffers", 0, n, n ? buffers[0] : 0, 0, 0, 0);
+}
+
+static void __recGenerateMipmap(GLenum target)
+{
+    __record(SGLCommandTypeResource, "glGenerateMipmap", target, 0, 0, 0, 0, 0);
+    FORWARD(generateMipmap(target));
+}
+
+static void __recGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    if (FORWARDS) currentRecorder->forwardBackend->genFramebuffers(n, framebuffers);
+    else __generateNames(n, framebuffers);
+    __record(SGLCommandTypeResource, "glGenFramebuffers", 0, n, n ? framebuffers[0] : 0, 0, 0, 0);
+}
+
+static void __recGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    if (FORWARDS) currentRecorder->forwardBackend->genRenderbuffers(n, renderbuffers);
+    else __generateNames(n, renderbuffers);
+    __record(SGLCommandTypeResource, "glGenRenderbuffers", 0, n, n ? renderbuffers[0] : 0, 0, 0, 0);
+}
+
+static void __recGenTextures(GLsizei n, GLuint* textures)
+{
+    if (FORWARDS) currentRecorder->forwardBackend->genTextures(n, textures);
+    else __generateNames(n, textures);
+    __record(SGLCommandTypeResource, "glGenTextures", 0, n, n ? textures[0] : 0, 0, 0, 0);
+}
+
+static void __recGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    if (FORWARDS) currentRecorder->forwardBackend->genVertexArrays(n, arrays);
+    else __generateNames(n, arrays);
+    __record(SGLCommandTypeResource, "glGenVertexArrays", 0, n, n ? arrays[0] : 0, 0, 0, 0);
+}
+
+static void __recGetActiveAttrib(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length,
+                                 GLint* size, GLenum* type, GLchar* name)
+{
+    __record(SGLCommandTypeQuery, "glGetActiveAttrib", 0, program, index, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getActiveAttrib(program, index, bufsize, length, size, type, name);
+
+    if (length) *length = 0;
+    if (size) *size = 0;
+    if (type) *type = 0;
+    if (name && bufsize > 0) name[0] = '\0';
+}
+
+static void __recGetActiveUniform(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length,
+                                  GLint* size, GLenum* type, GLchar* name)
+{
+    __record(SGLCommandTypeQuery, "glGetActiveUniform", 0, program, index, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getActiveUniform(program, index, bufsize, length, size, type, name);
+
+    if (length) *length = 0;
+    if (size) *size = 0;
+    if (type) *type = 0;
+    if (name && bufsize > 0) name[0] = '\0';
+}
+
+static GLint __recGetAttribLocation(GLuint program, const GLchar* name)
+{
+    __record(SGLCommandTypeQuery, "glGetAttribLocation", 0, program, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getAttribLocation(program, name);
+    return -1;
+}
+
+static GLenum __recGetError(void)
+{
+    __record(SGLCommandTypeQuery, "glGetError", 0, 0, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getError();
+    return GL_NO_ERROR;
+}
+
+static void __recGetIntegerv(GLenum pname, GLint* params)
+{
+    SGLRecorderRef recorder = currentRecorder;
+    __record(SGLCommandTypeQuery, "glGetIntegerv", pname, 0, 0, 0, 0, 0);
+    if (FORWARDS) return recorder->forwardBackend->getIntegerv(pname, params);
+
+    switch (pname)
+    {
+        case GL_ACTIVE_TEXTURE:                 *params = GL_TEXTURE0 + recorder->textureUnit; return;
+        case GL_ARRAY_BUFFER_BINDING:           *params = recorder->buffer[0]; return;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:   *params = recorder->buffer[1]; return;
+        case GL_CURRENT_PROGRAM:                *params = recorder->program; return;
+        case GL_FRAMEBUFFER_BINDING:            *params = recorder->framebuffer; return;
+        case GL_RENDERBUFFER_BINDING:           *params = recorder->renderbuffer; return;
+        case GL_VERTEX_ARRAY_BINDING_OES:       *params = recorder->vertexArray; return;
+        case GL_PACK_ALIGNMENT:                 *params = recorder->packAlignment; return;
+        case GL_UNPACK_ALIGNMENT:               *params = recorder->unpackAlignment; return;
+        case GL_MAX_TEXTURE_SIZE:               *params = 4096; return;
+        case GL_MAX_RENDERBUFFER_SIZE:          *params = 4096; return;
+        case GL_MAX_TEXTURE_IMAGE_UNITS:        *params = 8; return;
+        case GL_MAX_VERTEX_ATTRIBS:             *params = 16; return;
+
+        case GL_TEXTURE_BINDING_2D:
+            *params = recorder->texture[recorder->textureUnit];
+            return;
+
+        case GL_VIEWPORT:
+            memcpy(params, recorder->viewport, sizeof(GLint) * 4);
+            return;
+
+        case GL_SCISSOR_BOX:
+            memcpy(params, recorder->scissor, sizeof(GLint) * 4);
+            return;
+    }
+
+    int index = __getIndexForCapability(pname);
+    *params = index >= 0 ? recorder->enabledCaps[index] : 0;
+}
+
+static void __recGetProgramInfoLog(GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog)
+{
+    __record(SGLCommandTypeQuery, "glGetProgramInfoLog", 0, program, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getProgramInfoLog(program, bufsize, length, infolog);
+
+    if (length) *length = 0;
+    if (infolog && bufsize > 0) infolog[0] = '\0';
+}
+
+static void __recGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    __record(SGLCommandTypeQuery, "glGetProgramiv", pname, program, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getProgramiv(program, pname, params);
+
+    switch (pname)
+    {
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:    *params = GL_TRUE; return;
+        default:                    *params = 0; return;
+    }
+}
+
+static void __recGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    __record(SGLCommandTypeQuery, "glGetRenderbufferParameteriv", target, pname, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getRenderbufferParameteriv(target, pname, params);
+
+    switch (pname)
+    {
+        case GL_RENDERBUFFER_WIDTH:     *params = currentRecorder->renderbufferSize[0]; return;
+        case GL_RENDERBUFFER_HEIGHT:    *params = currentRecorder->renderbufferSize[1]; return;
+        default:                        *params = 0; return;
+    }
+}
+
+static void __recGetShaderInfoLog(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* infolog)
+{
+    __record(SGLCommandTypeQuery, "glGetShaderInfoLog", 0, shader, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getShaderInfoLog(shader, bufsize, length, infolog);
+
+    if (length) *length = 0;
+    if (infolog && bufsize > 0) infolog[0] = '\0';
+}
+
+static void __recGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    __record(SGLCommandTypeQuery, "glGetShaderiv", pname, shader, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getShaderiv(shader, pname, params);
+
+    switch (pname)
+    {
+        case GL_COMPILE_STATUS:     *params = GL_TRUE; return;
+        default:                    *params = 0; return;
+    }
+}
+
+static const GLubyte* __recGetString(GLenum name)
+{
+    __record(SGLCommandTypeQuery, "glGetString", name, 0, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getString(name);
+
+    switch (name)
+    {
+        case GL_VENDOR:                     return (const GLubyte *)"Gamua";
+        case GL_RENDERER:                   return (const GLubyte *)"Sparrow OpenGL Recorder";
+        case GL_VERSION:                    return (const GLubyte *)"OpenGL ES 2.0";
+        case GL_SHADING_LANGUAGE_VERSION:   return (const GLubyte *)"OpenGL ES GLSL ES 1.00";
+        case GL_EXTENSIONS:                 return (const GLubyte *)
+            "GL_APPLE_framebuffer_multisample GL_EXT_discard_framebuffer GL_EXT_map_buffer_range "
+            "GL_OES_depth24 GL_OES_element_index_uint GL_OES_packed_depth_stencil GL_OES_rgb8_rgba8 "
+            "GL_OES_vertex_array_object GL_OES_vertex_half_float";
+    }
+
+    return NULL;
+}
+
+static GLint __recGetUniformLocation(GLuint program, const GLchar* name)
+{
+    __record(SGLCommandTypeQuery, "glGetUniformLocation", 0, program, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->getUniformLocation(program, name);
+    return -1;
+}
+
+static GLboolean __recIsEnabled(GLenum cap)
+{
+    int index = __getIndexForCapability(cap);
+    __record(SGLCommandTypeQuery, "glIsEnabled", cap, 0, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->isEnabled(cap);
+    return index >= 0 ? currentRecorder->enabledCaps[index] : GL_FALSE;
+}
+
+static void __recLinkProgram(GLuint program)
+{
+    __record(SGLCommandTypeResource, "glLinkProgram", 0, program, 0, 0, 0, 0);
+    FORWARD(linkProgram(program));
+}
+
+static GLvoid* __recMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    SGLRecorderRef recorder = currentRecorder;
+    GLsizeiptr numBytes = (access & GL_MAP_WRITE_BIT_EXT) ? length : 0;
+    __record(SGLCommandTypeUpload, "glMapBufferRange", target, (GLint)offset, access, 0, 0, numBytes);
+    recorder->numBytesUploaded += numBytes;
+    if (FORWARDS) return recorder->forwardBackend->mapBufferRange(target, offset, length, access);
+
+    if (length > recorder->mappedCapacity)
+    {
+        recorder->mappedData = realloc(recorder->mappedData, length);
+        recorder->mappedCapacity = length;
+    }
+
+    return recorder->mappedData;
+}
+
+static void __recPixelStorei(GLenum pname, GLint param)
+{
+    __record(SGLCommandTypeState, "glPixelStorei", pname, param, 0, 0, 0, 0);
+    if (pname == GL_PACK_ALIGNMENT) currentRecorder->packAlignment = param;
+    else if (pname == GL_UNPACK_ALIGNMENT) currentRecorder->unpackAlignment = param;
+    FORWARD(pixelStorei(pname, param));
+}
+
+static void __recReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                            GLvoid* pixels)
+{
+    __record(SGLCommandTypeQuery, "glReadPixels", format, x, y, width, height, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->readPixels(x, y, width, height, format, type, pixels);
+    memset(pixels, 0, width * height * __getBytesPerPixel(format, type));
+}
+
+static void __recRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    __record(SGLCommandTypeResource, "glRenderbufferStorage", target, internalformat, width, height, 0, 0);
+    currentRecorder->renderbufferSize[0] = width;
+    currentRecorder->renderbufferSize[1] = height;
+    FORWARD(renderbufferStorage(target, internalformat, width, height));
+}
+
+static void __recRenderbufferStorageMultisample(GLenum target, GLsizei samples, GLenum internalformat,
+                                                GLsizei width, GLsizei height)
+{
+    __record(SGLCommandTypeResource, "glRenderbufferStorageMultisampleAPPLE", target, internalformat,
+             width, height, samples, 0);
+    currentRecorder->renderbufferSize[0] = width;
+    currentRecorder->renderbufferSize[1] = height;
+    FORWARD(renderbufferStorageMultisample(target, samples, internalformat, width, height));
+}
+
+static void __recScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    SGLRecorderRef recorder = currentRecorder;
+    __record(SGLCommandTypeState, "glScissor", 0, x, y, width, height, 0);
+    recorder->scissor[0] = x;
+    recorder->scissor[1] = y;
+    recorder->scissor[2] = width;
+    recorder->scissor[3] = height;
+    FORWARD(scissor(x, y, width, height));
+}
+
+static void __recShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    __record(SGLCommandTypeResource, "glShaderSource", 0, shader, count, 0, 0, 0);
+    FORWARD(shaderSource(shader, count, string, length));
+}
+
+static void __recStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    __record(SGLCommandTypeState, "glStencilFunc", func, ref, mask, 0, 0, 0);
+    FORWARD(stencilFunc(func, ref, mask));
+}
+
+static void __recStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    __record(SGLCommandTypeState, "glStencilOp", 0, fail, zfail, zpass, 0, 0);
+    FORWARD(stencilOp(fail, zfail, zpass));
+}
+
+static void __recTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                            GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    GLsizeiptr numBytes = pixels ? width * height * __getBytesPerPixel(format, type) : 0;
+    __record(SGLCommandTypeUpload, "glTexImage2D", target, level, width, height, 0, numBytes);
+    currentRecorder->numTextureBytesUploaded += numBytes;
+    FORWARD(texImage2D(target, level, internalformat, width, height, border, format, type, pixels));
+}
+
+static void __recTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    __record(SGLCommandTypeState, "glTexParameterf", target, pname, param, 0, 0, 0);
+    FORWARD(texParameterf(target, pname, param));
+}
+
+static void __recTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    __record(SGLCommandTypeState, "glTexParameteri", target, pname, param, 0, 0, 0);
+    FORWARD(texParameteri(target, pname, param));
+}
+
+static void __recUniform1f(GLint location, GLfloat x)
+{
+    __record(SGLCommandTypeUniform, "glUniform1f", 0, location, 1, 0, 0, 0);
+    FORWARD(uniform1f(location, x));
+}
+
+static void __recUniform1i(GLint location, GLint x)
+{
+    __record(SGLCommandTypeUniform, "glUniform1i", 0, location, 1, x, 0, 0);
+    FORWARD(uniform1i(location, x));
+}
+
+static void __recUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
+{
+    __record(SGLCommandTypeUniform, "glUniform4f", 0, location, 1, 0, 0, 0);
+    FORWARD(uniform4f(location, x, y, z, w));
+}
+
+static void __recUniform4fv(GLint location, GLsizei count, const GLfloat* v)
+{
+    __record(SGLCommandTypeUniform, "glUniform4fv", 0, location, count, 0, 0, 0);
+    FORWARD(uniform4fv(location, count, v));
+}
+
+static void __recUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    __record(SGLCommandTypeUniform, "glUniformMatrix4fv", 0, location, count, 0, 0, 0);
+    FORWARD(uniformMatrix4fv(location, count, transpose, value));
+}
+
+static GLboolean __recUnmapBuffer(GLenum target)
+{
+    __record(SGLCommandTypeUpload, "glUnmapBuffer", target, 0, 0, 0, 0, 0);
+    if (FORWARDS) return currentRecorder->forwardBackend->unmapBuffer(target);
+    return GL_TRUE;
+}
+
+static void __recUseProgram(GLuint program)
+{
+    __record(SGLCommandTypeBind, "glUseProgram", 0, program, 0, 0, 0, 0);
+    currentRecorder->program = program;
+    FORWARD(useProgram(program));
+}
+
+static void __recVertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalized,
+                                     GLsizei stride, const GLvoid* ptr)
+{
+    __record(SGLCommandTypeAttribute, "glVertexAttribPointer", type, indx, size, stride,
+             (GLint)(intptr_t)ptr, 0);
+    FORWARD(vertexAttribPointer(indx, size, type, normalized, stride, ptr));
+}
+
+static void __recViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    SGLRecorderRef recorder = currentRecorder;
+    __record(SGLCommandTypeState, "glViewport", 0, x, y, width, height, 0);
+    recorder->viewport[0] = x;
+    recorder->viewport[1] = y;
+    recorder->viewport[2] = width;
+    recorder->viewport[3] = height;
+    FORWARD(viewport(x, y, width, height));
+}
+
+static const SGLBackend recordingBackend =
+{
+    .activeTexture                  = __recActiveTexture,
+    .attachShader                   = __recAttachShader,
+    .bindBuffer                     = __recBindBuffer,
+    .bindFramebuffer                = __recBindFramebuffer,
+    .bindRenderbuffer               = __recBindRenderbuffer,
+    .bindTexture                    = __recBindTexture,
+    .bindVertexArray                = __recBindVertexArray,
+    .blendFunc                      = __recBlendFunc,
+    .bufferData                     = __recBufferData,
+    .bufferSubData                  = __recBufferSubData,
+    .checkFramebufferStatus         = __recCheckFramebufferStatus,
+    .clear                          = __recClear,
+    .clearColor                     = __recClearColor,
+    .clearDepthf                    = __recClearDepthf,
+    .clearStencil                   = __recClearStencil,
+    .compileShader                  = __recCompileShader,
+    .compressedTexImage2D           = __recCompressedTexImage2D,
+    .createProgram                  = __recCreateProgram,
+    .createShader                   = __recCreateShader,
+    .deleteBuffers                  = __recDeleteBuffers,
+    .deleteFramebuffers             = __recDeleteFramebuffers,
+    .deleteProgram                  = __recDeleteProgram,
+    .deleteRenderbuffers            = __recDeleteRenderbuffers,
+    .deleteShader                   = __recDeleteShader,
+    .deleteTextures                 = __recDeleteTextures,
+    .deleteVertexArrays             = __recDeleteVertexArrays,
+    .depthFunc                      = __recDepthFunc,
+    .depthMask                      = __recDepthMask,
+    .detachShader                   = __recDetachShader,
+    .disable                        = __recDisable,
+    .disableVertexAttribArray       = __recDisableVertexAttribArray,
+    .discardFramebuffer             = __recDiscardFramebuffer,
+    .drawArrays                     = __recDrawArrays,
+    .drawElements                   = __recDrawElements,
+    .enable                         = __recEnable,
+    .enableVertexAttribArray        = __recEnableVertexAttribArray,
+    .framebufferRenderbuffer        = __recFramebufferRenderbuffer,
+    .framebufferTexture2D           = __recFramebufferTexture2D,
+    .genBuffers                     = __recGenBuffers,
+    .generateMipmap                 = __recGenerateMipmap,
+    .genFramebuffers                = __recGenFramebuffers,
+    .genRenderbuffers               = __recGenRenderbuffers,
+    .genTextures                    = __recGenTextures,
+    .genVertexArrays                = __recGenVertexArrays,
+    .getActiveAttrib                = __recGetActiveAttrib,
+    .getActiveUniform               = __recGetActiveUniform,
+    .getAttribLocation              = __recGetAttribLocation,
+    .getError                       = __recGetError,
+    .getIntegerv                    = __recGetIntegerv,
+    .getProgramInfoLog              = __recGetProgramInfoLog,
+    .getProgramiv                   = __recGetProgramiv,
+    .getRenderbufferParameteriv     = __recGetRenderbufferParameteriv,
+    .getShaderInfoLog               = __recGetShaderInfoLog,
+    .getShaderiv                    = __recGetShaderiv,
+    .getString                      = __recGetString,
+    .getUniformLocation             = __recGetUniformLocation,
+    .isEnabled                      = __recIsEnabled,
+    .linkProgram                    = __recLinkProgram,
+    .mapBufferRange                 = __recMapBufferRange,
+    .pixelStorei                    = __recPixelStorei,
+    .readPixels                     = __recReadPixels,
+    .renderbufferStorage            = __recRenderbufferStorage,
+    .renderbufferStorageMultisample = __recRenderbufferStorageMultisample,
+    .scissor                        = __recScissor,
+    .shaderSource                   = __recShaderSource,
+    .stencilFunc                    = __recStencilFunc,
+    .stencilOp                      = __recStencilOp,
+    .texImage2D                     = __recTexImage2D,
+    .texParameterf                  = __recTexParameterf,
+    .texParameteri                  = __recTexParameteri,
+    .uniform1f                      = __recUniform1f,
+    .uniform1i                      = __recUniform1i,
+    .uniform4f                      = __recUniform4f,
+    .uniform4fv                     = __recUniform4fv,
+    .uniformMatrix4fv               = __recUniformMatrix4fv,
+    .unmapBuffer                    = __recUnmapBuffer,
+    .useProgram                     = __recUseProgram,
+    .vertexAttribPointer            = __recVertexAttribPointer,
+    .viewport                       = __recViewport,
+};
+
+/** --------------------------------------------------------------------------------------------- */
+#pragma mark Recorder
+/** --------------------------------------------------------------------------------------------- */
+
+SGLRecorderRef sglRecorderCreate(void)
+{
+    SGLRecorderRef recorder = calloc(1, sizeof(struct SGLRecorder));
+    recorder->nextName = 1;
+    recorder->packAlignment = 4;
+    recorder->unpackAlignment = 4;
+    recorder->enabledCaps[__getIndexForCapability(GL_DITHER)] = YES;
+    return recorder;
+}
+
+void sglRecorderRelease(SGLRecorderRef recorder)
+{
+    if (!recorder) return;
+    if (recorder->recording) sglRecorderEnd(recorder);
+
+    free(recorder->commands);
+    free(recorder->mappedData);
+    free(recorder);
+}
+
+void sglRecorderBegin(SGLRecorderRef recorder)
+{
+  #if !SP_ENABLE_GL_BACKEND
+    NSCAssert(NO, @"recorders need 'SP_ENABLE_GL_BACKEND'; without it, nothing is recorded");
+  #endif
+
+    if (recorder->recording) return;
+
+    recorder->forwardBackend = sglBackendGetCurrent();
+    recorder->previousRecorder = currentRecorder;
+    recorder->recording = YES;
+
+    currentRecorder = recorder;
+    sglBackendSetCurrent(&recordingBackend);
+}
+
+void sglRecorderEnd(SGLRecorderRef recorder)
+{
+    if (!recorder->recording) return;
+
+    // each recorder forwards to (and restores) the backend that was current when it began
+    if (recorder != currentRecorder)
+        [NSException raise:SPExceptionInvalidOperation
+                    format:@"recorders must be ended in the reverse order of 'sglRecorderBegin'"];
+
+    sglBackendSetCurrent(recorder->forwardBackend);
+    currentRecorder = recorder->previousRecorder;
+
+    recorder->forwardBackend = NULL;
+    recorder->previousRecorder = NULL;
+    recorder->recording = NO;
+}
+
+void sglRecorderReset(SGLRecorderRef recorder)
+{
+    recorder->numCommands = 0;
+    recorder->numDrawCalls = 0;
+    recorder->numElementsDrawn = 0;
+    recorder->numBytesUploaded = 0;
+    recorder->numTextureBytesUploaded = 0;
+    recorder->numStateChanges = 0;
+}
+
+BOOL sglRecorderGetForwardsCalls(SGLRecorderRef recorder)
+{
+    return recorder->forwardsCalls;
+}
+
+void sglRecorderSetForwardsCalls(SGLRecorderRef recorder, BOOL forwardsCalls)
+{
+    recorder->forwardsCalls = forwardsCalls;
+}
+
+NSInteger sglRecorderGetNumCommands(SGLRecorderRef recorder)
+{
+    return recorder->numCommands;
+}
+
+const SGLCommand* sglRecorderGetCommandAtIndex(SGLRecorderRef recorder, NSInteger index)
+{
+    if (index < 0 || index >= recorder->numCommands) return NULL;
+    return &recorder->commands[index];
+}
+
+NSInteger sglRecorderGetNumCommandsOfType(SGLRecorderRef recorder, SGLCommandType type)
+{
+    NSInteger count = 0;
+    for (NSInteger i=0; i<recorder->numCommands; ++i)
+        if (recorder->commands[i].type == type) ++count;
+
+    return count;
+}
+
+NSInteger sglRecorderGetNumDrawCalls(SGLRecorderRef recorder)
+{
+    return recorder->numDrawCalls;
+}
+
+NSInteger sglRecorderGetNumElementsDrawn(SGLRecorderRef recorder)
+{
+    return recorder->numElementsDrawn;
+}
+
+NSInteger sglRecorderGetNumBytesUploaded(SGLRecorderRef recorder)
+{
+    return recorder->numBytesUploaded;
+}
+
+NSInteger sglRecorderGetNumTextureBytesUploaded(SGLRecorderRef recorder)
+{
+    return recorder->numTextureBytesUploaded;
+}
+
+NSInteger sglRecorderGetNumStateChanges(SGLRecorderRef recorder)
+{
+    return recorder->numStateChanges;
+}
+
+const char* sglGetCommandTypeString(SGLCommandType type)
+{
+    switch (type)
+    {
+        case SGLCommandTypeDraw:        return "draw";
+        case SGLCommandTypeClear:       return "clear";
+        case SGLCommandTypeUpload:      return "upload";
+        case SGLCommandTypeBind:        return "bind";
+        case SGLCommandTypeState:       return "state";
+        case SGLCommandTypeUniform:     return "uniform";
+        case SGLCommandTypeAttribute:   return "attribute";
+        case SGLCommandTypeResource:    return "resource";
+        case SGLCommandTypeQuery:       return "query";
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,117 @@
+//
+//  SPOverdrawAnalysis.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import <Sparrow/SparrowBase.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class SPDisplayObject;
+@class SPTexture;
+
+/** ------------------------------------------------------------------------------------------------
+
+ Describes how many pixels the quads of one display object covered within a frame.
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPOverdrawRecord : NSObject
+
+/// The object that was drawn; for quads that were batched by a container, this is the quad itself.
+@property (nonatomic, readonly) SPDisplayObject *object;
+
+/// The number of pixels covered by the object, counting pixels it covers several times repeatedly.
+@property (nonatomic, readonly) NSInteger numPixels;
+
+@end
+
+/** ------------------------------------------------------------------------------------------------
+
+ SPOverdrawAnalysis measures how often each pixel is drawn within a frame, to find out where
+ fill-rate is wasted on layers that are hidden behind others.
+
+ Assign an instance to `[SPRenderSupport overdrawAnalysis]` (or the `overdrawAnalysis` of the
+ view controller), and the bounds of every quad the render support draws are accumulated on
+ the CPU, in a grid of the given resolution. That works without an OpenGL context, so it is also
+ available in unit tests. The analysis is reset at the beginning of each frame.
+
+	SPOverdrawAnalysis *analysis = [[SPOverdrawAnalysis alloc] initWithWidth:320 height:480];
+	Sparrow.currentController.overdrawAnalysis = analysis;
+	...
+	NSLog(@"overdraw: %.2f", analysis.overdrawFactor);
+	NSLog(@"worst offenders: %@", [analysis objectsByAreaWithLimit:5]);
+
+ Quads are measured by their bounding boxes, clipped to the screen and the current clip rect;
+ transparent texture regions count as covered, just like on the GPU. Objects that issue their own
+ draw calls (like filter passes), 3D sprites and render textures are not included; neither are
+ canvases and the untextured quads that are batched together with them.
+
+ To see the overdraw, assign a render texture with the size of the stage to `heatTexture`.
+ Each batch is then additionally drawn into that texture, in a gray that gets brighter with each
+ layer. Display the texture only after the frame was rendered (e.g. as a screenshot); drawing it
+ on the stage would make it part of its own analysis.
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPOverdrawAnalysis : NSObject
+
+/// --------------------
+/// @name Initialization
+/// --------------------
+
+/// Initializes an analysis with a grid of the given size in pixels. The grid is stretched across
+/// the visible area, so a smaller grid is faster, but less precise. _Designated Initializer_.
+- (instancetype)initWithWidth:(NSInteger)width height:(NSInteger)height;
+
+/// -------------
+/// @name Methods
+/// -------------
+
+/// Returns how often the pixel at a certain position of the grid was drawn.
+- (NSInteger)depthAtX:(NSInteger)x y:(NSInteger)y;
+
+/// Returns the objects that covered the most pixels, sorted by that area in descending order.
+/// Pass 0 to get all objects.
+- (NSArray<SPOverdrawRecord*> *)objectsByAreaWithLimit:(NSInteger)limit;
+
+/// ----------------
+/// @name Properties
+/// ----------------
+
+/// The width of the grid in pixels.
+@property (nonatomic, readonly) NSInteger width;
+
+/// The height of the grid in pixels.
+@property (nonatomic, readonly) NSInteger height;
+
+/// The number of pixels drawn within the frame, counting pixels that were drawn several times
+/// repeatedly.
+@property (nonatomic, readonly) NSInteger numDrawnPixels;
+
+/// The number of pixels that were drawn at least once.
+@property (nonatomic, readonly) NSInteger numCoveredPixels;
+
+/// The highest number of times a single pixel was drawn.
+@property (nonatomic, readonly) NSInteger maxDepth;
+
+/// The number of drawn pixels per pixel of the grid. A value of 1 means that each pixel was
+/// drawn exactly once on average; UIs typically should stay below 3.
+@property (nonatomic, readonly) float overdrawFactor;
+
+/// A texture (e.g. an SPRenderTexture) into which all batches are drawn additively, or `nil` to
+/// skip that step. The texture is cleared at the beginning of each frame. Default: `nil`.
+@property (nonatomic, strong, nullable) SPTexture *heatTexture;
+
+/// The brightness each layer adds to the heat texture, with 1 being white. Default: 0.1.
+@property (nonatomic, assign) float heatIncrement;
+
+@end
+
+NS_ASSUME_NONNULL_END
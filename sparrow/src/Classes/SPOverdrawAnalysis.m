@@ -0,0 +1,241 @@
+//
+//  SPOverdrawAnalysis.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPDisplayObject.h"
+#import "SPMacros.h"
+#import "SPOverdrawAnalysis.h"
+#import "SPOverdrawAnalysis_Internal.h"
+#import "SPTexture.h"
+
+// --- C functions ---------------------------------------------------------------------------------
+
+static NSInteger pixelIndex(float position, NSInteger size)
+{
+    // a pixel is covered if its center is; NaN ends up as zero
+    return (NSInteger)ceilf(fminf(fmaxf(position, 0.0f), size) - 0.5f);
+}
+
+// --- SPOverdrawRecord ----------------------------------------------------------------------------
+
+@implementation SPOverdrawRecord
+
+- (instancetype)initWithObject:(SPDisplayObject *)object numPixels:(NSInteger)numPixels
+{
+    if ((self = [super init]))
+    {
+        _object = [object retain];
+        _numPixels = numPixels;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_object release];
+    [super dealloc];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"[SPOverdrawRecord: numPixels=%ld, object=%@]",
+            (long)_numPixels, _object];
+}
+
+@end
+
+// --- class implementation ------------------------------------------------------------------------
+
+@implementation SPOverdrawAnalysis
+{
+    NSInteger _width;
+    NSInteger _height;
+    int *_deltas;
+    int *_depths;
+    BOOL _depthsValid;
+    NSInteger _numDrawnPixels;
+    NSInteger _numCoveredPixels;
+    NSInteger _maxDepth;
+    CFMutableDictionaryRef _areas;
+    SPTexture *_heatTexture;
+    float _heatIncrement;
+}
+
+#pragma mark Initialization
+
+- (instancetype)initWithWidth:(NSInteger)width height:(NSInteger)height
+{
+    if ((self = [super init]))
+    {
+        _width  = MAX(1, width);
+        _height = MAX(1, height);
+
+        // Quads are added as a 2D difference array, so that each one costs the same, no matter
+        // how big it is; the actual depths are only summed up when they are needed.
+        _deltas = calloc((_width + 1) * (_height + 1), sizeof(int));
+        _depths = calloc(_width * _height, sizeof(int));
+        _depthsValid = YES;
+
+        _areas = CFDictionaryCreateMutable(NULL, 0, &kCFTypeDictionaryKeyCallBacks, NULL);
+        _heatIncrement = 0.1f;
+    }
+    return self;
+}
+
+- (instancetype)init
+{
+    return [self initWithWidth:320 height:480];
+}
+
+- (void)dealloc
+{
+    free(_deltas);
+    free(_depths);
+    CFRelease(_areas);
+    [_heatTexture release];
+    [super dealloc];
+}
+
+#pragma mark Methods
+
+- (NSInteger)depthAtX:(NSInteger)x y:(NSInteger)y
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+
+    [self updateDepths];
+    return _depths[y * _width + x];
+}
+
+- (NSArray<SPOverdrawRecord*> *)objectsByAreaWithLimit:(NSInteger)limit
+{
+    CFIndex numObjects = CFDictionaryGetCount(_areas);
+    const void **keys = malloc(sizeof(void *) * numObjects);
+    const void **values = malloc(sizeof(void *) * numObjects);
+    CFDictionaryGetKeysAndValues(_areas, keys, values);
+
+    NSMutableArray *records = [NSMutableArray arrayWithCapacity:numObjects];
+    for (CFIndex i=0; i<numObjects; ++i)
+    {
+        SPOverdrawRecord *record = [[SPOverdrawRecord alloc] initWithObject:(SPDisplayObject *)keys[i]
+                                                                  numPixels:(NSInteger)values[i]];
+        [records addObject:record];
+        [record release];
+    }
+
+    free(keys);
+    free(values);
+
+    [records sortUsingComparator:^NSComparisonResult(SPOverdrawRecord *record1, SPOverdrawRecord *record2)
+    {
+        if (record1.numPixels > record2.numPixels) return NSOrderedAscending;
+        else if (record1.numPixels < record2.numPixels) return NSOrderedDescending;
+        else return NSOrderedSame;
+    }];
+
+    if (limit > 0 && records.count > limit)
+        [records removeObjectsInRange:NSMakeRange(limit, records.count - limit)];
+
+    return records;
+}
+
+#pragma mark Properties
+
+- (NSInteger)numCoveredPixels
+{
+    [self updateDepths];
+    return _numCoveredPixels;
+}
+
+- (NSInteger)maxDepth
+{
+    [self updateDepths];
+    return _maxDepth;
+}
+
+- (float)overdrawFactor
+{
+    return (float)_numDrawnPixels / (_width * _height);
+}
+
+- (void)setHeatTexture:(SPTexture *)heatTexture
+{
+    SP_RELEASE_AND_RETAIN(_heatTexture, heatTexture);
+}
+
+#pragma mark Private
+
+- (void)updateDepths
+{
+    if (_depthsValid) return;
+
+    NSInteger stride = _width + 1;
+    NSInteger numCovered = 0;
+    int maxDepth = 0;
+
+    for (NSInteger y=0; y<_height; ++y)
+    {
+        int sum = 0;
+        int *row = _depths + y * _width;
+        int *rowAbove = y ? row - _width : NULL;
+
+        for (NSInteger x=0; x<_width; ++x)
+        {
+            sum += _deltas[y * stride + x];
+            int depth = rowAbove ? rowAbove[x] + sum : sum;
+            row[x] = depth;
+
+            if (depth) ++numCovered;
+            if (depth > maxDepth) maxDepth = depth;
+        }
+    }
+
+    _numCoveredPixels = numCovered;
+    _maxDepth = maxDepth;
+    _depthsValid = YES;
+}
+
+@end
+
+@implementation SPOverdrawAnalysis (Internal)
+
+- (void)reset
+{
+    memset(_deltas, 0, sizeof(int) * (_width + 1) * (_height + 1));
+    memset(_depths, 0, sizeof(int) * _width * _height);
+    CFDictionaryRemoveAllValues(_areas);
+
+    _numDrawnPixels = _numCoveredPixels = _maxDepth = 0;
+    _depthsValid = YES;
+}
+
+- (void)addBounds:(SPQuadBatchBounds)bounds ofObject:(SPDisplayObject *)object
+{
+    NSInteger minX = pixelIndex((bounds.minX * 0.5f + 0.5f) * _width,  _width);
+    NSInteger maxX = pixelIndex((bounds.maxX * 0.5f + 0.5f) * _width,  _width);
+    NSInteger minY = pixelIndex((0.5f - bounds.maxY * 0.5f) * _height, _height);
+    NSInteger maxY = pixelIndex((0.5f - bounds.minY * 0.5f) * _height, _height);
+
+    if (maxX <= minX || maxY <= minY) return;
+
+    NSInteger stride = _width + 1;
+    _deltas[minY * stride + minX] += 1;
+    _deltas[minY * stride + maxX] -= 1;
+    _deltas[maxY * stride + minX] -= 1;
+    _deltas[maxY * stride + maxX] += 1;
+    _depthsValid = NO;
+
+    NSInteger numPixels = (maxX - minX) * (maxY - minY);
+    NSInteger area = (NSInteger)CFDictionaryGetValue(_areas, object);
+    CFDictionarySetValue(_areas, object, (const void *)(area + numPixels));
+
+    _numDrawnPixels += numPixels;
+}
+
+@end
@@ -0,0 +1,24 @@
+//
+//  SPOverdrawAnalysis_Internal.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPOverdrawAnalysis.h"
+#import "SPQuadBatch_Internal.h"
+
+@interface SPOverdrawAnalysis (Internal)
+
+/// Removes all coverage; called at the beginning of each frame.
+- (void)reset;
+
+/// Adds the area of a quad to the coverage. The bounds are in normalized device coordinates,
+/// i.e. the visible area is [-1, 1] on both axes, with 'y' pointing upwards.
+- (void)addBounds:(SPQuadBatchBounds)bounds ofObject:(SPDisplayObject *)object;
+
+@end
@@ -10,6 +10,7 @@
 //
 
 #import <Sparrow/SparrowBase.h>
+#import <Sparrow/SPGeometryValues.h>
 #import <Sparrow/SPPoolObject.h>
 
 NS_ASSUME_NONNULL_BEGIN
@@ -42,6 +43,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// Factory method.
 + (instancetype)point;
 
+/// Factory method.
++ (instancetype)pointWithValue:(SPPointValue)value;
+
 /// -------------
 /// @name Methods
 // --------------
@@ -104,6 +108,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// The y-Coordinate of the point.
 @property (nonatomic, assign) float y;
 
+/// The point as a value type.
+@property (nonatomic, assign) SPPointValue pointValue;
+
 /// The distance to the origin (or the length of the vector).
 @property (readonly) float length;
 
@@ -53,6 +53,11 @@
     return [[[self alloc] init] autorelease];
 }
 
++ (instancetype)pointWithValue:(SPPointValue)value
+{
+    return [[[self alloc] initWithX:value.x y:value.y] autorelease];
+}
+
 #pragma mark Methods
 
 - (SPPoint *)addPoint:(SPPoint *)point
@@ -196,6 +201,17 @@
 
 #pragma mark Properties
 
+- (SPPointValue)pointValue
+{
+    return SPPointValueMake(_x, _y);
+}
+
+- (void)setPointValue:(SPPointValue)value
+{
+    _x = value.x;
+    _y = value.y;
+}
+
 - (float)length
 {
     return sqrtf(SPSquare(_x) + SPSquare(_y));
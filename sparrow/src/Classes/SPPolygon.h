@@ -20,6 +20,7 @@ NS_ASSUME_NONNULL_BEGIN
 /** ------------------------------------------------------------------------------------------------
 
  A polygon describes a closed two-dimensional shape bounded by a number of straight line segments.
+ It may contain holes, which are described the same way.
  
  The vertices of a polygon form a closed path (i.e. the last vertex will be connected to the first). 
  It is recommended to provide the vertices in clockwise order. Self-intersecting paths are not 
@@ -54,9 +55,17 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)reverse;
 
 /// Adds vertices to the polygon. Pass either a list of 'Point' instances or alternating
-/// 'x' and 'y' coordinates.
+/// 'x' and 'y' coordinates. If the polygon has holes, the vertices are added to the last one.
 - (void)addVertices:(GLKVector2 *)vertices count:(NSInteger)count;
 
+/// Adds a hole, i.e. a closed path inside the polygon that is cut out of it. Its vertices are
+/// appended to those of the polygon, so that the indices returned by 'triangulate:' can refer
+/// to them. Holes must not intersect each other or the polygon's outline.
+- (void)addHoleWithVertices:(GLKVector2 *)vertices count:(NSInteger)count;
+
+/// Adds the vertices of another polygon as a hole.
+- (void)addHole:(SPPolygon *)hole;
+
 /// Moves a given vertex to a certain position or adds a new vertex at the end.
 - (void)setVertexWithX:(float)x y:(float)y atIndex:(NSInteger)index;
 
@@ -71,7 +80,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 /// Calculates a possible representation of the polygon via triangles. The resulting vector
 /// contains a list of vertex indices, where every three indices describe a triangle referencing
-/// the vertices of the polygon.
+/// the vertices of the polygon (including those of its holes). The indices are appended to
+/// 'result', if it is not nil.
+///
+/// @note The polygon is split into monotone pieces by a sweep line, which takes
+/// <code>O(n log n)</code> time; the vertices may be given in either order.
 - (SPIndexData *)triangulate:(nullable SPIndexData *)result;
 
 /// Copies all vertices to a 'VertexData' instance, beginning at a certain target index.
@@ -90,17 +103,21 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) BOOL isSimple;
 
 /// Indicates if the polygon is convex. In a convex polygon, the vector between any two points
-/// inside the polygon lies inside it, as well.
+/// inside the polygon lies inside it, as well. Polygons with holes are never convex.
 @property (nonatomic, readonly) BOOL isConvex;
 
-/// Calculates the total area of the polygon.
+/// Calculates the total area of the polygon, minus the area of its holes.
 @property (nonatomic, readonly) float area;
 
-/// Returns the total number of vertices spawning up the polygon. Assigning a value that's smaller
-/// than the current number of vertices will crop the path; a bigger value will fill up the path
-/// with zeros.
+/// Returns the total number of vertices spawning up the polygon, including those of its holes.
+/// Assigning a value that's smaller than the current number of vertices will crop the path; a
+/// bigger value will fill up the path with zeros. Holes that would be left with fewer than three
+/// vertices are removed completely, so the result may have fewer vertices than assigned.
 @property (nonatomic, assign) NSInteger numVertices;
 
+/// The number of holes that were added to the polygon.
+@property (nonatomic, readonly) NSInteger numHoles;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -13,6 +13,7 @@
 #import "SPMacros.h"
 #import "SPPoint.h"
 #import "SPPolygon.h"
+#import "SPPolygon_Internal.h"
 #import "SPVertexData.h"
 
 /// --- immutable polygon interfaces ---------------------------------------------------------------
@@ -28,6 +29,439 @@
 - (instancetype)initWithX:(float)x y:(float)y width:(float)width height:(float)height;
 @end
 
+/// --- triangulation ------------------------------------------------------------------------------
+
+// Polygons are triangulated in two steps, as described in "Computational Geometry" (de Berg et
+// al., chapter 3): a sweep line from top to bottom adds diagonals that split the polygon into
+// y-monotone pieces, and each of those is triangulated in linear time. Holes are handled by the
+// same sweep. Sorting the vertices dominates, so this is O(n log n), apart from updating the list
+// of edges crossing the sweep line, which only grows large for very jagged shapes.
+
+enum
+{
+    VertexTypeStart,
+    VertexTypeEnd,
+    VertexTypeSplit,
+    VertexTypeMerge,
+    VertexTypeRegular,
+};
+
+typedef struct
+{
+    float x;
+    float y;
+    int index;
+} SPSweepEntry;
+
+typedef struct
+{
+    int point;
+    int prev;
+    int next;
+} SPMonotoneNode;
+
+typedef struct
+{
+    const GLKVector2 *vertices;
+    SPMonotoneNode *nodes;  // one per vertex, plus two per diagonal (see 'addDiagonal')
+    int numNodes;
+    int *rank;              // position of each vertex in sweep order
+    int *helpers;           // the 'helper' of each edge, stored at the node the edge starts at;
+                            // -1 for edges that never crossed the sweep line
+    uchar *types;
+    int *status;            // the edges crossing the sweep line, from left to right
+    int numStatus;
+} SPTriangulator;
+
+static int compareSweepEntries(const void *a, const void *b)
+{
+    const SPSweepEntry *ea = (const SPSweepEntry *)a;
+    const SPSweepEntry *eb = (const SPSweepEntry *)b;
+
+    if (ea->y != eb->y) return ea->y > eb->y ? -1 : 1;
+    if (ea->x != eb->x) return ea->x < eb->x ? -1 : 1;
+    return ea->index - eb->index;
+}
+
+SP_INLINE float turnOfVertices(GLKVector2 p, GLKVector2 v, GLKVector2 n)
+{
+    // positive for a left turn (y pointing up)
+    return (v.x - p.x) * (n.y - v.y) - (v.y - p.y) * (n.x - v.x);
+}
+
+static float edgeXAtY(SPTriangulator *t, int edge, float y)
+{
+    GLKVector2 a = t->vertices[t->nodes[edge].point];
+    GLKVector2 b = t->vertices[t->nodes[t->nodes[edge].next].point];
+
+    if (a.y == b.y) return a.x;
+    else return a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+}
+
+static int statusSlotLeftOf(SPTriangulator *t, GLKVector2 point)
+{
+    // binary search for the last edge whose intersection with the sweep line is left of 'point'
+    int lo = 0, hi = t->numStatus;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (edgeXAtY(t, t->status[mid], point.y) <= point.x) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo - 1;
+}
+
+static void insertStatusEdge(SPTriangulator *t, int edge, GLKVector2 point)
+{
+    int slot = statusSlotLeftOf(t, point) + 1;
+    memmove(t->status + slot + 1, t->status + slot, sizeof(int) * (t->numStatus - slot));
+    t->status[slot] = edge;
+    t->numStatus++;
+}
+
+static void removeStatusEdge(SPTriangulator *t, int edge)
+{
+    for (int i=0; i<t->numStatus; ++i)
+    {
+        if (t->status[i] == edge)
+        {
+            memmove(t->status + i, t->status + i + 1, sizeof(int) * (t->numStatus - i - 1));
+            t->numStatus--;
+            return;
+        }
+    }
+}
+
+static void replaceStatusEdge(SPTriangulator *t, int edge, int newEdge)
+{
+    for (int i=0; i<t->numStatus; ++i)
+        if (t->status[i] == edge) t->status[i] = newEdge;
+}
+
+static int addDiagonal(SPTriangulator *t, int a, int b)
+{
+    // Both nodes are duplicated, so that the loop of nodes is split into two. The copies take
+    // over the edges that started at the original nodes; the copy of 'a' is returned.
+
+    SPMonotoneNode *nodes = t->nodes;
+    int na = t->numNodes++;
+    int nb = t->numNodes++;
+
+    nodes[na].point = nodes[a].point;
+    nodes[nb].point = nodes[b].point;
+    nodes[na].next = nodes[a].next;
+    nodes[nb].next = nodes[b].next;
+    nodes[nodes[a].next].prev = na;
+    nodes[nodes[b].next].prev = nb;
+    nodes[a].next = nb;
+    nodes[nb].prev = a;
+    nodes[b].next = na;
+    nodes[na].prev = b;
+
+    t->types[na] = t->types[a];
+    t->types[nb] = t->types[b];
+    t->helpers[na] = t->helpers[a];
+    t->helpers[nb] = t->helpers[b];
+    replaceStatusEdge(t, a, na);
+    replaceStatusEdge(t, b, nb);
+
+    return na;
+}
+
+SP_INLINE BOOL hasMergeHelper(SPTriangulator *t, int edge)
+{
+    // degenerate input may reach edges that were never inserted, and thus have no helper
+    int helper = t->helpers[edge];
+    return helper != -1 && t->types[helper] == VertexTypeMerge;
+}
+
+static void connectToMergeHelper(SPTriangulator *t, int node, int edge)
+{
+    if (hasMergeHelper(t, edge)) addDiagonal(t, node, t->helpers[edge]);
+}
+
+static void partitionIntoMonotonePieces(SPTriangulator *t, const SPSweepEntry *order, int numVertices)
+{
+    SPMonotoneNode *nodes = t->nodes;
+    const int *rank = t->rank;
+
+    for (int j=0; j<numVertices; ++j)
+    {
+        int i = order[j].index;
+        GLKVector2 p = t->vertices[nodes[nodes[i].prev].point];
+        GLKVector2 v = t->vertices[i];
+        GLKVector2 n = t->vertices[nodes[nodes[i].next].point];
+        BOOL prevBelow = rank[nodes[nodes[i].prev].point] > rank[i];
+        BOOL nextBelow = rank[nodes[nodes[i].next].point] > rank[i];
+        BOOL convex = turnOfVertices(p, v, n) > 0.0f;
+
+        if (prevBelow && nextBelow)        t->types[i] = convex ? VertexTypeStart : VertexTypeSplit;
+        else if (!prevBelow && !nextBelow) t->types[i] = convex ? VertexTypeEnd : VertexTypeMerge;
+        else                               t->types[i] = VertexTypeRegular;
+    }
+
+    // Edges are stored at the node they start at. Adding a diagonal moves them to a copy of that
+    // node, which is why they are looked up again (via 'prev' or the status) after each diagonal.
+
+    for (int i=0; i<numVertices; ++i)
+    {
+        int v = order[i].index;
+        GLKVector2 point = t->vertices[v];
+        int slot, w;
+
+        switch (t->types[v])
+        {
+            case VertexTypeStart:
+                insertStatusEdge(t, v, point);
+                t->helpers[v] = v;
+                break;
+
+            case VertexTypeEnd:
+                connectToMergeHelper(t, v, nodes[v].prev);
+                removeStatusEdge(t, nodes[v].prev);
+                break;
+
+            case VertexTypeSplit:
+                slot = statusSlotLeftOf(t, point);
+                if (slot < 0 || t->helpers[t->status[slot]] == -1) break;
+                w = addDiagonal(t, v, t->helpers[t->status[slot]]);
+                t->helpers[t->status[slot]] = v;
+                insertStatusEdge(t, w, point);
+                t->helpers[w] = w;
+                break;
+
+            case VertexTypeMerge:
+                w = v;
+                if (hasMergeHelper(t, nodes[v].prev))
+                    w = addDiagonal(t, v, t->helpers[nodes[v].prev]);
+                removeStatusEdge(t, nodes[v].prev);
+                slot = statusSlotLeftOf(t, point);
+                if (slot < 0) break;
+                connectToMergeHelper(t, w, t->status[slot]);
+                t->helpers[t->status[slot]] = w;
+                break;
+
+            default:
+                if (rank[nodes[nodes[v].prev].point] < rank[v])
+                {
+                    // the polygon's interior lies to the right of the vertex
+                    w = v;
+                    if (hasMergeHelper(t, nodes[v].prev))
+                        w = addDiagonal(t, v, t->helpers[nodes[v].prev]);
+                    removeStatusEdge(t, nodes[v].prev);
+                    insertStatusEdge(t, w, point);
+                    t->helpers[w] = w;
+                }
+                else
+                {
+                    slot = statusSlotLeftOf(t, point);
+                    if (slot < 0) break;
+                    connectToMergeHelper(t, v, t->status[slot]);
+                    t->helpers[t->status[slot]] = v;
+                }
+                break;
+        }
+    }
+}
+
+static int triangulateMonotonePiece(SPTriangulator *t, int top, int *sorted, uchar *onLeftChain,
+                                    int *stack, ushort *indices)
+{
+    // Following 'next' from the topmost vertex leads down the left chain, following 'prev' down
+    // the right one; merging both yields the vertices in sweep order.
+
+    const SPMonotoneNode *nodes = t->nodes;
+    const GLKVector2 *vertices = t->vertices;
+    const int *rank = t->rank;
+    int left = nodes[top].next;
+    int right = nodes[top].prev;
+    int numSorted = 0;
+    int numIndices = 0;
+
+    sorted[numSorted] = nodes[top].point;
+    onLeftChain[numSorted++] = YES;
+
+    while (left != right)
+    {
+        if (rank[nodes[left].point] < rank[nodes[right].point])
+        {
+            sorted[numSorted] = nodes[left].point;
+            onLeftChain[numSorted++] = YES;
+            left = nodes[left].next;
+        }
+        else
+        {
+            sorted[numSorted] = nodes[right].point;
+            onLeftChain[numSorted++] = NO;
+            right = nodes[right].prev;
+        }
+    }
+
+    sorted[numSorted] = nodes[left].point;
+    onLeftChain[numSorted++] = NO;
+
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    stack[stackSize++] = 1;
+
+    for (int j=2; j<numSorted-1; ++j)
+    {
+        int u = sorted[j];
+
+        if (onLeftChain[j] != onLeftChain[stack[stackSize-1]])
+        {
+            // all vertices on the stack are visible from the opposite chain
+            for (int i=0; i<stackSize-1; ++i)
+            {
+                indices[numIndices++] = u;
+                indices[numIndices++] = sorted[stack[i]];
+                indices[numIndices++] = sorted[stack[i+1]];
+            }
+
+            stack[0] = j - 1;
+            stack[1] = j;
+            stackSize = 2;
+        }
+        else
+        {
+            int last = stack[--stackSize];
+
+            while (stackSize > 0)
+            {
+                GLKVector2 a = vertices[sorted[stack[stackSize-1]]];
+                GLKVector2 b = vertices[sorted[last]];
+                GLKVector2 c = vertices[u];
+                float turn = onLeftChain[j] ? turnOfVertices(a, b, c) : turnOfVertices(c, b, a);
+
+                if (turn <= 0.0f) break;
+
+                indices[numIndices++] = u;
+                indices[numIndices++] = sorted[last];
+                indices[numIndices++] = sorted[stack[stackSize-1]];
+                last = stack[--stackSize];
+            }
+
+            stack[stackSize++] = last;
+            stack[stackSize++] = j;
+        }
+    }
+
+    int bottom = sorted[numSorted-1];
+    for (int i=0; i<stackSize-1; ++i)
+    {
+        indices[numIndices++] = bottom;
+        indices[numIndices++] = sorted[stack[i]];
+        indices[numIndices++] = sorted[stack[i+1]];
+    }
+
+    return numIndices;
+}
+
+static void triangulatePolygon(const GLKVector2 *vertices, int numVertices, const NSInteger *holeIndices,
+                               int numHoles, SPIndexData *result)
+{
+    // all temporary data lives in a single block of memory
+
+    int maxNumNodes = numVertices * 3;
+    size_t size = sizeof(SPSweepEntry) * numVertices + sizeof(SPMonotoneNode) * maxNumNodes +
+                  sizeof(int) * (numVertices + maxNumNodes * 4) + sizeof(ushort) * maxNumNodes * 3 +
+                  sizeof(uchar) * maxNumNodes * 3;
+    char *memory = malloc(size);
+
+    SPTriangulator t = { .vertices = vertices };
+    SPSweepEntry *order = (SPSweepEntry *)memory;
+    t.nodes   = (SPMonotoneNode *)(order + numVertices);
+    t.rank    = (int *)(t.nodes + maxNumNodes);
+    t.helpers = t.rank + numVertices;
+    t.status  = t.helpers + maxNumNodes;
+    int *sorted = t.status + maxNumNodes;
+    int *stack  = sorted + maxNumNodes;
+    ushort *indices = (ushort *)(stack + maxNumNodes);
+    t.types = (uchar *)(indices + maxNumNodes * 3);
+    uchar *visited = t.types + maxNumNodes;
+    uchar *onLeftChain = visited + maxNumNodes;
+
+    // the outline is linked counter-clockwise (y pointing up), holes clockwise, so that the
+    // polygon's interior is always left of an edge
+
+    int numSweepVertices = 0;
+    memset(t.helpers, 0xff, sizeof(int) * maxNumNodes);
+
+    for (int c=0; c<=numHoles; ++c)
+    {
+        int start = c ? (int)holeIndices[c-1] : 0;
+        int end = c < numHoles ? (int)holeIndices[c] : numVertices;
+        float area = 0.0f;
+
+        if (end - start < 3)
+        {
+            // contours without an area are left out; their nodes form loops of their own
+            for (int i=start; i<end; ++i)
+            {
+                t.nodes[i] = (SPMonotoneNode){ i, i, i };
+                t.rank[i] = -1;
+            }
+
+            continue;
+        }
+
+        for (int i=start, j=end-1; i<end; j=i++)
+            area += vertices[j].x * vertices[i].y - vertices[i].x * vertices[j].y;
+
+        BOOL reversed = (c == 0) != (area > 0.0f);
+
+        for (int i=start; i<end; ++i)
+        {
+            int prev = i == start ? end - 1 : i - 1;
+            int next = i == end - 1 ? start : i + 1;
+
+            t.nodes[i].point = i;
+            t.nodes[i].prev = reversed ? next : prev;
+            t.nodes[i].next = reversed ? prev : next;
+            order[numSweepVertices++] = (SPSweepEntry){ vertices[i].x, vertices[i].y, i };
+        }
+    }
+
+    qsort(order, numSweepVertices, sizeof(SPSweepEntry), compareSweepEntries);
+
+    for (int i=0; i<numSweepVertices; ++i)
+        t.rank[order[i].index] = i;
+
+    t.numNodes = numVertices;
+    partitionIntoMonotonePieces(&t, order, numSweepVertices);
+
+    // every loop of nodes is now a monotone piece with 'n' vertices, yielding 'n - 2' triangles
+
+    int numIndices = 0;
+    memset(visited, 0, t.numNodes);
+
+    for (int i=0; i<t.numNodes; ++i)
+    {
+        if (visited[i]) continue;
+
+        int top = i, numNodes = 0, node = i;
+        do
+        {
+            visited[node] = YES;
+            if (t.rank[t.nodes[node].point] < t.rank[t.nodes[top].point]) top = node;
+            node = t.nodes[node].next;
+            ++numNodes;
+        }
+        while (node != i);
+
+        if (numNodes >= 3)
+            numIndices += triangulateMonotonePiece(&t, top, sorted, onLeftChain, stack, indices + numIndices);
+    }
+
+    NSInteger oldNumIndices = result.numIndices;
+    result.numIndices = oldNumIndices + numIndices;
+    memcpy(result.indices + oldNumIndices, indices, sizeof(ushort) * numIndices);
+
+    free(memory);
+}
+
 /// --- class implementation -----------------------------------------------------------------------
 
 @implementation SPPolygon
@@ -35,6 +469,8 @@
   @package
     GLKVector2 *_vertices;
     NSInteger _numVertices;
+    NSInteger *_holeIndices;
+    NSInteger _numHoles;
 }
 
 // --- c functions ---
@@ -47,32 +483,12 @@ SP_INLINE BOOL isConvexTriangle(float ax, float ay,
     return (ay - by) * (cx - bx) + (bx - ax) * (cy - by) >= 0;
 }
 
-static BOOL isPointInTriangle(float px, float py,
-                              float ax, float ay,
-                              float bx, float by,
-                              float cx, float cy)
+SP_INLINE void getContour(NSInteger contour, const NSInteger *holeIndices, NSInteger numHoles,
+                          NSInteger numVertices, NSInteger *start, NSInteger *end)
 {
-    // This algorithm is described well in this article:
-    // http://www.blackpawn.com/texts/pointinpoly/default.html
-
-    float v0x = cx - ax;
-    float v0y = cy - ay;
-    float v1x = bx - ax;
-    float v1y = by - ay;
-    float v2x = px - ax;
-    float v2y = py - ay;
-
-    float dot00 = v0x * v0x + v0y * v0y;
-    float dot01 = v0x * v1x + v0y * v1y;
-    float dot02 = v0x * v2x + v0y * v2y;
-    float dot11 = v1x * v1x + v1y * v1y;
-    float dot12 = v1x * v2x + v1y * v2y;
-
-    float invDen = 1.0 / (dot00 * dot11 - dot01 * dot01);
-    float u = (dot11 * dot02 - dot01 * dot12) * invDen;
-    float v = (dot00 * dot12 - dot01 * dot02) * invDen;
-
-    return (u >= 0) && (v >= 0) && (u + v < 1);
+    // contour 0 is the outline, the others are the holes
+    *start = contour ? holeIndices[contour-1] : 0;
+    *end = contour < numHoles ? holeIndices[contour] : numVertices;
 }
 
 static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
@@ -121,6 +537,7 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 - (void)dealloc
 {
     free(_vertices);
+    free(_holeIndices);
     [super dealloc];
 }
 
@@ -143,11 +560,17 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 
 - (void)reverse
 {
-    for (NSInteger i=0; i<_numVertices; ++i)
+    for (NSInteger c=0; c<=_numHoles; ++c)
     {
-        GLKVector2 tmp = _vertices[i];
-        _vertices[i] = _vertices[_numVertices - i];
-        _vertices[_numVertices - i] = tmp;
+        NSInteger start, end;
+        getContour(c, _holeIndices, _numHoles, _numVertices, &start, &end);
+
+        for (NSInteger i=start, j=end-1; i<j; ++i, --j)
+        {
+            GLKVector2 tmp = _vertices[i];
+            _vertices[i] = _vertices[j];
+            _vertices[j] = tmp;
+        }
     }
 }
 
@@ -161,6 +584,21 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
     memcpy(_vertices + numVertices, vertices, sizeof(GLKVector2) * count);
 }
 
+- (void)addHoleWithVertices:(GLKVector2 *)vertices count:(NSInteger)count
+{
+    if (!vertices || count < 3) return;
+
+    _holeIndices = realloc(_holeIndices, sizeof(NSInteger) * (_numHoles + 1));
+    _holeIndices[_numHoles++] = _numVertices;
+
+    [self addVertices:vertices count:count];
+}
+
+- (void)addHole:(SPPolygon *)hole
+{
+    [self addHoleWithVertices:hole->_vertices count:hole->_numVertices];
+}
+
 - (void)setVertexWithX:(float)x y:(float)y atIndex:(NSInteger)index
 {
     if (index < 0 && index > _numVertices)
@@ -183,20 +621,29 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 {
     // Algorithm & implementation thankfully taken from:
     // -> http://alienryderflex.com/polygon/
+    //
+    // The edges of holes are crossed just like those of the outline, so points inside a hole
+    // end up with an even number of nodes.
 
     uint oddNodes = 0;
 
-    for (NSInteger i=0, j=_numVertices-1; i<_numVertices; ++i)
+    for (NSInteger c=0; c<=_numHoles; ++c)
     {
-        float ix = _vertices[i].x;
-        float iy = _vertices[i].y;
-        float jx = _vertices[j].x;
-        float jy = _vertices[j].y;
+        NSInteger start, end;
+        getContour(c, _holeIndices, _numHoles, _numVertices, &start, &end);
+
+        for (NSInteger i=start, j=end-1; i<end; ++i)
+        {
+            float ix = _vertices[i].x;
+            float iy = _vertices[i].y;
+            float jx = _vertices[j].x;
+            float jy = _vertices[j].y;
 
-        if (((iy < y && jy >= y) || (jy < y && iy >= y)) && (ix <= x || jx <= x))
-            oddNodes ^= (uint)(ix + (y - iy) / (jy - iy) * (jx - ix) < x);
+            if (((iy < y && jy >= y) || (jy < y && iy >= y)) && (ix <= x || jx <= x))
+                oddNodes ^= (uint)(ix + (y - iy) / (jy - iy) * (jx - ix) < x);
 
-        j = i;
+            j = i;
+        }
     }
 
     return oddNodes != 0;
@@ -209,75 +656,10 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 
 - (SPIndexData *)triangulate:(SPIndexData *)result
 {
-    // Algorithm "Ear clipping method" described here:
-    // -> https://en.wikipedia.org/wiki/Polygon_triangulation
-    //
-    // Implementation inspired by:
-    // -> http://polyk.ivank.net
-
     if (result == nil) result = [[[SPIndexData alloc] init] autorelease];
     if (_numVertices < 3) return result;
 
-    ushort restIndices[_numVertices];
-    for (int i=0; i<_numVertices; ++i)
-        restIndices[i] = i;
-
-    int restIndexPos = 0;
-    int numRestIndices = (int)_numVertices;
-
-    while (numRestIndices > 3)
-    {
-        // In each step, we look at 3 subsequent vertices. If those vertices spawn up
-        // a triangle that is convex and does not contain any other vertices, it is an 'ear'.
-        // We remove those ears until only one remains -> each ear is one of our wanted
-        // triangles.
-
-        int i0 = restIndices[ restIndexPos      % numRestIndices];
-        int i1 = restIndices[(restIndexPos + 1) % numRestIndices];
-        int i2 = restIndices[(restIndexPos + 2) % numRestIndices];
-
-        float ax = _vertices[i0].x;
-        float ay = _vertices[i0].y;
-        float bx = _vertices[i1].x;
-        float by = _vertices[i1].y;
-        float cx = _vertices[i2].x;
-        float cy = _vertices[i2].y;
-        BOOL earFound = false;
-
-        if (isConvexTriangle(ax, ay, bx, by, cx, cy))
-        {
-            earFound = true;
-            for (NSInteger i=3; i<numRestIndices; ++i)
-            {
-                NSInteger otherIndex = restIndices[(restIndexPos + i) % numRestIndices];
-                if (isPointInTriangle(_vertices[otherIndex].x, _vertices[otherIndex].y,
-                                      ax, ay, bx, by, cx, cy))
-                {
-                    earFound = false;
-                    break;
-                }
-            }
-        }
-
-        if (earFound)
-        {
-            [result appendTriangleWithA:i0 b:i1 c:i2];
-            
-            // shift rest indices
-            for (int i=(restIndexPos + 1) % numRestIndices; i<numRestIndices-1; ++i)
-                restIndices[i] = restIndices[i+1];
-
-            numRestIndices--;
-            restIndexPos = 0;
-        }
-        else
-        {
-            restIndexPos++;
-            if (restIndexPos == numRestIndices) break; // no more ears
-        }
-    }
-
-    [result appendTriangleWithA:restIndices[0] b:restIndices[1] c:restIndices[2]];
+    triangulatePolygon(_vertices, (int)_numVertices, _holeIndices, (int)_numHoles, result);
     return result;
 }
 
@@ -327,7 +709,16 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 
 - (id)copy
 {
-    return [[[self class] alloc] initWithVertices:_vertices count:_numVertices];;
+    SPPolygon *copy = [[[self class] alloc] initWithVertices:_vertices count:_numVertices];
+
+    if (_numHoles)
+    {
+        copy->_holeIndices = malloc(sizeof(NSInteger) * _numHoles);
+        copy->_numHoles = _numHoles;
+        memcpy(copy->_holeIndices, _holeIndices, sizeof(NSInteger) * _numHoles);
+    }
+
+    return copy;
 }
 
 - (id)copyWithZone:(NSZone *)zone
@@ -341,23 +732,40 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 {
     if (_numVertices <= 3) return true;
 
-    for (int i=0; i<_numVertices; ++i)
+    // every edge is compared with all edges that don't share a vertex with it, including those
+    // of the other contours
+
+    for (NSInteger c=0; c<=_numHoles; ++c)
     {
-        float ax = _vertices[ i ].x;
-        float ay = _vertices[ i ].y;
-        float bx = _vertices[(i + 1) % _numVertices].x;
-        float by = _vertices[(i + 1) % _numVertices].y;
-        float endJ = i + _numVertices;
+        NSInteger start, end;
+        getContour(c, _holeIndices, _numHoles, _numVertices, &start, &end);
 
-        for (int j=i+2; j<endJ; ++j)
+        for (NSInteger i=start; i<end; ++i)
         {
-            float cx = _vertices[ j      % _numVertices].x;
-            float cy = _vertices[ j      % _numVertices].y;
-            float dx = _vertices[(j + 1) % _numVertices].x;
-            float dy = _vertices[(j + 1) % _numVertices].y;
+            float ax = _vertices[i].x;
+            float ay = _vertices[i].y;
+            float bx = _vertices[i == end-1 ? start : i+1].x;
+            float by = _vertices[i == end-1 ? start : i+1].y;
 
-            if (areVectorsIntersecting(ax, ay, bx, by, cx, cy, dx, dy))
-                return false;
+            for (NSInteger d=c; d<=_numHoles; ++d)
+            {
+                NSInteger otherStart, otherEnd;
+                getContour(d, _holeIndices, _numHoles, _numVertices, &otherStart, &otherEnd);
+
+                for (NSInteger j=(d == c ? i+2 : otherStart); j<otherEnd; ++j)
+                {
+                    NSInteger k = j == otherEnd-1 ? otherStart : j+1;
+                    if (k == i) continue; // shares vertex 'i'
+
+                    float cx = _vertices[j].x;
+                    float cy = _vertices[j].y;
+                    float dx = _vertices[k].x;
+                    float dy = _vertices[k].y;
+
+                    if (areVectorsIntersecting(ax, ay, bx, by, cx, cy, dx, dy))
+                        return false;
+                }
+            }
         }
     }
 
@@ -366,7 +774,8 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 
 - (BOOL)isConvex
 {
-    if (_numVertices < 3) return true;
+    if (_numHoles) return false;
+    else if (_numVertices < 3) return true;
     else
     {
         for (int i=0; i<_numVertices; ++i)
@@ -385,15 +794,25 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 
 - (float)area
 {
+    // the area of the holes is subtracted, no matter in which direction they run
     float area = 0;
 
-    if (_numVertices >= 3)
+    for (NSInteger c=0; c<=_numHoles; ++c)
     {
-        for (int i=0; i<_numVertices; ++i)
+        NSInteger start, end;
+        getContour(c, _holeIndices, _numHoles, _numVertices, &start, &end);
+        if (end - start < 3) continue;
+
+        float contourArea = 0;
+
+        for (NSInteger i=start, j=end-1; i<end; j=i++)
         {
-            area += _vertices[i].x * _vertices[(i+1) % _numVertices].y;
-            area -= _vertices[i].y * _vertices[(i+1) % _numVertices].x;
+            contourArea += _vertices[j].x * _vertices[i].y;
+            contourArea -= _vertices[j].y * _vertices[i].x;
         }
+
+        if (c == 0) area = contourArea;
+        else        area -= area < 0 ? -fabsf(contourArea) : fabsf(contourArea);
     }
 
     return area / 2.0;
@@ -401,6 +820,13 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 
 - (void)setNumVertices:(NSInteger)numVertices
 {
+    // holes that are cropped to less than a triangle are removed, along with their vertices
+    if (numVertices < _numVertices)
+    {
+        while (_numHoles && _holeIndices[_numHoles-1] > numVertices - 3)
+            numVertices = MIN(numVertices, _holeIndices[--_numHoles]);
+    }
+
     if (numVertices != _numVertices)
     {
         if (numVertices)
@@ -423,6 +849,36 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
 
 @end
 
+@implementation SPPolygon (Internal)
+
+- (const GLKVector2 *)vertices
+{
+    return _vertices;
+}
+
+- (const NSInteger *)holeIndices
+{
+    return _holeIndices;
+}
+
+- (SPPolygon *)immutableCopy
+{
+    if ([self isKindOfClass:[SPImmutablePolygon class]]) return self;
+
+    SPPolygon *copy = [[SPImmutablePolygon alloc] initWithVertices:_vertices count:_numVertices];
+
+    if (_numHoles)
+    {
+        copy->_holeIndices = malloc(sizeof(NSInteger) * _numHoles);
+        copy->_numHoles = _numHoles;
+        memcpy(copy->_holeIndices, _holeIndices, sizeof(NSInteger) * _numHoles);
+    }
+
+    return [copy autorelease];
+}
+
+@end
+
 #pragma mark - SPImmutablePolygon
 
 @implementation SPImmutablePolygon
@@ -451,6 +907,12 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
     else [super addVertices:vertices count:count];
 }
 
+- (void)addHoleWithVertices:(GLKVector2 *)vertices count:(NSInteger)count
+{
+    if (_frozen) [self raiseImutableException];
+    else [super addHoleWithVertices:vertices count:count];
+}
+
 - (void)setVertexWithX:(float)x y:(float)y atIndex:(NSInteger)index
 {
     if (_frozen) [self raiseImutableException];
@@ -463,6 +925,12 @@ static BOOL areVectorsIntersecting(float ax, float ay, float bx, float by,
     else [super setNumVertices:numVertices];
 }
 
+- (id)copy
+{
+    // immutable polygons can be shared; this also keeps the shape parameters of subclasses
+    return [self retain];
+}
+
 - (void)raiseImutableException
 {
     [NSException raise:SPExceptionInvalidOperation
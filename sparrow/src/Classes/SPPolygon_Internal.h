@@ -0,0 +1,26 @@
+//
+//  SPPolygon_Internal.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPPolygon.h"
+
+@interface SPPolygon (Internal)
+
+/// The coordinates of all vertices, including those of the holes.
+@property (nonatomic, readonly) const GLKVector2 *vertices;
+
+/// The index of the first vertex of each hole, or NULL if there are no holes.
+@property (nonatomic, readonly) const NSInteger *holeIndices;
+
+/// Returns a copy of the polygon (including its holes) that raises an exception when it is
+/// modified. Polygons that are immutable already return themselves.
+- (SPPolygon *)immutableCopy;
+
+@end
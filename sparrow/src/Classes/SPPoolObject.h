@@ -39,6 +39,12 @@ NS_ASSUME_NONNULL_BEGIN
 /// Purge all unused objects.
 + (NSInteger)purgePool;
 
+/// The number of instances requested so far, no matter if they were recycled or newly allocated.
+/// Compare the values of two frames to find code that creates too many temporary objects. The
+/// counter is not synchronized, so it may be off slightly if instances are created on several
+/// threads at once.
++ (NSInteger)numAllocations;
+
 @end
 
 #else
@@ -48,6 +54,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// Dummy implementation of SPPoolObject method to simplify switching between NSObject and SPPoolObject.
 + (NSInteger)purgePool;
 
+/// Dummy implementation of SPPoolObject method to simplify switching between NSObject and SPPoolObject.
++ (NSInteger)numAllocations;
+
 @end
 
 #endif
@@ -26,6 +26,7 @@ typedef struct
 {
     Class key;
     OSQueueHead value;
+    NSInteger numAllocations;
 }
 Pair;
 
@@ -37,7 +38,7 @@ PoolCache;
 
 SP_INLINE PoolCache *poolCache(void)
 {
-    static PoolCache instance = (PoolCache){{ nil, OS_ATOMIC_QUEUE_INIT }};
+    static PoolCache instance = (PoolCache){{ nil, OS_ATOMIC_QUEUE_INIT, 0 }};
     return &instance;
 }
 
@@ -53,6 +54,7 @@ SP_INLINE void initPoolWith(PoolCache *cache, Class class)
     Pair *pair = getPairWith(cache, key);
     pair->key = class;
     pair->value = (OSQueueHead)OS_ATOMIC_QUEUE_INIT;
+    pair->numAllocations = 0;
 }
 
 SP_INLINE OSQueueHead *getPoolWith(PoolCache *cache, Class class)
@@ -63,6 +65,14 @@ SP_INLINE OSQueueHead *getPoolWith(PoolCache *cache, Class class)
     return &pair->value;
 }
 
+SP_INLINE NSInteger *getNumAllocationsWith(PoolCache *cache, Class class)
+{
+    unsigned key = SPHashPointer(class);
+    Pair *pair = getPairWith(cache, key);
+    assert(pair->key == class);
+    return &pair->numAllocations;
+}
+
 // --- queue ---------------------------------------------------------------------------------------
 
 #define QUEUE_OFFSET sizeof(Class)
@@ -92,6 +102,7 @@ SP_INLINE OSQueueHead *getPoolWith(PoolCache *cache, Class class)
 {
     OSQueueHead *poolQueue = getPoolWith(poolCache(), self);
     SPPoolObject *object = DEQUEUE(poolQueue);
+    ++*getNumAllocationsWith(poolCache(), self);
 
     if (object)
     {
@@ -156,6 +167,11 @@ SP_INLINE OSQueueHead *getPoolWith(PoolCache *cache, Class class)
     return count;
 }
 
++ (NSInteger)numAllocations
+{
+    return *getNumAllocationsWith(poolCache(), self);
+}
+
 @end
 
 #else // DISABLE_MEMORY_POOLING
@@ -167,6 +183,11 @@ SP_INLINE OSQueueHead *getPoolWith(PoolCache *cache, Class class)
     return 0;
 }
 
++ (NSInteger)numAllocations
+{
+    return 0;
+}
+
 @end
 
 #endif
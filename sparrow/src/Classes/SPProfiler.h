@@ -0,0 +1,107 @@
+//
+//  SPProfiler.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import <Sparrow/SparrowBase.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Profiling zones are compiled into debug builds only. Define SP_PROFILER as 1 to capture release
+// builds, too, or as 0 to remove all zones.
+
+#ifndef SP_PROFILER
+  #if DEBUG
+    #define SP_PROFILER 1
+  #else
+    #define SP_PROFILER 0
+  #endif
+#endif
+
+/// A zone that was entered via `SPProfilerBeginZone`. Its name is `NULL` if nothing is captured.
+typedef struct
+{
+    const char *_Nullable name;
+    uint64_t start;
+} SPProfilerZone;
+
+/// Enters a zone; 'name' must be a string literal (or outlive the capture).
+SP_EXTERN SPProfilerZone SPProfilerBeginZone(const char *name);
+
+/// Leaves a zone, recording it if a capture is running.
+SP_EXTERN void SPProfilerEndZone(SPProfilerZone *zone);
+
+#define SP_PROFILER_CONCAT_(a, b) a ## b
+#define SP_PROFILER_CONCAT(a, b)  SP_PROFILER_CONCAT_(a, b)
+
+/// Records the time from this line to the end of the enclosing scope under the given name.
+#if SP_PROFILER
+    #define SP_PROFILE_ZONE(name)                                                           \
+        SPProfilerZone SP_PROFILER_CONCAT(_spProfilerZone, __LINE__)                        \
+            __attribute__((cleanup(SPProfilerEndZone), unused)) = SPProfilerBeginZone(name)
+#else
+    #define SP_PROFILE_ZONE(name)
+#endif
+
+/** ------------------------------------------------------------------------------------------------
+
+ SPProfiler records where the time of a frame goes, in a format that can be loaded into
+ Chrome's trace viewer (`chrome://tracing`) or any other tool that reads trace events.
+
+ Sparrow marks the phases of each frame with `SP_PROFILE_ZONE`: advancing the stage and the
+ juggler, traversing the display tree, drawing batches, uploading vertices, filter passes and
+ the work of the resource queue. You can add zones to your own code the same way:
+
+	- (void)updatePhysics
+	{
+	    SP_PROFILE_ZONE("Game.updatePhysics");
+	    ...
+	}
+
+ Zones are only compiled into debug builds (unless `SP_PROFILER` is defined otherwise), and only
+ recorded while a capture is running; otherwise, entering a zone costs a single check. Each thread
+ records into its own ring buffer, without any locks; when a buffer wraps around, the oldest zones
+ of that thread are lost. The buffers of threads that have exited are reused by new threads, once
+ their zones were exported or a new capture was started. To capture a range of frames, call
+ `captureNumFrames:` and fetch the `traceJSON` when `isCapturing` returns `NO` again:
+
+	[SPProfiler captureNumFrames:60];
+	...
+	[[SPProfiler traceJSON] writeToFile:path atomically:YES encoding:NSUTF8StringEncoding error:nil];
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPProfiler : NSObject
+
+/// -------------
+/// @name Methods
+/// -------------
+
+/// Starts recording zones right away, discarding any previous capture.
++ (void)startCapture;
+
+/// Stops recording zones.
++ (void)stopCapture;
+
+/// Records the given number of frames, starting with the next one.
++ (void)captureNumFrames:(NSInteger)numFrames;
+
+/// Marks the beginning of a frame, starting or stopping a capture requested via
+/// `captureNumFrames:`. SPViewController calls this at the beginning of each frame.
++ (void)beginFrame;
+
+/// Indicates if zones are currently being recorded.
++ (BOOL)isCapturing;
+
+/// The zones of the last capture in the Chrome trace event format, as a JSON string.
++ (NSString *)traceJSON;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,255 @@
+//
+//  SPProfiler.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPProfiler.h"
+
+#import <mach/mach_time.h>
+#import <pthread.h>
+#import <stdatomic.h>
+
+// --- private constants ---------------------------------------------------------------------------
+
+// The number of zones each thread keeps; must be a power of two.
+#define RING_SIZE 8192
+
+// --- private types -------------------------------------------------------------------------------
+
+typedef struct
+{
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+} SPProfilerEvent;
+
+typedef struct SPProfilerThread
+{
+    SPProfilerEvent events[RING_SIZE];
+    _Atomic(uint64_t) numEvents;
+    atomic_bool finished; // the thread has exited
+    atomic_bool exported; // the zones were exported after the thread had exited
+    uint64_t threadID;
+    char name[64];
+    struct SPProfilerThread *next;
+} SPProfilerThread;
+
+// --- static members ------------------------------------------------------------------------------
+
+static atomic_bool capturing;
+static _Atomic(SPProfilerThread *) threads;
+static __thread SPProfilerThread *currentThread;
+static pthread_key_t threadKey;
+static pthread_once_t threadKeyOnce = PTHREAD_ONCE_INIT;
+
+static uint64_t captureStart;
+static uint64_t captureEnd = UINT64_MAX;
+static NSInteger numFramesToCapture;
+static NSInteger numRemainingFrames;
+
+// --- C functions ---------------------------------------------------------------------------------
+
+static void finishThread(void *thread)
+{
+    atomic_store(&((SPProfilerThread *)thread)->finished, true);
+}
+
+static void createThreadKey(void)
+{
+    pthread_key_create(&threadKey, finishThread);
+}
+
+static BOOL isRecyclable(SPProfilerThread *thread)
+{
+    // the buffer of a finished thread is kept as long as its zones might still be exported
+    if (!atomic_load(&thread->finished)) return NO;
+    else if (atomic_load(&thread->exported)) return YES;
+
+    uint64_t numEvents = atomic_load_explicit(&thread->numEvents, memory_order_acquire);
+    return numEvents == 0 || thread->events[(numEvents - 1) & (RING_SIZE - 1)].end < captureStart;
+}
+
+static SPProfilerThread *registerThread(void)
+{
+    // Buffers are never freed; when a thread exits, its buffer is handed to the next new thread
+    // once its zones were exported or are older than the current capture. Thus, there are never
+    // more buffers than threads that ran during one capture. The list of threads only ever grows
+    // at its head, which makes it safe to walk at any time.
+
+    pthread_once(&threadKeyOnce, createThreadKey);
+
+    SPProfilerThread *thread = NULL;
+    for (SPProfilerThread *candidate = atomic_load(&threads); candidate && !thread; candidate = candidate->next)
+    {
+        bool finished = true;
+        if (isRecyclable(candidate) && atomic_compare_exchange_strong(&candidate->finished, &finished, false))
+            thread = candidate;
+    }
+
+    BOOL recycled = thread != NULL;
+
+    if (recycled)
+    {
+        atomic_store(&thread->numEvents, 0);
+        atomic_store(&thread->exported, false);
+        thread->name[0] = '\0';
+    }
+    else thread = calloc(1, sizeof(SPProfilerThread));
+
+    pthread_threadid_np(NULL, &thread->threadID);
+    pthread_setspecific(threadKey, thread);
+
+    if (pthread_main_np())
+        strlcpy(thread->name, "main", sizeof(thread->name));
+    else if (pthread_getname_np(pthread_self(), thread->name, sizeof(thread->name)) != 0 || !thread->name[0])
+    {
+        // the label is NULL outside of a queue, and empty for queues created without one
+        const char *label = dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL);
+        if (label && label[0]) strlcpy(thread->name, label, sizeof(thread->name));
+        else snprintf(thread->name, sizeof(thread->name), "thread %llu", thread->threadID);
+    }
+
+    if (!recycled)
+    {
+        SPProfilerThread *head = atomic_load(&threads);
+        do thread->next = head;
+        while (!atomic_compare_exchange_weak(&threads, &head, thread));
+    }
+
+    return thread;
+}
+
+SPProfilerZone SPProfilerBeginZone(const char *name)
+{
+    if (!atomic_load_explicit(&capturing, memory_order_relaxed))
+        return (SPProfilerZone){ NULL, 0 };
+    else
+        return (SPProfilerZone){ name, mach_absolute_time() };
+}
+
+void SPProfilerEndZone(SPProfilerZone *zone)
+{
+    if (!zone->name) return;
+
+    uint64_t end = mach_absolute_time();
+    SPProfilerThread *thread = currentThread;
+    if (!thread) thread = currentThread = registerThread();
+
+    // only this thread writes to its buffer; the release makes the event visible to the exporter
+    uint64_t index = atomic_load_explicit(&thread->numEvents, memory_order_relaxed);
+    thread->events[index & (RING_SIZE - 1)] = (SPProfilerEvent){ zone->name, zone->start, end };
+    atomic_store_explicit(&thread->numEvents, index + 1, memory_order_release);
+}
+
+// --- class implementation ------------------------------------------------------------------------
+
+@implementation SPProfiler
+
+#pragma mark Initialization
+
+- (instancetype)init
+{
+    [NSException raise:NSGenericException format:@"Static class - do not initialize!"];
+    return nil;
+}
+
+#pragma mark Methods
+
++ (void)startCapture
+{
+    captureStart = mach_absolute_time();
+    captureEnd = UINT64_MAX;
+    numRemainingFrames = 0;
+    atomic_store(&capturing, true);
+}
+
++ (void)stopCapture
+{
+    atomic_store(&capturing, false);
+    captureEnd = mach_absolute_time();
+    numRemainingFrames = 0;
+}
+
++ (void)captureNumFrames:(NSInteger)numFrames
+{
+    numFramesToCapture = MAX(0, numFrames);
+}
+
++ (void)beginFrame
+{
+    if (numFramesToCapture)
+    {
+        [self startCapture];
+        numRemainingFrames = numFramesToCapture;
+        numFramesToCapture = 0;
+    }
+    else if (numRemainingFrames && --numRemainingFrames == 0)
+    {
+        [self stopCapture];
+    }
+}
+
++ (BOOL)isCapturing
+{
+    return atomic_load(&capturing) || numFramesToCapture > 0;
+}
+
++ (NSString *)traceJSON
+{
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+
+    double microsecondsPerTick = timebase.numer / (timebase.denom * 1000.0);
+    NSMutableArray *traceEvents = [NSMutableArray array];
+
+    for (SPProfilerThread *thread = atomic_load(&threads); thread; thread = thread->next)
+    {
+        BOOL finished = atomic_load(&thread->finished);
+        uint64_t numEvents = atomic_load_explicit(&thread->numEvents, memory_order_acquire);
+        uint64_t firstEvent = numEvents > RING_SIZE ? numEvents - RING_SIZE : 0;
+        NSInteger numExported = 0;
+
+        for (uint64_t i=firstEvent; i<numEvents; ++i)
+        {
+            SPProfilerEvent event = thread->events[i & (RING_SIZE - 1)];
+            if (event.start < captureStart || event.end > captureEnd) continue;
+
+            [traceEvents addObject:@{
+                @"name": @(event.name),
+                @"cat":  @"sparrow",
+                @"ph":   @"X",
+                @"ts":   @((event.start - captureStart) * microsecondsPerTick),
+                @"dur":  @((event.end - event.start) * microsecondsPerTick),
+                @"pid":  @1,
+                @"tid":  @(thread->threadID)
+            }];
+
+            ++numExported;
+        }
+
+        if (numExported)
+        {
+            [traceEvents addObject:@{
+                @"name": @"thread_name",
+                @"ph":   @"M",
+                @"pid":  @1,
+                @"tid":  @(thread->threadID),
+                @"args": @{ @"name": [NSString stringWithUTF8String:thread->name] }
+            }];
+        }
+
+        if (finished) atomic_store(&thread->exported, true);
+    }
+
+    NSDictionary *trace = @{ @"traceEvents": traceEvents, @"displayTimeUnit": @"ms" };
+    NSData *data = [NSJSONSerialization dataWithJSONObject:trace options:0 error:nil];
+    return [[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] autorelease];
+}
+
+@end
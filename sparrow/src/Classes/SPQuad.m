@@ -9,7 +9,9 @@
 //  it under the terms of the Simplified BSD License.
 //
 
+#import "SPDisplayObject_Internal.h"
 #import "SPMacros.h"
+#import "SPMatrix.h"
 #import "SPPoint.h"
 #import "SPQuad.h"
 #import "SPRectangle.h"
@@ -104,6 +106,15 @@
     return [_vertexData colorAtIndex:vertexID];
 }
 
+- (SPRectValue)boundsValueInParent
+{
+    if (self.is3D) return [super boundsValueInParent];
+
+    GLKVector2 bottomRight = [_vertexData vertexAtIndex:3].position;
+    return SPMatrixValueTransformRect(self.transformationMatrix.matrixValue,
+                                      SPRectValueMake(0.0f, 0.0f, bottomRight.x, bottomRight.y));
+}
+
 - (void)setAlpha:(float)alpha ofVertex:(NSInteger)vertexID
 {
     [_vertexData setAlpha:alpha atIndex:vertexID];
@@ -131,7 +142,7 @@
 
 - (void)vertexDataDidChange
 {
-    // override in subclass
+    [self markDirty:SPDirtyFlagVertices];
 }
 
 #pragma mark NSCopying
@@ -158,7 +169,7 @@
 {
     if (targetSpace == self) // optimization
     {
-        SPPoint *bottomRight = [_vertexData positionAtIndex:3];
+        GLKVector2 bottomRight = [_vertexData vertexAtIndex:3].position;
         return [SPRectangle rectangleWithX:0.0f y:0.0f width:bottomRight.x height:bottomRight.y];
     }
     else if ((id)targetSpace == (id)self.parent && self.rotation == 0.0f) // optimization
@@ -166,7 +177,7 @@
         float scaleX = self.scaleX;
         float scaleY = self.scaleY;
 
-        SPPoint *bottomRight = [_vertexData positionAtIndex:3];
+        GLKVector2 bottomRight = [_vertexData vertexAtIndex:3].position;
         SPRectangle *resultRect = [SPRectangle rectangleWithX:self.x - self.pivotX * scaleX
                                                             y:self.y - self.pivotY * scaleY
                                                         width:bottomRight.x * scaleX
@@ -224,7 +235,10 @@
 - (void)setPremultipliedAlpha:(BOOL)premultipliedAlpha
 {
     if (premultipliedAlpha != self.premultipliedAlpha)
+    {
         _vertexData.premultipliedAlpha = premultipliedAlpha;
+        [self markDirty:SPDirtyFlagVertices];
+    }
 }
 
 - (BOOL)tinted
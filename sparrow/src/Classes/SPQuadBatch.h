@@ -11,13 +11,13 @@
 
 #import <Sparrow/SparrowBase.h>
 #import <Sparrow/SPDisplayObject.h>
+#import <Sparrow/SPVertexData.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
 @class SPImage;
 @class SPQuad;
 @class SPTexture;
-@class SPVertexData;
 
 /** ------------------------------------------------------------------------------------------------
  
@@ -41,6 +41,13 @@ NS_ASSUME_NONNULL_BEGIN
  smoothing and repetition, and if it's tinted (colored vertices and/or transparency).
  When you reset the batch, it will accept a new state on the next added quad.
  
+ **Multiple textures**
+ 
+ By raising `maxNumTextures`, a batch may contain quads with up to that many different textures.
+ Each quad then stores the slot of its texture, which is uploaded along with its vertices, and all
+ textures are bound at once when the batch is drawn. All other parts of the state still need to be
+ equal; adding a quad whose texture finds no free slot raises an exception.
+ 
 ------------------------------------------------------------------------------------------------- */
 @interface SPQuadBatch : SPDisplayObject
 {
@@ -111,10 +118,17 @@ NS_ASSUME_NONNULL_BEGIN
 
 /// Indicates if specific quads can be added to the batch without causing a state change.
 /// A state change occurs if the quad uses a different base texture, has a different `smoothing`,
-/// `repeat` or 'tinted' setting, or if the batch is full (one batch can contain up to 8192 quads).
+/// `repeat` or 'tinted' setting. There is no limit on the number of quads in a batch; batches with
+/// more than 16383 quads are drawn in several ranges from the same vertex buffer.
+/// If the batch supports several textures, a new texture only causes a state change when all
+/// texture slots are taken.
 - (BOOL)isStateChangeWithTinted:(BOOL)tinted texture:(SPTexture *)texture alpha:(float)alpha
              premultipliedAlpha:(BOOL)pma blendMode:(uint)blendMode numQuads:(NSInteger)numQuads;
 
+/// Indicates if another batch can be added to this batch without causing a state change. Other
+/// than the method above, this takes all textures of the other batch into account.
+- (BOOL)isStateChangeWithQuadBatch:(SPQuadBatch *)quadBatch alpha:(float)alpha blendMode:(uint)blendMode;
+
 /// Renders the batch with custom alpha and blend mode values, as well as a custom mvp matrix.
 - (void)renderWithMvpMatrix:(SPMatrix *)matrix alpha:(float)alpha blendMode:(uint)blendMode SP_DEPRECATED;
 
@@ -181,9 +195,9 @@ NS_ASSUME_NONNULL_BEGIN
 + (NSMutableArray<SPQuadBatch*> *)compileObject:(SPDisplayObject *)object
                                       intoArray:(nullable NSMutableArray<SPQuadBatch*> *)quadBatches;
 
-/// Naively optimizes a list of batches by merging all that have an identical state. Naturally, this
-/// will change the z-order of some of the batches, so this method is useful only for specific
-/// use-cases.
+/// Optimizes a list of batches by merging those that have an identical state. A batch is only
+/// moved forward if it does not overlap any of the batches it jumps over, so the visible z-order
+/// is preserved.
 + (void)optimize:(NSMutableArray<SPQuadBatch*> *)quadBatches;
 
 /// ----------------
@@ -196,9 +210,16 @@ NS_ASSUME_NONNULL_BEGIN
 /// Indicates if any vertices have a non-white color or are not fully opaque.
 @property (nonatomic, readonly) BOOL tinted;
 
-/// The current texture of the batch, if there is one.
+/// The current texture of the batch, if there is one. In batches with several textures, this is
+/// the one in the first slot.
 @property (nonatomic, readonly) SPTexture *texture;
 
+/// The number of different textures the quads of the batch may use. It can't exceed
+/// `SP_MAX_NUM_TEXTURES` and should not exceed `[SPBaseEffect maxNumTextures]`. Batches with more than one texture are drawn with a shader that
+/// picks the texture of each vertex. Lowering the value does not remove any textures that are
+/// already in use. Default: 1
+@property (nonatomic, assign) NSInteger maxNumTextures;
+
 /// Indicates if the rgb values are stored premultiplied with the alpha value.
 @property (nonatomic, readonly) BOOL premultipliedAlpha;
 
@@ -208,6 +229,17 @@ NS_ASSUME_NONNULL_BEGIN
 /// Default: NO
 @property (nonatomic, assign) BOOL batchable;
 
+/// Indicates if the contents of the batch change very often, e.g. in every frame. A dynamic batch
+/// does not upload its complete vertex data into a buffer of its own; instead, right before
+/// drawing, it copies just the used vertices into the streaming vertex buffer of the current
+/// context. The batches SPRenderSupport uses internally are dynamic. Default: NO
+@property (nonatomic, assign) BOOL dynamic;
+
+/// The layout of the vertices in the vertex buffer. Compact formats reduce the bytes that are
+/// uploaded and read by the GPU; options the batch can't use in its current state (e.g. leaving
+/// out colors while it is tinted) are ignored. Default: SPVertexFormatStandard
+@property (nonatomic, assign) SPVertexFormat vertexFormat;
+
 /// Indicates the number of quads for which space is allocated (vertex- and index-buffers).
 /// If you add more quads than what fits into the current capacity, the QuadBatch is
 /// expanded automatically. However, if you know beforehand how many vertices you need,
@@ -11,19 +11,102 @@
 
 #import "SPBaseEffect.h"
 #import "SPBlendMode.h"
+#import "SPContext_Internal.h"
+#import "SPDisplayObject_Internal.h"
 #import "SPDisplayObjectContainer.h"
 #import "SPImage.h"
 #import "SPMacros.h"
 #import "SPMatrix.h"
 #import "SPMatrix3D.h"
 #import "SPOpenGL.h"
+#import "SPProfiler.h"
 #import "SPQuadBatch.h"
+#import "SPQuadBatch_Internal.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
 #import "SPSprite.h"
 #import "SPSprite3D.h"
 #import "SPTexture.h"
 #import "SPVertexData.h"
 
+// --- private constants ---------------------------------------------------------------------------
+
+// The vertices of this many quads can just be addressed with 16 bit indices. Larger batches are
+// drawn in several ranges from the same vertex buffer.
+#define MAX_QUADS_PER_DRAW 16383
+
+// --- C functions ---------------------------------------------------------------------------------
+
+static BOOL boundsOverlapRange(SPQuadBatchBounds bounds, SPQuadBatchBounds *others,
+                               NSInteger from, NSInteger to)
+{
+    for (NSInteger i=from; i<to; ++i)
+        if (SPQuadBatchBoundsOverlap(bounds, others[i])) return YES;
+
+    return NO;
+}
+
+SP_INLINE BOOL isAxisAlignedQuad(const SPVertex *v)
+{
+    // vertices are ordered top left, top right, bottom left, bottom right
+    return v[0].position.y == v[1].position.y && v[2].position.y == v[3].position.y &&
+           v[0].position.x == v[2].position.x && v[1].position.x == v[3].position.x;
+}
+
+SP_INLINE float bilerp(float a0, float a1, float a2, float a3, float s, float t)
+{
+    return (1.0f - t) * (a0 + s * (a1 - a0)) + t * (a2 + s * (a3 - a2));
+}
+
+static void clipQuad(SPVertex *v, SPQuadBatchBounds bounds)
+{
+    // The new corners are found at the parameters (s, t) of the old quad, and their texture
+    // coordinates and colors are interpolated bilinearly. The GPU interpolates linearly within each
+    // of the two triangles instead; both agree when the attributes change linearly across the quad
+    // (as they do for images and evenly colored quads). Other gradients can only be approximated,
+    // since the clipped quad is split into different triangles anyway.
+
+    float x0 = v[0].position.x, x1 = v[1].position.x;
+    float y0 = v[0].position.y, y1 = v[2].position.y;
+
+    float minX = MAX(MIN(x0, x1), bounds.minX), maxX = MIN(MAX(x0, x1), bounds.maxX);
+    float minY = MAX(MIN(y0, y1), bounds.minY), maxY = MIN(MAX(y0, y1), bounds.maxY);
+
+    if (minX >= maxX || minY >= maxY || x0 == x1 || y0 == y1)
+    {
+        for (int i=1; i<4; ++i) v[i].position = v[0].position; // nothing visible
+        return;
+    }
+
+    float newX0 = x0 < x1 ? minX : maxX, newX1 = x0 < x1 ? maxX : minX;
+    float newY0 = y0 < y1 ? minY : maxY, newY1 = y0 < y1 ? maxY : minY;
+
+    if (newX0 == x0 && newX1 == x1 && newY0 == y0 && newY1 == y1)
+        return;
+
+    float s[2] = { (newX0 - x0) / (x1 - x0), (newX1 - x0) / (x1 - x0) };
+    float t[2] = { (newY0 - y0) / (y1 - y0), (newY1 - y0) / (y1 - y0) };
+
+    SPVertex old[4];
+    memcpy(old, v, sizeof(old));
+
+    for (int i=0; i<4; ++i)
+    {
+        float si = s[i & 1], ti = t[i >> 1];
+
+        v[i].position.x = (i & 1) ? newX1 : newX0;
+        v[i].position.y = (i >> 1) ? newY1 : newY0;
+        v[i].texCoords.x = bilerp(old[0].texCoords.x, old[1].texCoords.x,
+                                  old[2].texCoords.x, old[3].texCoords.x, si, ti);
+        v[i].texCoords.y = bilerp(old[0].texCoords.y, old[1].texCoords.y,
+                                  old[2].texCoords.y, old[3].texCoords.y, si, ti);
+        v[i].color.r = bilerp(old[0].color.r, old[1].color.r, old[2].color.r, old[3].color.r, si, ti) + 0.5f;
+        v[i].color.g = bilerp(old[0].color.g, old[1].color.g, old[2].color.g, old[3].color.g, si, ti) + 0.5f;
+        v[i].color.b = bilerp(old[0].color.b, old[1].color.b, old[2].color.b, old[3].color.b, si, ti) + 0.5f;
+        v[i].color.a = bilerp(old[0].color.a, old[1].color.a, old[2].color.a, old[3].color.a, si, ti) + 0.5f;
+    }
+}
+
 // --- class implementation ------------------------------------------------------------------------
 
 @implementation SPQuadBatch
@@ -31,15 +114,23 @@
     NSInteger _numQuads;
     BOOL _syncRequired;
     
-    SPTexture *_texture;
+    SPTexture *_textures[SP_MAX_NUM_TEXTURES];
+    uchar *_textureSlots; // one per quad; kept apart so that SPVertex doesn't grow
+    NSInteger _numTextures;
+    NSInteger _maxNumTextures;
+    SPVertexFormat _vertexFormat;
+    SPVertexFormat _uploadedFormat;
+    void *_packedVertices;
+    NSInteger _packedCapacity;
     BOOL _premultipliedAlpha;
     BOOL _tinted;
     BOOL _batchable;
+    BOOL _dynamic;
     
     SPBaseEffect *_baseEffect;
     uint _vertexBufferName;
-    ushort *_indexData;
     uint _indexBufferName;
+    NSInteger _indexBufferCapacity;
 }
 
 #pragma mark Initialization
@@ -49,6 +140,7 @@
     if ((self = [super init]))
     {
         _numQuads = 0;
+        _maxNumTextures = 1;
         _syncRequired = NO;
         _vertexData = [[SPVertexData alloc] init];
         _baseEffect = [[SPBaseEffect alloc] init];
@@ -67,12 +159,12 @@
 
 - (void)dealloc
 {
-    free(_indexData);
-    
     glDeleteBuffers(1, &_vertexBufferName);
     glDeleteBuffers(1, &_indexBufferName);
+    free(_packedVertices);
+    free(_textureSlots);
 
-    [_texture release];
+    [self releaseTextures];
     [_vertexData release];
     [_baseEffect release];
     [super dealloc];
@@ -88,14 +180,16 @@
 - (void)onVertexDataChanged
 {
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
 }
 
 - (void)reset
 {
     _numQuads = 0;
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
     _baseEffect.texture = nil;
-    SP_RELEASE_AND_NIL(_texture);
+    [self releaseTextures];
 }
 
 - (void)addQuad:(SPQuad *)quad
@@ -119,7 +213,7 @@
     if (_numQuads + 1 > self.capacity) [self expand];
     if (_numQuads == 0)
     {
-        SP_RELEASE_AND_RETAIN(_texture, quad.texture);
+        [self releaseTextures];
         _premultipliedAlpha = quad.premultipliedAlpha;
         self.blendMode = blendMode;
         [_vertexData setPremultipliedAlpha:_premultipliedAlpha updateVertices:NO];
@@ -127,6 +221,7 @@
     
     NSInteger vertexID = _numQuads * 4;
     [quad copyTransformedVertexDataTo:_vertexData atIndex:vertexID matrix:matrix];
+    _textureSlots[_numQuads] = [self slotForTexture:quad.texture];
     
     if (alpha != 1.0f)
         [_vertexData scaleAlphaBy:alpha atIndex:vertexID numVertices:4];
@@ -135,6 +230,7 @@
         _tinted = alpha != 1.0f || quad.tinted;
     
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
     _numQuads++;
 }
 
@@ -164,7 +260,8 @@
     if (_numQuads + numQuads > self.capacity) self.capacity = _numQuads + numQuads;
     if (_numQuads == 0)
     {
-        SP_RELEASE_AND_RETAIN(_texture, quadBatch.texture);
+        [self releaseTextures];
+        _maxNumTextures = MAX(_maxNumTextures, quadBatch->_numTextures);
         _premultipliedAlpha = quadBatch.premultipliedAlpha;
         self.blendMode = blendMode;
         [_vertexData setPremultipliedAlpha:_premultipliedAlpha updateVertices:NO];
@@ -173,6 +270,21 @@
     [quadBatch->_vertexData copyTransformedToVertexData:_vertexData atIndex:vertexID matrix:matrix
                                               fromIndex:0 numVertices:numVertices];
     
+    // the slots of the other batch need to be mapped to our own ones
+    uchar *textureSlots = _textureSlots + _numQuads;
+    
+    if (quadBatch->_numTextures <= 1)
+        memset(textureSlots, [self slotForTexture:quadBatch.texture], numQuads);
+    else
+    {
+        uchar slotMap[SP_MAX_NUM_TEXTURES];
+        for (NSInteger i=0; i<quadBatch->_numTextures; ++i)
+            slotMap[i] = [self slotForTexture:quadBatch->_textures[i]];
+        
+        for (NSInteger i=0; i<numQuads; ++i)
+            textureSlots[i] = slotMap[quadBatch->_textureSlots[i]];
+    }
+    
     if (alpha != 1.0f)
         [_vertexData scaleAlphaBy:alpha atIndex:vertexID numVertices:numVertices];
     
@@ -180,23 +292,52 @@
         _tinted = alpha != 1.0f || quadBatch.tinted;
     
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
     _numQuads += numQuads;
 }
 
 - (BOOL)isStateChangeWithTinted:(BOOL)tinted texture:(SPTexture *)texture alpha:(float)alpha
              premultipliedAlpha:(BOOL)pma blendMode:(uint)blendMode numQuads:(NSInteger)numQuads
 {
+    SPTexture *currentTexture = _textures[0];
+
     if (_numQuads == 0) return NO;
-    else if (_numQuads + numQuads > 8192) return YES; // maximum buffer size
-    else if (!_texture && !texture)
+    else if (!currentTexture && !texture)
         return _premultipliedAlpha != pma || self.blendMode != blendMode;
-    else if (_texture && texture)
+    else if (currentTexture && texture && _maxNumTextures > 1)
         return _tinted != (tinted || alpha != 1.0f) ||
-               _texture.name != texture.name ||
+               _premultipliedAlpha != pma ||
+               self.blendMode != blendMode ||
+               ([self indexOfTexture:texture] == -1 && _numTextures == _maxNumTextures);
+    else if (currentTexture && texture)
+        return _tinted != (tinted || alpha != 1.0f) ||
+               currentTexture.name != texture.name ||
                self.blendMode != blendMode;
     else return YES;
 }
 
+- (BOOL)isStateChangeWithQuadBatch:(SPQuadBatch *)quadBatch alpha:(float)alpha blendMode:(uint)blendMode
+{
+    if (quadBatch->_numTextures <= 1)
+        return [self isStateChangeWithTinted:quadBatch.tinted texture:quadBatch.texture alpha:alpha
+                          premultipliedAlpha:quadBatch.premultipliedAlpha blendMode:blendMode
+                                    numQuads:quadBatch.numQuads];
+    else if (_numQuads == 0) return NO;
+    else if (!_textures[0] ||
+             _tinted != (quadBatch.tinted || alpha != 1.0f) ||
+             _premultipliedAlpha != quadBatch.premultipliedAlpha ||
+             self.blendMode != blendMode)
+        return YES;
+    else
+    {
+        NSInteger numMissingTextures = 0;
+        for (NSInteger i=0; i<quadBatch->_numTextures; ++i)
+            if ([self indexOfTexture:quadBatch->_textures[i]] == -1) ++numMissingTextures;
+        
+        return _numTextures + numMissingTextures > _maxNumTextures;
+    }
+}
+
 - (void)renderWithMvpMatrix:(SPMatrix *)matrix
 {
     [self renderWithMvpMatrix3D:[matrix convertTo3D] alpha:1.0f blendMode:self.blendMode];
@@ -215,12 +356,22 @@
 - (void)renderWithMvpMatrix3D:(SPMatrix3D *)matrix alpha:(float)alpha blendMode:(uint)blendMode;
 {
     if (!_numQuads) return;
-    if (_syncRequired) [self syncBuffers];
+    
+    SPContext *context = SPContext.currentContext;
+    BOOL streaming = _dynamic && context;
+    
+    SPVertexFormat format = [self vertexFormatForAlpha:alpha];
+    SPVertexLayout layout = SPVertexLayoutMake(format);
+    
+    if ((_syncRequired || format != _uploadedFormat) && !streaming) [self syncBuffersWithFormat:format];
     if (blendMode == SPBlendModeAuto)
         [NSException raise:SPExceptionInvalidOperation
                     format:@"cannot render object with blend mode SPBlendModeAuto"];
     
-    _baseEffect.texture = _texture;
+    for (NSInteger i=0; i<SP_MAX_NUM_TEXTURES; ++i)
+        [_baseEffect setTexture:i < _numTextures ? _textures[i] : nil atSlot:i];
+    
+    _baseEffect.numTextures = MAX(1, _numTextures);
     _baseEffect.premultipliedAlpha = _premultipliedAlpha;
     _baseEffect.mvpMatrix3D = matrix;
     _baseEffect.useTinting = _tinted || alpha != 1.0f;
@@ -228,35 +379,82 @@
     
     [_baseEffect prepareToDraw];
     
-    [SPBlendMode applyBlendFactorsForBlendMode:blendMode premultipliedAlpha:_premultipliedAlpha];
+    if (_baseEffect.overdrawBrightness > 0.0f)
+        glBlendFunc(GL_ONE, GL_ONE); // each layer adds the same brightness
+    else
+        [SPBlendMode applyBlendFactorsForBlendMode:blendMode premultipliedAlpha:_premultipliedAlpha];
     
     int attribPosition  = _baseEffect.attribPosition;
     int attribColor     = _baseEffect.attribColor;
     int attribTexCoords = _baseEffect.attribTexCoords;
+    int attribTextureSlot = _baseEffect.attribTextureSlot;
+    BOOL hasTexture = _textures[0] != nil && attribTexCoords >= 0;
     
     glEnableVertexAttribArray(attribPosition);
-    glEnableVertexAttribArray(attribColor);
     
-    if (_texture)
+    if (attribColor >= 0)
+        glEnableVertexAttribArray(attribColor);
+    
+    if (hasTexture)
         glEnableVertexAttribArray(attribTexCoords);
     
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexBufferName);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferName);
+    if (attribTextureSlot >= 0)
+        glEnableVertexAttribArray(attribTextureSlot);
+    
+    GLenum positionType  = (format & SPVertexFormatHalfPositions)  ? GL_HALF_FLOAT_OES : GL_FLOAT;
+    GLenum texCoordsType = (format & SPVertexFormatShortTexCoords) ? GL_UNSIGNED_SHORT : GL_FLOAT;
+    
+    // dynamic batches upload just the used vertices into the context's streaming buffer
+    uint vertexBufferName = _vertexBufferName;
+    NSInteger vertexOffset = 0;
+    
+    if (streaming)
+    {
+        SP_PROFILE_ZONE("SPQuadBatch.streamVertices");
+        vertexBufferName = [context streamVertexData:[self packVerticesInFormat:format numVertices:_numQuads * 4]
+                                            numBytes:layout.stride * _numQuads * 4
+                                              offset:&vertexOffset];
+    }
     
-    glVertexAttribPointer(attribPosition, 2, GL_FLOAT, GL_FALSE, sizeof(SPVertex),
-                          (void *)(offsetof(SPVertex, position)));
+    uint indexBufferName = [self indexBufferForNumQuads:MIN(_numQuads, MAX_QUADS_PER_DRAW) context:context];
     
-    glVertexAttribPointer(attribColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SPVertex),
-                          (void *)(offsetof(SPVertex, color)));
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBufferName);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferName);
     
-    if (_texture)
+    for (NSInteger quadID=0; quadID<_numQuads; quadID+=MAX_QUADS_PER_DRAW)
     {
-        glVertexAttribPointer(attribTexCoords, 2, GL_FLOAT, GL_FALSE, sizeof(SPVertex),
-                              (void *)(offsetof(SPVertex, texCoords)));
+        // all ranges share the same indices; only the attribute offsets differ
+        
+        char *offset = (char *)(vertexOffset + layout.stride * quadID * 4);
+        int numIndices = (int)MIN(_numQuads - quadID, MAX_QUADS_PER_DRAW) * 6;
+        
+        glVertexAttribPointer(attribPosition, 2, positionType, GL_FALSE, layout.stride,
+                              offset + layout.position);
+        
+        if (layout.color != -1 && attribColor >= 0)
+        {
+            glVertexAttribPointer(attribColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, layout.stride,
+                                  offset + layout.color);
+        }
+        
+        if (hasTexture)
+        {
+            glVertexAttribPointer(attribTexCoords, 2, texCoordsType, texCoordsType != GL_FLOAT,
+                                  layout.stride, offset + layout.texCoords);
+        }
+        
+        if (attribTextureSlot >= 0)
+        {
+            glVertexAttribPointer(attribTextureSlot, 1, GL_UNSIGNED_BYTE, GL_FALSE, layout.stride,
+                                  offset + layout.textureSlot);
+        }
+        
+        glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_SHORT, 0);
     }
     
-    int numIndices = (int)_numQuads * 6;
-    glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_SHORT, 0);
+    // single-texture programs don't know this attribute, so it must not stay enabled
+    if (attribTextureSlot >= 0)
+        glDisableVertexAttribArray(attribTextureSlot);
 }
 
 #pragma mark Utility Methods
@@ -265,6 +463,7 @@
 {
     [_vertexData transformVerticesWithMatrix:matrix atIndex:index * 4 numVertices:4];
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
 }
 
 - (uint)vertexColorOfQuadAtIndex:(NSInteger)quadID vertexID:(NSInteger)vertexID
@@ -276,6 +475,7 @@
 {
     [_vertexData setColor:color atIndex:quadID * 4 + vertexID];
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
 }
 
 - (float)vertexAlphaAtIndex:(NSInteger)quadID vertexID:(NSInteger)vertexID
@@ -287,6 +487,7 @@
 {
     [_vertexData setAlpha:alpha atIndex:quadID * 4 + vertexID];
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
 }
 
 - (uint)quadColorAtIndex:(NSInteger)quadID
@@ -300,6 +501,7 @@
         [_vertexData setColor:color atIndex:quadID * 4 + i];
     
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
 }
 
 - (float)quadAlphaAtIndex:(NSInteger)quadID
@@ -313,6 +515,7 @@
         [_vertexData setAlpha:alpha atIndex:quadID * 4 + i];
     
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
 }
 
 - (void)setQuad:(SPQuad *)quad atIndex:(NSInteger)quadID
@@ -326,6 +529,7 @@
     if (alpha != 1.0) [_vertexData scaleAlphaBy:alpha atIndex:vertexID numVertices:4];
     
     _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
 }
 
 - (SPRectangle *)boundsOfQuadAtIndex:(NSInteger)quadID
@@ -340,6 +544,16 @@
 
 #pragma mark Properties
 
+- (SPTexture *)texture
+{
+    return _textures[0];
+}
+
+- (void)setMaxNumTextures:(NSInteger)value
+{
+    _maxNumTextures = MAX(_numTextures, MAX(1, MIN(value, SP_MAX_NUM_TEXTURES)));
+}
+
 - (NSInteger)capacity
 {
     return _vertexData.numVertices / 4;
@@ -349,24 +563,8 @@
 {
     NSAssert(newCapacity > 0, @"capacity must not be zero");
     
-    NSInteger oldCapacity = self.capacity;
-    NSInteger numVertices = newCapacity * 4;
-    NSInteger numIndices  = newCapacity * 6;
-    
-    _vertexData.numVertices = numVertices;
-    
-    if (!_indexData) _indexData = malloc(sizeof(ushort) * numIndices);
-    else             _indexData = realloc(_indexData, sizeof(ushort) * numIndices);
-    
-    for (NSInteger i=oldCapacity; i<newCapacity; ++i)
-    {
-        _indexData[i*6  ] = i*4;
-        _indexData[i*6+1] = i*4 + 1;
-        _indexData[i*6+2] = i*4 + 2;
-        _indexData[i*6+3] = i*4 + 1;
-        _indexData[i*6+4] = i*4 + 3;
-        _indexData[i*6+5] = i*4 + 2;
-    }
+    _vertexData.numVertices = newCapacity * 4;
+    _textureSlots = realloc(_textureSlots, newCapacity);
     
     [self destroyBuffers];
     _syncRequired = YES;
@@ -381,10 +579,18 @@
     quadBatch.capacity = self.capacity;
     quadBatch->_numQuads = _numQuads;
     quadBatch->_tinted = _tinted;
-    quadBatch->_texture = [_texture retain];
+    quadBatch->_numTextures = _numTextures;
+    quadBatch->_maxNumTextures = _maxNumTextures;
+    
+    for (NSInteger i=0; i<_numTextures; ++i)
+        quadBatch->_textures[i] = [_textures[i] retain];
+    
     quadBatch->_syncRequired = YES;
+    quadBatch->_dynamic = _dynamic;
+    quadBatch->_vertexFormat = _vertexFormat;
     
     [_vertexData copyToVertexData:quadBatch->_vertexData];
+    memcpy(quadBatch->_textureSlots, _textureSlots, _numQuads);
     
     return quadBatch;
 }
@@ -405,7 +611,7 @@
             [support batchQuadBatch:self];
         else
         {
-            [support finishQuadBatch];
+            [support finishQuadBatchWithReason:SPBatchBreakReasonCustomRendering object:self];
             [support addDrawCalls:1];
             [self renderWithMvpMatrix3D:support.mvpMatrix3D alpha:support.alpha blendMode:support.blendMode];
         }
@@ -424,36 +630,54 @@
     if (!quadBatches) quadBatches = [NSMutableArray array];
     
     [self compileObject:object intoArray:quadBatches atPosition:-1
-             withMatrix:[SPMatrix matrixWithIdentity] alpha:1.0f blendMode:SPBlendModeAuto];
+             withMatrix:SPMatrixValueIdentity() scratchMatrix:[SPMatrix matrixWithIdentity]
+                  alpha:1.0f blendMode:SPBlendModeAuto];
 
     return quadBatches;
 }
 
 + (void)optimize:(NSMutableArray<SPQuadBatch*> *)quadBatches
 {
+    // A batch may only be appended to an earlier one if its quads don't overlap any of the
+    // batches in between. Otherwise, the changed drawing order would be visible.
+
+    NSInteger numBatches = quadBatches.count;
+    if (numBatches < 2) return;
+
+    SPQuadBatchBounds *bounds = malloc(sizeof(SPQuadBatchBounds) * numBatches);
+    for (NSInteger i=0; i<numBatches; ++i)
+        bounds[i] = [quadBatches[i] boundsOfQuadsAtIndex:0 numQuads:quadBatches[i].numQuads];
+
     SPQuadBatch *batch1, *batch2;
-    for (NSInteger i=0; i<quadBatches.count; ++i)
+    for (NSInteger i=0; i<numBatches; ++i)
     {
         batch1 = quadBatches[i];
-        for (NSInteger j=i+1; j<quadBatches.count; )
+        for (NSInteger j=i+1; j<numBatches; )
         {
             batch2 = quadBatches[j];
-            if (![batch1 isStateChangeWithTinted:batch2.tinted texture:batch2.texture alpha:batch2.alpha
-                              premultipliedAlpha:batch2.premultipliedAlpha blendMode:batch2.blendMode
-                                        numQuads:batch2.numQuads])
+            if (![batch1 isStateChangeWithQuadBatch:batch2 alpha:batch2.alpha blendMode:batch2.blendMode] &&
+                !boundsOverlapRange(bounds[j], bounds, i+1, j))
             {
                 [batch1 addQuadBatch:batch2];
                 [quadBatches removeObjectAtIndex:j];
+
+                bounds[i] = SPQuadBatchBoundsUnion(bounds[i], bounds[j]);
+                memmove(bounds + j, bounds + j + 1, sizeof(SPQuadBatchBounds) * (numBatches - j - 1));
+                --numBatches;
             }
             else ++j;
         }
     }
+
+    free(bounds);
 }
 
 + (NSInteger)compileObject:(SPDisplayObject *)object intoArray:(NSMutableArray<SPQuadBatch*> *)quadBatches
-                atPosition:(NSInteger)quadBatchID withMatrix:(SPMatrix *)transformationMatrix
-                     alpha:(float)alpha blendMode:(uint)blendMode
+                atPosition:(NSInteger)quadBatchID withMatrix:(SPMatrixValue)transformationMatrix
+             scratchMatrix:(SPMatrix *)scratchMatrix alpha:(float)alpha blendMode:(uint)blendMode
 {
+    // the matrices are passed down the tree as values; only the leaves need a matrix object,
+    // and they all share the same one.
     if ([object isKindOfClass:[SPSprite3D class]])
         [NSException raise:SPExceptionInvalidOperation format:@"SPSprite3D objects cannot be flattened"];
     
@@ -485,7 +709,6 @@
     if (container)
     {
         SPDisplayObjectContainer *container = (SPDisplayObjectContainer *)object;
-        SPMatrix *childMatrix = [SPMatrix matrixWithIdentity];
         
         for (SPDisplayObject *child in container)
         {
@@ -494,11 +717,11 @@
                 uint childBlendMode = child.blendMode;
                 if (childBlendMode == SPBlendModeAuto) childBlendMode = blendMode;
                 
-                [childMatrix copyFromMatrix:transformationMatrix];
-                [childMatrix prependMatrix:child.transformationMatrix];
+                SPMatrixValue childMatrix = SPMatrixValuePrepend(transformationMatrix,
+                                                                 child.transformationMatrix.matrixValue);
                 quadBatchID = [self compileObject:child intoArray:quadBatches atPosition:quadBatchID
-                                       withMatrix:childMatrix alpha:alpha * objectAlpha
-                                        blendMode:childBlendMode];
+                                       withMatrix:childMatrix scratchMatrix:scratchMatrix
+                                            alpha:alpha * objectAlpha blendMode:childBlendMode];
             }
         }
     }
@@ -510,22 +733,34 @@
         NSInteger numQuads = batch ? batch.numQuads : 1;
         
         SPQuadBatch *currentBatch = quadBatches[quadBatchID];
+        BOOL stateChange = batch ?
+            [currentBatch isStateChangeWithQuadBatch:batch alpha:alpha * objectAlpha blendMode:blendMode] :
+            [currentBatch isStateChangeWithTinted:tinted texture:texture alpha:alpha * objectAlpha
+                               premultipliedAlpha:pma blendMode:blendMode numQuads:numQuads];
         
-        if ([currentBatch isStateChangeWithTinted:tinted texture:texture alpha:alpha * objectAlpha
-                               premultipliedAlpha:pma blendMode:blendMode numQuads:numQuads])
+        if (stateChange)
         {
             quadBatchID++;
-            if (quadBatches.count <= quadBatchID) [quadBatches addObject:[SPQuadBatch quadBatch]];
+            if (quadBatches.count <= quadBatchID)
+            {
+                // new batches are owned by the same thread as the first one
+                SPQuadBatch *quadBatch = [SPQuadBatch quadBatch];
+                quadBatch.stampsChanges = quadBatches[0].stampsChanges;
+                [quadBatches addObject:quadBatch];
+            }
+
             currentBatch = quadBatches[quadBatchID];
             [currentBatch reset];
         }
         
+        scratchMatrix.matrixValue = transformationMatrix;
+
         if (quad)
             [currentBatch addQuad:quad alpha:alpha * objectAlpha blendMode:blendMode
-                           matrix:transformationMatrix];
+                           matrix:scratchMatrix];
         else
             [currentBatch addQuadBatch:batch alpha:alpha * objectAlpha blendMode:blendMode
-                                matrix:transformationMatrix];
+                                matrix:scratchMatrix];
     }
     else
     {
@@ -545,6 +780,45 @@
 
 #pragma mark Private
 
+- (NSInteger)indexOfTexture:(SPTexture *)texture
+{
+    // subtextures of an atlas share the same GL texture, and so do their slots
+    for (NSInteger i=0; i<_numTextures; ++i)
+        if (_textures[i].name == texture.name) return i;
+    
+    return -1;
+}
+
+- (uchar)slotForTexture:(SPTexture *)texture
+{
+    if (!texture) return 0;
+    
+    NSInteger slot = [self indexOfTexture:texture];
+    if (slot != -1) return (uchar)slot;
+    else if (_numTextures == _maxNumTextures && _maxNumTextures == 1)
+        return 0; // single-texture batches always drew everything with their first texture
+    else if (_numTextures == _maxNumTextures)
+    {
+        // the quad would silently show the texture of another slot
+        [NSException raise:SPExceptionInvalidOperation
+                    format:@"all texture slots are taken; check for a state change before adding quads"];
+        return 0;
+    }
+    else
+    {
+        _textures[_numTextures] = [texture retain];
+        return (uchar)_numTextures++;
+    }
+}
+
+- (void)releaseTextures
+{
+    for (NSInteger i=0; i<_numTextures; ++i)
+        SP_RELEASE_AND_NIL(_textures[i]);
+    
+    _numTextures = 0;
+}
+
 - (void)expand
 {
     NSInteger oldCapacity = self.capacity;
@@ -555,19 +829,13 @@
 {
     [self destroyBuffers];
 
-    NSInteger numVertices = _vertexData.numVertices;
-    NSInteger numIndices = numVertices / 4 * 6;
-    if (numVertices == 0) return;
+    if (_vertexData.numVertices == 0) return;
 
     glGenBuffers(1, &_vertexBufferName);
-    glGenBuffers(1, &_indexBufferName);
 
-    if (!_vertexBufferName || !_indexBufferName)
+    if (!_vertexBufferName)
         [NSException raise:SPExceptionOperationFailed format:@"could not create vertex buffers"];
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferName);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort) * numIndices, _indexData, GL_STATIC_DRAW);
-
     _syncRequired = YES;
 }
 
@@ -583,22 +851,196 @@
     {
         glDeleteBuffers(1, &_indexBufferName);
         _indexBufferName = 0;
+        _indexBufferCapacity = 0;
+    }
+}
+
+- (uint)indexBufferForNumQuads:(NSInteger)numQuads context:(SPContext *)context
+{
+    // the indices are the same for all batches, so they are shared via the context; only
+    // without one, each batch needs its own buffer
+
+    if (context) return [context quadIndexBufferForNumQuads:numQuads];
+
+    if (numQuads > _indexBufferCapacity)
+    {
+        NSInteger capacity = MIN(MAX(numQuads, self.capacity), MAX_QUADS_PER_DRAW);
+
+        if (!_indexBufferName)
+            glGenBuffers(1, &_indexBufferName);
+
+        if (!_indexBufferName)
+            [NSException raise:SPExceptionOperationFailed format:@"could not create index buffer"];
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferName);
+        [SPContext uploadQuadIndicesForNumQuads:capacity];
+
+        _indexBufferCapacity = capacity;
     }
+
+    return _indexBufferName;
 }
 
-- (void)syncBuffers
+- (void)syncBuffersWithFormat:(SPVertexFormat)format
 {
+    SP_PROFILE_ZONE("SPQuadBatch.syncBuffers");
+
     if (!_vertexBufferName)
         [self createBuffers];
 
     // don't use 'glBufferSubData'! It's much slower than uploading
     // everything via 'glBufferData', at least on the iPad 1.
 
+    NSInteger numVertices = _vertexData.numVertices;
+    NSInteger numBytes = SPVertexLayoutMake(format).stride * numVertices;
+    const void *vertices = [self packVerticesInFormat:format numVertices:numVertices];
+
     glBindBuffer(GL_ARRAY_BUFFER, _vertexBufferName);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(SPVertex) * _vertexData.numVertices,
-                 _vertexData.vertices, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, numBytes, vertices, GL_STATIC_DRAW);
+
+    SPContext.currentContext.numVertexBytesUploaded += numBytes;
 
+    _uploadedFormat = format;
     _syncRequired = NO;
 }
 
+- (const void *)packVerticesInFormat:(SPVertexFormat)format numVertices:(NSInteger)numVertices
+{
+    // the standard format is uploaded straight from the vertex data
+    if (format == SPVertexFormatStandard) return _vertexData.vertices;
+
+    NSInteger numBytes = SPVertexLayoutMake(format).stride * numVertices;
+    if (numBytes > _packedCapacity)
+    {
+        _packedVertices = realloc(_packedVertices, numBytes);
+        _packedCapacity = numBytes;
+    }
+
+    [_vertexData packVerticesInFormat:format intoBuffer:_packedVertices atIndex:0 numVertices:numVertices];
+
+    SPVertexLayout layout = SPVertexLayoutMake(format);
+    if (layout.textureSlot != -1)
+    {
+        char *target = (char *)_packedVertices + layout.textureSlot;
+        for (NSInteger i=0; i<numVertices; ++i, target += layout.stride)
+            *target = _textureSlots[i / 4];
+    }
+
+    return _packedVertices;
+}
+
+- (SPVertexFormat)vertexFormatForAlpha:(float)alpha
+{
+    // drop the options the current state doesn't allow
+    SPVertexFormat format = _vertexFormat & ~SPVertexFormatTextureSlot;
+    SPTexture *texture = _textures[0];
+
+    if (format != SPVertexFormatStandard)
+    {
+        if (_tinted || alpha != 1.0f || !texture) format &= ~SPVertexFormatNoColors;
+        if (texture)                              format &= ~SPVertexFormatNoTexCoords;
+
+        for (NSInteger i=0; i<_numTextures; ++i)
+            if (_textures[i].repeat) format &= ~SPVertexFormatShortTexCoords;
+    }
+
+    // only the shader of a batch with several textures reads the slots
+    if (_numTextures > 1) format |= SPVertexFormatTextureSlot;
+
+    return format;
+}
+
+@end
+
+@implementation SPQuadBatch (Internal)
+
+- (SPVertexData *)vertexData
+{
+    return _vertexData;
+}
+
++ (BOOL)compileChildrenOfContainer:(SPDisplayObjectContainer *)container inRange:(NSRange)range
+                         intoArray:(NSMutableArray<SPQuadBatch*> *)quadBatches
+{
+    // this mirrors what 'compileObject:intoArray:' does for the root object
+
+    NSInteger quadBatchID = 0;
+    uint blendMode = container.blendMode;
+    SPMatrix *scratchMatrix = [SPMatrix matrixWithIdentity];
+
+    if (quadBatches.count == 0)
+    {
+        // the batches are private to the calling thread
+        SPQuadBatch *quadBatch = [SPQuadBatch quadBatch];
+        quadBatch.stampsChanges = NO;
+        [quadBatches addObject:quadBatch];
+    }
+    else [quadBatches[0] reset];
+
+    for (NSInteger i=range.location; i<NSMaxRange(range); ++i)
+    {
+        SPDisplayObject *child = [container childAtIndex:i];
+        if (![child isRenderCacheable]) return NO;
+        else if ([child hasVisibleArea])
+        {
+            uint childBlendMode = child.blendMode;
+            if (childBlendMode == SPBlendModeAuto) childBlendMode = blendMode;
+
+            quadBatchID = [self compileObject:child intoArray:quadBatches atPosition:quadBatchID
+                                   withMatrix:child.transformationMatrix.matrixValue
+                                scratchMatrix:scratchMatrix alpha:1.0f blendMode:childBlendMode];
+        }
+    }
+
+    for (NSInteger i=quadBatches.count-1; i>quadBatchID; --i)
+        [quadBatches removeLastObject];
+
+    return YES;
+}
+
+- (SPQuadBatchBounds)boundsOfQuadsAtIndex:(NSInteger)quadID numQuads:(NSInteger)numQuads
+{
+    SPQuadBatchBounds bounds = SPQuadBatchBoundsEmpty();
+    SPVertex *vertices = _vertexData.vertices + quadID * 4;
+
+    for (NSInteger i=0, numVertices=numQuads*4; i<numVertices; ++i)
+    {
+        GLKVector2 position = vertices[i].position;
+        bounds.minX = MIN(bounds.minX, position.x);
+        bounds.minY = MIN(bounds.minY, position.y);
+        bounds.maxX = MAX(bounds.maxX, position.x);
+        bounds.maxY = MAX(bounds.maxY, position.y);
+    }
+
+    return bounds;
+}
+
+- (BOOL)quadsAreAxisAligned
+{
+    SPVertex *vertices = _vertexData.vertices;
+
+    for (NSInteger i=0; i<_numQuads; ++i)
+        if (!isAxisAlignedQuad(vertices + i * 4)) return NO;
+
+    return YES;
+}
+
+- (void)clipQuadsAtIndex:(NSInteger)quadID numQuads:(NSInteger)numQuads toBounds:(SPQuadBatchBounds)bounds
+{
+    SPVertex *vertices = _vertexData.vertices + quadID * 4;
+
+    for (NSInteger i=0; i<numQuads; ++i)
+        clipQuad(vertices + i * 4, bounds);
+
+    _syncRequired = YES;
+    [self markDirty:SPDirtyFlagVertices];
+}
+
+- (void)renderOverdrawWithMvpMatrix3D:(SPMatrix3D *)matrix alpha:(float)alpha brightness:(float)brightness
+{
+    _baseEffect.overdrawBrightness = brightness;
+    [self renderWithMvpMatrix3D:matrix alpha:alpha blendMode:SPBlendModeNormal];
+    _baseEffect.overdrawBrightness = 0.0f;
+}
+
 @end
@@ -0,0 +1,73 @@
+//
+//  SPQuadBatch_Internal.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPQuadBatch.h"
+
+@class SPDisplayObjectContainer;
+@class SPMatrix3D;
+
+/// An axis-aligned bounding box that is cheap to create and compare.
+typedef struct
+{
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+} SPQuadBatchBounds;
+
+/// Returns bounds that contain nothing; extending them by any point yields that point.
+SP_INLINE SPQuadBatchBounds SPQuadBatchBoundsEmpty(void)
+{
+    return (SPQuadBatchBounds){ FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+}
+
+/// Returns the union of two bounding boxes.
+SP_INLINE SPQuadBatchBounds SPQuadBatchBoundsUnion(SPQuadBatchBounds a, SPQuadBatchBounds b)
+{
+    return (SPQuadBatchBounds){ MIN(a.minX, b.minX), MIN(a.minY, b.minY),
+                                MAX(a.maxX, b.maxX), MAX(a.maxY, b.maxY) };
+}
+
+/// Indicates if two bounding boxes share a region with a positive area. Boxes that merely touch
+/// each other (like the tiles of a tile map) don't overlap.
+SP_INLINE BOOL SPQuadBatchBoundsOverlap(SPQuadBatchBounds a, SPQuadBatchBounds b)
+{
+    return a.minX < b.maxX && a.maxX > b.minX && a.minY < b.maxY && a.maxY > b.minY;
+}
+
+@interface SPQuadBatch (Internal)
+
+/// The raw vertex data of the batch; only the first 'numQuads * 4' vertices are in use.
+@property (nonatomic, readonly) SPVertexData *vertexData;
+
+/// Returns the bounds of a range of quads in the local coordinate system of the batch, without
+/// allocating any objects.
+- (SPQuadBatchBounds)boundsOfQuadsAtIndex:(NSInteger)quadID numQuads:(NSInteger)numQuads;
+
+/// Indicates if all quads are rectangles with edges parallel to the axes of the batch.
+- (BOOL)quadsAreAxisAligned;
+
+/// Cuts a range of axis-aligned quads to the given bounds, adjusting their texture coordinates and
+/// colors; quads outside the bounds are collapsed to a point.
+- (void)clipQuadsAtIndex:(NSInteger)quadID numQuads:(NSInteger)numQuads toBounds:(SPQuadBatchBounds)bounds;
+
+/// Draws the quads in a constant gray of the given brightness, blended additively, so that each
+/// pixel ends up as bright as often as it is covered. 'alpha' only affects the vertex format.
+- (void)renderOverdrawWithMvpMatrix3D:(SPMatrix3D *)matrix alpha:(float)alpha brightness:(float)brightness;
+
+/// Compiles a range of children of a container into an array of quad batches, in the local
+/// coordinate system of the container; batches inside that array are reused. This may be called
+/// from several threads at once for distinct ranges, as long as the display list is not modified.
+/// Returns NO (leaving the array incomplete) if one of the children is not render cacheable.
++ (BOOL)compileChildrenOfContainer:(SPDisplayObjectContainer *)container inRange:(NSRange)range
+                         intoArray:(NSMutableArray<SPQuadBatch*> *)quadBatches;
+
+@end
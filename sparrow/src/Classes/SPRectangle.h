@@ -10,6 +10,7 @@
 //
 
 #import <Sparrow/SparrowBase.h>
+#import <Sparrow/SPGeometryValues.h>
 #import <Sparrow/SPPoolObject.h>
 
 NS_ASSUME_NONNULL_BEGIN
@@ -45,6 +46,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// Factory method.
 + (instancetype)rectangleWithCGRect:(CGRect)rect;
 
+/// Factory method.
++ (instancetype)rectangleWithValue:(SPRectValue)value;
+
 /// -------------
 /// @name Methods
 /// -------------
@@ -111,6 +115,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// The height of the rectangle.
 @property (nonatomic, assign) float height;
 
+/// The rectangle as a value type.
+@property (nonatomic, assign) SPRectValue rectValue;
+
 /// The y coordinate of the rectangle.
 @property (nonatomic, assign) float top;
 
@@ -14,13 +14,6 @@
 #import "SPPoint.h"
 #import "SPRectangle.h"
 
-static GLKVector2 positions[] = {
-    (GLKVector2){ 0.0f, 0.0f },
-    (GLKVector2){ 1.0f, 0.0f },
-    (GLKVector2){ 0.0f, 1.0f },
-    (GLKVector2){ 1.0f, 1.0f }
-};
-
 @implementation SPRectangle
 
 #pragma mark Initialization
@@ -58,11 +51,16 @@ static GLKVector2 positions[] = {
                               width:rect.size.width height:rect.size.height] autorelease];
 }
 
++ (instancetype)rectangleWithValue:(SPRectValue)value
+{
+    return [[[self alloc] initWithX:value.x y:value.y width:value.width height:value.height] autorelease];
+}
+
 #pragma mark Methods
 
 - (BOOL)containsX:(float)x y:(float)y
 {
-    return x >= _x && y >= _y && x <= _x + _width && y <= _y + _height;
+    return SPRectValueContainsPoint(self.rectValue, x, y);
 }
 
 - (BOOL)containsPoint:(SPPoint *)point
@@ -86,61 +84,24 @@ static GLKVector2 positions[] = {
 - (BOOL)intersectsRectangle:(SPRectangle *)rectangle
 {
     if (!rectangle) return NO;
-    
-    float rX = rectangle->_x;
-    float rY = rectangle->_y;
-    float rWidth = rectangle->_width;
-    float rHeight = rectangle->_height;
-    
-    BOOL outside = 
-        (rX <= _x && rX + rWidth <= _x)  || (rX >= _x + _width && rX + rWidth >= _x + _width) ||
-        (rY <= _y && rY + rHeight <= _y) || (rY >= _y + _height && rY + rHeight >= _y + _height);
-    return !outside;
+    return SPRectValueIntersects(self.rectValue, rectangle.rectValue);
 }
 
 - (SPRectangle *)intersectionWithRectangle:(SPRectangle *)rectangle
 {
     if (!rectangle) return nil;
-    
-    float left   = MAX(_x, rectangle->_x);
-    float right  = MIN(_x + _width, rectangle->_x + rectangle->_width);
-    float top    = MAX(_y, rectangle->_y);
-    float bottom = MIN(_y + _height, rectangle->_y + rectangle->_height);
-    
-    if (left > right || top > bottom)
-        return [SPRectangle rectangleWithX:0 y:0 width:0 height:0];
-    else
-        return [SPRectangle rectangleWithX:left y:top width:right-left height:bottom-top];
+    return [SPRectangle rectangleWithValue:SPRectValueIntersection(self.rectValue, rectangle.rectValue)];
 }
 
 - (SPRectangle *)uniteWithRectangle:(SPRectangle *)rectangle
 {
     if (!rectangle) return [[self copy] autorelease];
-    
-    float left   = MIN(_x, rectangle->_x);
-    float right  = MAX(_x + _width, rectangle->_x + rectangle->_width);
-    float top    = MIN(_y, rectangle->_y);
-    float bottom = MAX(_y + _height, rectangle->_y + rectangle->_height);
-    return [SPRectangle rectangleWithX:left y:top width:right-left height:bottom-top];
+    return [SPRectangle rectangleWithValue:SPRectValueUnion(self.rectValue, rectangle.rectValue)];
 }
 
 - (SPRectangle *)boundsAfterTransformation:(SPMatrix *)matrix
 {
-    float minX = FLT_MAX, maxX = FLT_MIN;
-    float minY = FLT_MAX, maxY = FLT_MIN;
-    
-    for (int i=0; i<4; ++i)
-    {
-        SPPoint *transformedPoint = [matrix transformPointWithX:_width  * positions[i].x
-                                                              y:_height * positions[i].y];
-        
-        if (minX > transformedPoint.x) minX = transformedPoint.x;
-        if (maxX < transformedPoint.x) maxX = transformedPoint.x;
-        if (minY > transformedPoint.y) minY = transformedPoint.y;
-        if (maxY < transformedPoint.y) maxY = transformedPoint.y;
-    }
-    
-    return [SPRectangle rectangleWithX:minX y:minY width:maxX-minX height:maxY-minY];
+    return [SPRectangle rectangleWithValue:SPMatrixValueTransformRect(matrix.matrixValue, self.rectValue)];
 }
 
 - (void)inflateXBy:(float)dx yBy:(float)dy
@@ -267,6 +228,9 @@ static GLKVector2 positions[] = {
 - (SPPoint *)size { return [SPPoint pointWithX:_width y:_height]; }
 - (void)setSize:(SPPoint *)value { _width = value.x; _height = value.y; }
 
+- (SPRectValue)rectValue { return SPRectValueMake(_x, _y, _width, _height); }
+- (void)setRectValue:(SPRectValue)value { [self setX:value.x y:value.y width:value.width height:value.height]; }
+
 - (BOOL)isEmpty
 {
     return _width == 0 || _height == 0;
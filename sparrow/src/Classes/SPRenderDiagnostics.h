@@ -0,0 +1,124 @@
+//
+//  SPRenderDiagnostics.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import <Sparrow/SparrowBase.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class SPDisplayObject;
+
+/// The reasons that make SPRenderSupport end a batch and issue a draw call.
+typedef NS_ENUM(NSInteger, SPBatchBreakReason)
+{
+    /// The next quad uses a different texture.
+    SPBatchBreakReasonTexture,
+    /// The next quad uses a new texture, but all texture slots of the batch are taken.
+    SPBatchBreakReasonTextureSlots,
+    /// The next quad uses a different blend mode.
+    SPBatchBreakReasonBlendMode,
+    /// The next quad is tinted while the batch is not, or vice versa.
+    SPBatchBreakReasonTint,
+    /// The next quad uses a different premultiplied alpha setting.
+    SPBatchBreakReasonPremultipliedAlpha,
+    /// A clip rect was pushed or popped.
+    SPBatchBreakReasonClipRect,
+    /// A stencil mask was pushed or popped.
+    SPBatchBreakReasonMask,
+    /// A filter was applied to an object.
+    SPBatchBreakReasonFilter,
+    /// A 3D sprite was entered or left.
+    SPBatchBreakReasonSprite3D,
+    /// The render target was changed.
+    SPBatchBreakReasonRenderTarget,
+    /// An object that issues its own draw calls, e.g. a non-batchable quad batch or a canvas.
+    SPBatchBreakReasonCustomRendering,
+    /// Triangles of a mesh (e.g. a canvas) followed quads they can't share a batch with, or
+    /// vice versa.
+    SPBatchBreakReasonMesh,
+    /// A precompiled batch, e.g. of a flattened sprite, was drawn on its own.
+    SPBatchBreakReasonCompiledBatch,
+    /// The frame was complete.
+    SPBatchBreakReasonEndOfFrame,
+    /// 'finishQuadBatch' was called directly.
+    SPBatchBreakReasonExplicit,
+};
+
+/** ------------------------------------------------------------------------------------------------
+
+ Describes one batch that was drawn by SPRenderSupport, including the reason why it was ended.
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPBatchRecord : NSObject
+
+/// The reason why the batch was ended.
+@property (nonatomic, readonly) SPBatchBreakReason reason;
+
+/// The object that caused the batch to end, if there is one.
+@property (nonatomic, readonly, nullable) SPDisplayObject *object;
+
+/// The number of quads in the batch.
+@property (nonatomic, readonly) NSInteger numQuads;
+
+/// The number of vertex bytes that were uploaded to draw the batch.
+@property (nonatomic, readonly) NSInteger numVertexBytes;
+
+@end
+
+/** ------------------------------------------------------------------------------------------------
+
+ SPRenderDiagnostics records the batches SPRenderSupport draws within a frame, and why each of
+ them was ended. Use it to find out what drives up the number of draw calls.
+
+ Diagnostics are only recorded in builds that define `SP_RENDER_DIAGNOSTICS` (which is the
+ default for debug builds) and once they are enabled via `[SPRenderSupport recordsDiagnostics]`
+ or `[SPViewController recordsRenderDiagnostics]`. They are reset at the beginning of each frame.
+
+ The records can be queried directly or exported as JSON, e.g. to compare them between frames:
+
+    NSLog(@"%@", Sparrow.currentController.renderDiagnostics.JSONString);
+
+ Draw calls that objects issue on their own (like the passes of a filter) are not listed; only
+ the batch that had to be ended because of them.
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPRenderDiagnostics : NSObject
+
+/// -------------
+/// @name Methods
+/// -------------
+
+/// Returns the number of batches that were ended for a certain reason.
+- (NSInteger)numBatchesWithReason:(SPBatchBreakReason)reason;
+
+/// Returns a short, human-readable name of a reason, as used in the JSON output.
++ (NSString *)nameOfReason:(SPBatchBreakReason)reason;
+
+/// ----------------
+/// @name Properties
+/// ----------------
+
+/// The batches of the current frame, in the order they were drawn.
+@property (nonatomic, readonly) NSArray<SPBatchRecord*> *batches;
+
+/// The number of quads in all batches.
+@property (nonatomic, readonly) NSInteger numQuads;
+
+/// The number of vertex bytes uploaded for all batches.
+@property (nonatomic, readonly) NSInteger numVertexBytes;
+
+/// A JSON object with the totals, the number of batches per reason and the list of batches.
+@property (nonatomic, readonly) NSString *JSONString;
+
+@end
+
+NS_ASSUME_NONNULL_END
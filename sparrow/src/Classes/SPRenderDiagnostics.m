@@ -0,0 +1,197 @@
+//
+//  SPRenderDiagnostics.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPDisplayObject.h"
+#import "SPMacros.h"
+#import "SPRenderDiagnostics.h"
+#import "SPRenderDiagnostics_Internal.h"
+
+// --- private constants ---------------------------------------------------------------------------
+
+#define NUM_REASONS (SPBatchBreakReasonExplicit + 1)
+
+static NSString *const reasonNames[NUM_REASONS] = {
+    @"texture", @"textureSlots", @"blendMode", @"tint", @"premultipliedAlpha", @"clipRect",
+    @"mask", @"filter", @"sprite3D", @"renderTarget", @"customRendering", @"mesh",
+    @"compiledBatch", @"endOfFrame", @"explicit"
+};
+
+// --- SPBatchRecord -------------------------------------------------------------------------------
+
+@implementation SPBatchRecord
+
+- (instancetype)initWithReason:(SPBatchBreakReason)reason object:(SPDisplayObject *)object
+                      numQuads:(NSInteger)numQuads numVertexBytes:(NSInteger)numBytes
+{
+    if ((self = [super init]))
+    {
+        _reason = reason;
+        _object = [object retain];
+        _numQuads = numQuads;
+        _numVertexBytes = numBytes;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_object release];
+    [super dealloc];
+}
+
+- (NSDictionary *)JSONObject
+{
+    NSMutableDictionary *json = [NSMutableDictionary dictionaryWithDictionary:@{
+        @"reason": [SPRenderDiagnostics nameOfReason:_reason],
+        @"numQuads": @(_numQuads),
+        @"numVertexBytes": @(_numVertexBytes)
+    }];
+
+    if (_object)
+    {
+        json[@"class"] = NSStringFromClass([_object class]);
+        if (_object.name) json[@"name"] = _object.name;
+    }
+
+    return json;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"[SPBatchRecord: reason=%@, numQuads=%ld, object=%@]",
+            [SPRenderDiagnostics nameOfReason:_reason], (long)_numQuads, _object];
+}
+
+@end
+
+// --- class implementation ------------------------------------------------------------------------
+
+@implementation SPRenderDiagnostics
+{
+    NSMutableArray<SPBatchRecord*> *_batches;
+    NSMutableArray<SPBatchRecord*> *_pendingRecords;
+    NSInteger _numBatchesPerReason[NUM_REASONS];
+    NSInteger _numQuads;
+    NSInteger _numVertexBytes;
+}
+
+#pragma mark Initialization
+
+- (instancetype)init
+{
+    if ((self = [super init]))
+    {
+        _batches = [[NSMutableArray alloc] init];
+        _pendingRecords = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_batches release];
+    [_pendingRecords release];
+    [super dealloc];
+}
+
+#pragma mark Methods
+
+- (NSInteger)numBatchesWithReason:(SPBatchBreakReason)reason
+{
+    return reason >= 0 && reason < NUM_REASONS ? _numBatchesPerReason[reason] : 0;
+}
+
++ (NSString *)nameOfReason:(SPBatchBreakReason)reason
+{
+    return reason >= 0 && reason < NUM_REASONS ? reasonNames[reason] : @"unknown";
+}
+
+#pragma mark Properties
+
+- (NSArray<SPBatchRecord*> *)batches
+{
+    return [[_batches copy] autorelease];
+}
+
+- (NSString *)JSONString
+{
+    NSMutableDictionary *reasons = [NSMutableDictionary dictionary];
+    for (NSInteger i=0; i<NUM_REASONS; ++i)
+        if (_numBatchesPerReason[i]) reasons[reasonNames[i]] = @(_numBatchesPerReason[i]);
+
+    NSMutableArray *batches = [NSMutableArray arrayWithCapacity:_batches.count];
+    for (SPBatchRecord *record in _batches)
+        [batches addObject:[record JSONObject]];
+
+    NSDictionary *json = @{
+        @"numDrawCalls": @(_batches.count),
+        @"numQuads": @(_numQuads),
+        @"numVertexBytes": @(_numVertexBytes),
+        @"reasons": reasons,
+        @"batches": batches
+    };
+
+    NSData *data = [NSJSONSerialization dataWithJSONObject:json options:NSJSONWritingPrettyPrinted
+                                                     error:nil];
+    return [[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] autorelease];
+}
+
+@end
+
+@implementation SPRenderDiagnostics (Internal)
+
+- (void)reset
+{
+    [_batches removeAllObjects];
+    [_pendingRecords removeAllObjects];
+    memset(_numBatchesPerReason, 0, sizeof(_numBatchesPerReason));
+    _numQuads = _numVertexBytes = 0;
+}
+
+- (void)setReason:(SPBatchBreakReason)reason object:(SPDisplayObject *)object
+    forPendingBatchAtIndex:(NSInteger)index
+{
+    SPBatchRecord *record = [[SPBatchRecord alloc] initWithReason:reason object:object
+                                                         numQuads:0 numVertexBytes:0];
+    while (_pendingRecords.count <= index)
+        [_pendingRecords addObject:(id)[NSNull null]];
+
+    _pendingRecords[index] = record;
+    [record release];
+}
+
+- (void)recordPendingBatchAtIndex:(NSInteger)index numQuads:(NSInteger)numQuads
+                   numVertexBytes:(NSInteger)numBytes
+{
+    SPBatchRecord *record = index < _pendingRecords.count ? _pendingRecords[index] : nil;
+
+    if ([record isKindOfClass:[SPBatchRecord class]])
+        [self recordBatchWithReason:record.reason object:record.object
+                           numQuads:numQuads numVertexBytes:numBytes];
+    else
+        [self recordBatchWithReason:SPBatchBreakReasonExplicit object:nil
+                           numQuads:numQuads numVertexBytes:numBytes];
+}
+
+- (void)recordBatchWithReason:(SPBatchBreakReason)reason object:(SPDisplayObject *)object
+                     numQuads:(NSInteger)numQuads numVertexBytes:(NSInteger)numBytes
+{
+    SPBatchRecord *record = [[SPBatchRecord alloc] initWithReason:reason object:object
+                                                         numQuads:numQuads numVertexBytes:numBytes];
+    [_batches addObject:record];
+    [record release];
+
+    _numBatchesPerReason[reason] += 1;
+    _numQuads += numQuads;
+    _numVertexBytes += numBytes;
+}
+
+@end
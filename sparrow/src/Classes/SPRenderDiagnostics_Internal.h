@@ -0,0 +1,32 @@
+//
+//  SPRenderDiagnostics_Internal.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPRenderDiagnostics.h"
+
+@interface SPRenderDiagnostics (Internal)
+
+/// Removes all records; called at the beginning of each frame.
+- (void)reset;
+
+/// Saves the reason why a pending batch was ended. Batches are kept pending until they are drawn,
+/// so that quads may still be moved into them; 'index' is relative to the first pending batch.
+- (void)setReason:(SPBatchBreakReason)reason object:(SPDisplayObject *)object
+    forPendingBatchAtIndex:(NSInteger)index;
+
+/// Adds a record for a pending batch that was just drawn, using the reason saved for it.
+- (void)recordPendingBatchAtIndex:(NSInteger)index numQuads:(NSInteger)numQuads
+                   numVertexBytes:(NSInteger)numBytes;
+
+/// Adds a record for a batch that was drawn right away.
+- (void)recordBatchWithReason:(SPBatchBreakReason)reason object:(SPDisplayObject *)object
+                     numQuads:(NSInteger)numQuads numVertexBytes:(NSInteger)numBytes;
+
+@end
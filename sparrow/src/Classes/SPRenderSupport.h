@@ -11,16 +11,21 @@
 
 #import <Sparrow/SparrowBase.h>
 #import <Sparrow/SPMacros.h>
+#import <Sparrow/SPVertexData.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
 @class SPDisplayObject;
+@class SPIndexData;
 @class SPMatrix;
 @class SPMatrix3D;
+@class SPOverdrawAnalysis;
 @class SPQuad;
 @class SPQuadBatch;
+@class SPRenderDiagnostics;
 @class SPTexture;
 @class SPVector3D;
+@class SPVertexData;
 
 /** ------------------------------------------------------------------------------------------------
 
@@ -61,9 +66,22 @@ NS_ASSUME_NONNULL_BEGIN
 /// 16-20 quads.)
 - (void)batchQuadBatch:(SPQuadBatch *)quadBatch;
 
-/// Renders the current quad batch and resets it.
+/// Adds untextured triangles, described by vertex and index data in the local coordinate system
+/// of 'object', to a batch that combines them with other meshes and untextured quads. Alpha,
+/// blend mode and modelview matrix are taken from the current render state. This is how small
+/// canvases are rendered, so that many vector shapes can be drawn with a single draw call.
+- (void)batchVertexData:(SPVertexData *)vertexData indexData:(SPIndexData *)indexData
+                 object:(SPDisplayObject *)object;
+
+/// Renders the current quad batch and all batches that are still pending (see `reordersBatches`),
+/// and resets them.
 - (void)finishQuadBatch;
 
+/// Renders quad batches that were compiled in the local coordinate system of the current object
+/// (e.g. via `[SPQuadBatch compileObject:]`), using the current render state. The current batch
+/// is finished first.
+- (void)renderQuadBatches:(NSArray<SPQuadBatch*> *)quadBatches;
+
 /// Clears all vertex and index buffers, releasing the associated memory. Useful in low-memory
 /// situations. Don't call from within a render method!
 - (void)purgeBuffers;
@@ -87,6 +105,24 @@ NS_ASSUME_NONNULL_BEGIN
 /// to keep the statistics display in sync.
 - (void)addDrawCalls:(NSInteger)count;
 
+/// Raises the number of culled objects by a specific value.
+- (void)addCulledObjects:(NSInteger)count;
+
+/// Indicates if a rectangle (in the current modelview coordinate system) is at least partly inside
+/// the visible area, i.e. the area of the projection matrix intersected with the current clip
+/// rect. Within 3D transformations, this always returns `YES`.
+- (BOOL)isRectangleVisible:(SPRectangle *)rectangle;
+
+/// Looks for descendants of an object that are completely hidden behind opaque quads drawn after
+/// them, so that their containers skip them within this frame. Call this after `nextFrame`, right
+/// before the object is rendered with the current state; SPViewController does so for the stage.
+/// This has no effect unless `cullsOccludedObjects` is enabled.
+- (void)findOccludedObjectsOf:(SPDisplayObject *)object;
+
+/// Indicates if an object was found to be hidden behind opaque quads since the last call to
+/// `nextFrame`; see `findOccludedObjectsOf:`.
+- (BOOL)isObjectOccluded:(SPDisplayObject *)object;
+
 /// Sets up the projection matrices for 2D and 3D rendering.
 ///
 /// The first 4 parameters define which area of the stage you want to view. The camera
@@ -159,9 +195,17 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)popClipRect;
 
 /// Updates the scissor rectangle using the current clipping rectangle. This method is called
-/// automatically when either the projection matrix or the clipping rectangle changes.
+/// automatically when either the projection matrix or the clipping rectangle changes (unless
+/// `clipsQuads` is enabled, in which case the scissor rectangle is updated when a batch is drawn).
 - (void)applyClipRect;
 
+/// Indicates if quads within a clipping rectangle are cut to that rectangle on the CPU while they
+/// are batched, instead of ending the batch and changing the scissor rectangle. That way, many
+/// clipped sprites (like the panes of a scrolling UI) can share a single draw call. Rotated quads
+/// still fall back to the scissor rectangle. Since the quads are changed before they are drawn,
+/// this is opt-in. Default: `NO`.
+@property (nonatomic, assign) BOOL clipsQuads;
+
 /// -------------------
 /// @name Stencil Masks
 /// -------------------
@@ -172,11 +216,16 @@ NS_ASSUME_NONNULL_BEGIN
 ///
 /// If 'mask' is part of the display list, it will be drawn at its conventional stage coordinates.
 /// Otherwise, it will be drawn with the current modelview matrix.
+///
+/// A quad that ends up as an axis-aligned rectangle in stage coordinates is not drawn at all;
+/// it is pushed as a clip rect instead (see `pushClipRect:`), which doesn't touch the stencil
+/// buffer; with `clipsQuads` enabled, it doesn't end the current batch either.
 - (void)pushMask:(SPDisplayObject *)mask;
 
 /// Redraws the most recently pushed mask into the stencil buffer, decrementing the buffer on each
 /// used pixel. This effectively removes the object from the stencil buffer, restoring the previous
-/// state. The stencil reference value will be decremented.
+/// state. The stencil reference value will be decremented. (If the mask was replaced by a clip
+/// rect, that clip rect is popped instead.)
 - (void)popMask;
 
 /// ----------------
@@ -225,6 +274,67 @@ NS_ASSUME_NONNULL_BEGIN
 /// Indicates the number of OpenGL ES draw calls since the last call to `nextFrame`.
 @property (nonatomic, readonly) NSInteger numDrawCalls;
 
+/// Indicates if quads may be moved to an earlier batch with the same state, as long as they don't
+/// overlap any of the batches drawn in between. This saves draw calls when differently textured
+/// objects are interleaved in the display list, e.g. the icons and labels of a list. The result
+/// looks exactly the same as with the original drawing order. Finished batches then need their
+/// bounds computed, though, so only enable it if that pays off. Default: `NO`.
+@property (nonatomic, assign) BOOL reordersBatches;
+
+/// The number of different textures the quads of one batch may use. Quads that only differ in
+/// their texture are then drawn with a single draw call, by a shader that picks the texture of
+/// each vertex. The value is limited by `[SPBaseEffect maxNumTextures]`. Default: 1.
+@property (nonatomic, assign) NSInteger maxNumTexturesPerBatch;
+
+/// The vertex format of the batches that are used for rendering; see `[SPQuadBatch vertexFormat]`.
+/// Default: SPVertexFormatStandard.
+@property (nonatomic, assign) SPVertexFormat vertexFormat;
+
+/// The number of times quads were moved to an earlier batch since the last call to `nextFrame`.
+/// Each of those saved a draw call.
+@property (nonatomic, readonly) NSInteger numMergedBatches;
+
+/// The number of times quads could not be moved to an earlier batch with the same state since the
+/// last call to `nextFrame`, because they overlapped a batch in between.
+@property (nonatomic, readonly) NSInteger numRejectedMerges;
+
+/// The number of bytes uploaded to vertex buffers of the current context since the last call to
+/// `nextFrame`.
+@property (nonatomic, readonly) NSInteger numVertexBytesUploaded;
+
+/// The number of display objects that were skipped since the last call to `nextFrame`, because
+/// they were outside the visible area (see `[SPDisplayObjectContainer cullsChildren]`).
+@property (nonatomic, readonly) NSInteger numCulledObjects;
+
+/// The number of masks that were replaced by clip rects since the last call to `nextFrame`,
+/// because they were axis-aligned rectangles (see `pushMask:`).
+@property (nonatomic, readonly) NSInteger numClippingMasks;
+
+/// The number of masks that were drawn into the stencil buffer since the last call to `nextFrame`.
+@property (nonatomic, readonly) NSInteger numStencilMasks;
+
+/// Indicates if objects that are hidden behind opaque quads are skipped, e.g. the layers beneath a
+/// full-screen background. A quad is opaque if it is drawn with full alpha and the normal blend
+/// mode, and if its texture is opaque (see `[SPTexture opaque]`); it only hides objects it covers
+/// completely, as long as it is not rotated, masked, clipped or filtered. Default: `NO`.
+@property (nonatomic, assign) BOOL cullsOccludedObjects;
+
+/// The number of objects that were found to be hidden behind opaque quads since the last call to
+/// `nextFrame`.
+@property (nonatomic, readonly) NSInteger numOccludedObjects;
+
+/// Indicates if the batches of each frame are recorded, along with the reason why each of them was
+/// ended; see `diagnostics`. This has no effect in builds in which `SP_RENDER_DIAGNOSTICS` is
+/// disabled (the default for release builds). Default: `NO`.
+@property (nonatomic, assign) BOOL recordsDiagnostics;
+
+/// The batches drawn since the last call to `nextFrame`, or `nil` if `recordsDiagnostics` is
+/// disabled.
+@property (nonatomic, readonly, nullable) SPRenderDiagnostics *diagnostics;
+
+/// Measures how often each pixel is drawn within a frame; see SPOverdrawAnalysis. Default: `nil`.
+@property (nonatomic, strong, nullable) SPOverdrawAnalysis *overdrawAnalysis;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -10,24 +10,47 @@
 //
 
 #import "SparrowClass.h"
+#import "SPBaseEffect.h"
 #import "SPBlendMode.h"
 #import "SPContext.h"
+#import "SPContext_Internal.h"
 #import "SPDisplayObject.h"
+#import "SPDisplayObjectContainer.h"
+#import "SPIndexData.h"
 #import "SPMacros.h"
 #import "SPMatrix.h"
 #import "SPMatrix3D.h"
+#import "SPMeshBatch.h"
 #import "SPOpenGL.h"
+#import "SPOverdrawAnalysis.h"
+#import "SPOverdrawAnalysis_Internal.h"
 #import "SPPoint.h"
+#import "SPProfiler.h"
 #import "SPQuad.h"
 #import "SPQuadBatch.h"
+#import "SPQuadBatch_Internal.h"
 #import "SPRectangle.h"
+#import "SPRenderDiagnostics.h"
+#import "SPRenderDiagnostics_Internal.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
+#import "SPSprite.h"
+#import "SPSprite3D.h"
 #import "SPStage.h"
 #import "SPTexture.h"
 #import "SPVector3D.h"
 #import "SPVertexData.h"
 
 #define RENDER_TARGET_NAME @"Sparrow.renderTarget"
+#define MAX_PENDING_QUAD_BATCHES 16
+#define MAX_OCCLUDERS 16
+#define MAX_MESH_VERTICES 65536
+
+#if SP_RENDER_DIAGNOSTICS
+  #define RECORD_DIAGNOSTICS(...) if (_diagnostics) { __VA_ARGS__; }
+#else
+  #define RECORD_DIAGNOSTICS(...)
+#endif
 
 #pragma mark - SPRenderState
 
@@ -82,6 +105,63 @@
 
 #pragma mark - SPRenderSupport
 
+static SPQuadBatchBounds projectRectangle(SPMatrixValue matrix, SPRectValue rectangle)
+{
+    SPRectValue bounds = SPMatrixValueTransformRect(matrix, rectangle);
+    return (SPQuadBatchBounds){ bounds.x, bounds.y, bounds.x + bounds.width, bounds.y + bounds.height };
+}
+
+#if SP_RENDER_DIAGNOSTICS
+
+static SPBatchBreakReason breakReason(SPQuadBatch *quadBatch, BOOL tinted, SPTexture *texture,
+                                      BOOL pma, uint blendMode)
+{
+    // mirrors the checks of '[SPQuadBatch isStateChangeWith...]', for a state change that is known
+    if (!quadBatch.texture != !texture)              return SPBatchBreakReasonTexture;
+    else if (quadBatch.blendMode != blendMode)       return SPBatchBreakReasonBlendMode;
+    else if (quadBatch.premultipliedAlpha != pma)    return SPBatchBreakReasonPremultipliedAlpha;
+    else if (quadBatch.tinted != tinted)             return SPBatchBreakReasonTint;
+    else if (quadBatch.maxNumTextures > 1)           return SPBatchBreakReasonTextureSlots;
+    else                                             return SPBatchBreakReasonTexture;
+}
+
+#endif
+
+static float boundsArea(SPQuadBatchBounds bounds)
+{
+    return (bounds.maxX - bounds.minX) * (bounds.maxY - bounds.minY);
+}
+
+SP_INLINE BOOL rectsEqual(SPRectValue rect, SPRectValue other)
+{
+    return rect.x == other.x && rect.y == other.y && rect.width == other.width && rect.height == other.height;
+}
+
+static BOOL isOpaqueQuad(SPQuad *quad, SPMatrixValue matrix, float alpha, uint blendMode)
+{
+    // only axis-aligned quads cover exactly their bounds; trimmed textures don't fill the quad
+    SPTexture *texture = quad.texture;
+
+    if (alpha != 1.0f || (blendMode != SPBlendModeNormal && blendMode != SPBlendModeNone)) return NO;
+    else if (texture && (!texture.opaque || texture.frame)) return NO;
+    else if (!((matrix.b == 0.0f && matrix.c == 0.0f) || (matrix.a == 0.0f && matrix.d == 0.0f))) return NO;
+
+    for (NSInteger i=0; i<4; ++i)
+        if ([quad alphaOfVertex:i] != 1.0f) return NO;
+
+    return YES;
+}
+
+static SPQuadBatch *createQuadBatch(NSInteger maxNumTextures, SPVertexFormat vertexFormat)
+{
+    // the batches are refilled every frame, so they stream their vertices
+    SPQuadBatch *quadBatch = [SPQuadBatch quadBatch];
+    quadBatch.dynamic = YES;
+    quadBatch.maxNumTextures = maxNumTextures;
+    quadBatch.vertexFormat = vertexFormat;
+    return quadBatch;
+}
+
 @implementation SPRenderSupport
 {
     SPMatrix *_projectionMatrix;
@@ -104,11 +184,38 @@
     NSInteger _quadBatchIndex;
     NSInteger _quadBatchSize;
 
+    NSInteger _maxNumTexturesPerBatch;
+    SPVertexFormat _vertexFormat;
+    BOOL _reordersBatches;
+    NSInteger _pendingQuadBatchIndex;
+    SPQuadBatchBounds _pendingBounds[MAX_PENDING_QUAD_BATCHES];
+    SPMeshBatch *_meshBatch;
+    NSInteger _numMergedBatches;
+    NSInteger _numRejectedMerges;
+    NSInteger _numVertexBytesUploadedBeforeFrame;
+    NSInteger _numCulledObjects;
+    BOOL _cullsOccludedObjects;
+    CFMutableSetRef _occludedObjects;
+    SPQuadBatchBounds _occluders[MAX_OCCLUDERS];
+    NSInteger _numOccluders;
+    SPRenderDiagnostics *_diagnostics;
+    SPOverdrawAnalysis *_overdrawAnalysis;
+    BOOL _heatTextureCleared;
+
     NSMutableArray<SPRectangle*> *_clipRectStack;
     NSInteger _clipRectStackSize;
+    BOOL _clipsQuads;
+    BOOL _pendingScissorEnabled;
+    SPRectValue _pendingScissorClipRect;
+    BOOL _scissorValid;
+    BOOL _scissorEnabled;
+    SPRectValue _scissorClipRect;
     
     NSMutableArray<SPDisplayObject*> *_maskStack;
     NSInteger _maskStackSize;
+    NSMutableIndexSet *_clippingMaskIndices;
+    NSInteger _numClippingMasks;
+    NSInteger _numStencilMasks;
     uint _stencilReferenceValue;
 }
 
@@ -132,16 +239,25 @@
         _matrix3DStack = [[NSMutableArray alloc] init];
         _matrix3DStackSize = 0;
 
-        _quadBatches = [[NSMutableArray alloc] initWithObjects:[SPQuadBatch quadBatch], nil];
+        _maxNumTexturesPerBatch = 1;
+        _quadBatches = [[NSMutableArray alloc] initWithObjects:createQuadBatch(1, SPVertexFormatStandard), nil];
         _quadBatchIndex = 0;
         _quadBatchSize = 1;
         _quadBatchTop = _quadBatches[0];
 
+        _reordersBatches = NO;
+        _pendingQuadBatchIndex = 0;
+        _pendingBounds[0] = SPQuadBatchBoundsEmpty();
+
+        _meshBatch = [[SPMeshBatch alloc] init];
+
         _clipRectStack = [[NSMutableArray alloc] init];
         _clipRectStackSize = 0;
+        _clipsQuads = NO;
         
         _maskStack = [[NSMutableArray alloc] init];
         _maskStackSize = 0;
+        _clippingMaskIndices = [[NSMutableIndexSet alloc] init];
 
         [self setProjectionMatrixWithX:0 y:0 width:320 height:480];
     }
@@ -158,8 +274,13 @@
     [_matrix3DStack release];
     [_stateStack release];
     [_quadBatches release];
+    [_meshBatch release];
     [_clipRectStack release];
     [_maskStack release];
+    [_clippingMaskIndices release];
+    [_diagnostics release];
+    [_overdrawAnalysis release];
+    if (_occludedObjects) CFRelease(_occludedObjects);
     [super dealloc];
 }
 
@@ -169,11 +290,16 @@
 {
     [_quadBatches removeAllObjects];
 
-    _quadBatchTop = [SPQuadBatch quadBatch];
+    _quadBatchTop = createQuadBatch(_maxNumTexturesPerBatch, _vertexFormat);
     [_quadBatches addObject:_quadBatchTop];
 
     _quadBatchIndex = 0;
     _quadBatchSize = 1;
+    _pendingQuadBatchIndex = 0;
+    _pendingBounds[0] = SPQuadBatchBoundsEmpty();
+
+    SP_RELEASE_AND_NIL(_meshBatch);
+    _meshBatch = [[SPMeshBatch alloc] init];
 }
 
 - (void)clear
@@ -211,6 +337,37 @@
     _numDrawCalls += count;
 }
 
+- (void)addCulledObjects:(NSInteger)count
+{
+    _numCulledObjects += count;
+}
+
+- (BOOL)isRectangleVisible:(SPRectangle *)rectangle
+{
+    return [self isRectValueVisible:rectangle.rectValue];
+}
+
+- (void)findOccludedObjectsOf:(SPDisplayObject *)object
+{
+    if (!_cullsOccludedObjects || _matrix3DStackSize > 0) return;
+    if (![object isKindOfClass:[SPDisplayObjectContainer class]]) return;
+
+    SP_PROFILE_ZONE("SPRenderSupport.findOccludedObjects");
+
+    if (!_occludedObjects) _occludedObjects = CFSetCreateMutable(NULL, 0, NULL);
+    _numOccluders = 0;
+
+    [self findOccludedChildrenOf:(SPDisplayObjectContainer *)object
+                      withMatrix:_stateStackTop->_modelViewMatrix.matrixValue
+                           alpha:_stateStackTop->_alpha blendMode:_stateStackTop->_blendMode
+                      canOcclude:YES];
+}
+
+- (BOOL)isObjectOccluded:(SPDisplayObject *)object
+{
+    return _occludedObjects && CFSetContainsValue(_occludedObjects, object);
+}
+
 - (void)setProjectionMatrixWithX:(float)x y:(float)y width:(float)width height:(float)height
                       stageWidth:(float)stageWidth stageHeight:(float)stageHeight
                        cameraPos:(nullable SPVector3D *)cameraPos
@@ -281,11 +438,27 @@
     [self trimQuadBatches];
 
     _clipRectStackSize = 0;
+    _pendingScissorEnabled = NO;
+    _scissorValid = NO;
     _stateStackIndex = 0;
     _quadBatchIndex = 0;
+    _pendingQuadBatchIndex = 0;
+    _pendingBounds[0] = SPQuadBatchBoundsEmpty();
     _numDrawCalls = 0;
+    _numMergedBatches = 0;
+    _numRejectedMerges = 0;
+    _numCulledObjects = 0;
+    _numClippingMasks = 0;
+    _numStencilMasks = 0;
+    _numVertexBytesUploadedBeforeFrame = SPContext.currentContext.numVertexBytesUploaded;
     _quadBatchTop = _quadBatches[0];
     _stateStackTop = _stateStack[0];
+
+    [_diagnostics reset];
+    [_overdrawAnalysis reset];
+    _heatTextureCleared = NO;
+
+    if (_occludedObjects) CFSetRemoveAllValues(_occludedObjects);
 }
 
 - (void)trimQuadBatches
@@ -305,14 +478,44 @@
     uint blendMode = _stateStackTop->_blendMode;
     SPMatrix *modelViewMatrix = _stateStackTop->_modelViewMatrix;
 
-    if ([_quadBatchTop isStateChangeWithTinted:quad.tinted texture:quad.texture alpha:alpha
-                            premultipliedAlpha:quad.premultipliedAlpha blendMode:blendMode
-                                      numQuads:1])
+    if (_meshBatch.numVertices)
     {
-        [self finishQuadBatch]; // next batch
+        // untextured quads may join the triangles of a canvas
+        if (!quad.texture && ![_meshBatch isStateChangeWithBlendMode:blendMode numVertices:4])
+        {
+            [self prepareScissorWithClippedContent:NO];
+            [_meshBatch addQuad:quad alpha:alpha blendMode:blendMode matrix:modelViewMatrix];
+            return;
+        }
+
+        RECORD_DIAGNOSTICS([self setReason:SPBatchBreakReasonMesh object:quad]);
+        [self renderPendingQuadBatches];
+    }
+
+    BOOL clipsQuad = [self prepareClippingOfQuadBatch:nil];
+
+    BOOL stateChange = [_quadBatchTop isStateChangeWithTinted:quad.tinted texture:quad.texture alpha:alpha
+                                           premultipliedAlpha:quad.premultipliedAlpha blendMode:blendMode
+                                                     numQuads:1];
+    if (stateChange)
+    {
+        RECORD_DIAGNOSTICS([self setReason:breakReason(_quadBatchTop, quad.tinted || alpha != 1.0f,
+                                                       quad.texture, quad.premultipliedAlpha, blendMode)
+                                    object:quad]);
+        [self advanceQuadBatch]; // next batch
     }
 
     [_quadBatchTop addQuad:quad alpha:alpha blendMode:blendMode matrix:modelViewMatrix];
+
+    if (clipsQuad)
+        [_quadBatchTop clipQuadsAtIndex:_quadBatchTop.numQuads - 1 numQuads:1 toBounds:[self clipBounds]];
+
+    if (_overdrawAnalysis)
+        [self analyzeOverdrawOfQuadBatch:_quadBatchTop fromIndex:_quadBatchTop.numQuads - 1 numQuads:1
+                                  matrix:_projectionMatrix object:quad];
+
+    if (_reordersBatches && stateChange)
+        [self mergeQuadBatchTop];
 }
 
 - (void)batchQuadBatch:(SPQuadBatch *)quadBatch
@@ -320,42 +523,211 @@
     float alpha = _stateStackTop->_alpha;
     uint blendMode = _stateStackTop->_blendMode;
     SPMatrix *modelViewMatrix = _stateStackTop->_modelViewMatrix;
+
+    if (_meshBatch.numVertices)
+    {
+        if (!quadBatch.texture &&
+            ![_meshBatch isStateChangeWithBlendMode:blendMode numVertices:quadBatch.numQuads * 4])
+        {
+            [self prepareScissorWithClippedContent:NO];
+            [_meshBatch addQuadBatch:quadBatch alpha:alpha blendMode:blendMode matrix:modelViewMatrix];
+            return;
+        }
+
+        RECORD_DIAGNOSTICS([self setReason:SPBatchBreakReasonMesh object:quadBatch]);
+        [self renderPendingQuadBatches];
+    }
+
+    BOOL clipsQuads = [self prepareClippingOfQuadBatch:quadBatch];
     
-    if ([_quadBatchTop isStateChangeWithTinted:quadBatch.tinted texture:quadBatch.texture
-                                         alpha:quadBatch.alpha premultipliedAlpha:quadBatch.premultipliedAlpha
-                                     blendMode:quadBatch.blendMode numQuads:quadBatch.numQuads])
+    BOOL stateChange = [_quadBatchTop isStateChangeWithQuadBatch:quadBatch alpha:quadBatch.alpha
+                                                       blendMode:quadBatch.blendMode];
+    if (stateChange)
     {
-        [self finishQuadBatch]; // next batch
+        RECORD_DIAGNOSTICS([self setReason:breakReason(_quadBatchTop, quadBatch.tinted || quadBatch.alpha != 1.0f,
+                                                       quadBatch.texture, quadBatch.premultipliedAlpha,
+                                                       quadBatch.blendMode)
+                                    object:quadBatch]);
+        [self advanceQuadBatch]; // next batch
     }
     
     [_quadBatchTop addQuadBatch:quadBatch alpha:alpha blendMode:blendMode matrix:modelViewMatrix];
+
+    if (clipsQuads)
+        [_quadBatchTop clipQuadsAtIndex:_quadBatchTop.numQuads - quadBatch.numQuads
+                               numQuads:quadBatch.numQuads toBounds:[self clipBounds]];
+
+    if (_overdrawAnalysis)
+        [self analyzeOverdrawOfQuadBatch:_quadBatchTop fromIndex:_quadBatchTop.numQuads - quadBatch.numQuads
+                                numQuads:quadBatch.numQuads matrix:_projectionMatrix object:quadBatch];
+
+    if (_reordersBatches && stateChange)
+        [self mergeQuadBatchTop];
 }
 
-- (void)finishQuadBatch
+- (void)batchVertexData:(SPVertexData *)vertexData indexData:(SPIndexData *)indexData
+                 object:(SPDisplayObject *)object
 {
-    if (_quadBatchTop.numQuads)
+    float alpha = _stateStackTop->_alpha;
+    uint blendMode = _stateStackTop->_blendMode;
+    SPMatrix *modelViewMatrix = _stateStackTop->_modelViewMatrix;
+
+    // triangles can't be cut to a clip rect on the CPU
+    [self prepareScissorWithClippedContent:NO];
+
+    if (_meshBatch.numVertices)
     {
-        if (_matrix3DStackSize == 0)
+        if ([_meshBatch isStateChangeWithBlendMode:blendMode numVertices:vertexData.numVertices])
         {
-            [_quadBatchTop renderWithMvpMatrix3D:_projectionMatrix3D];
+            RECORD_DIAGNOSTICS([self setReason:SPBatchBreakReasonMesh object:object]);
+            [self renderPendingQuadBatches];
+        }
+    }
+    else if (_quadBatchTop.numQuads || _pendingQuadBatchIndex != _quadBatchIndex)
+    {
+        // a single pending batch of untextured quads is moved into the mesh batch, so that it
+        // doesn't need a draw call of its own
+        SPQuadBatch *quadBatch = _quadBatchTop;
+        BOOL canMerge = _pendingQuadBatchIndex == _quadBatchIndex && !quadBatch.texture &&
+                        quadBatch.blendMode == blendMode &&
+                        quadBatch.numQuads * 4 + vertexData.numVertices <= MAX_MESH_VERTICES;
+
+        if (canMerge)
+        {
+            [_meshBatch addQuadBatch:quadBatch alpha:1.0f blendMode:blendMode matrix:nil];
+            [quadBatch reset];
+            _pendingBounds[0] = SPQuadBatchBoundsEmpty();
         }
         else
+        {
+            RECORD_DIAGNOSTICS([self setReason:SPBatchBreakReasonMesh object:object]);
+            [self renderPendingQuadBatches];
+        }
+    }
+
+    [_meshBatch addVertexData:vertexData indexData:indexData alpha:alpha blendMode:blendMode
+                       matrix:modelViewMatrix];
+}
+
+- (void)finishQuadBatch
+{
+    [self finishQuadBatchWithReason:SPBatchBreakReasonExplicit object:nil];
+}
+
+- (void)renderPendingQuadBatches
+{
+    if (_quadBatchTop.numQuads || _pendingQuadBatchIndex != _quadBatchIndex || _meshBatch.numVertices)
+    {
+        SP_PROFILE_ZONE("SPRenderSupport.drawBatches");
+
+        SPMatrix3D *mvpMatrix = _projectionMatrix3D;
+
+        if (_clipsQuads)
+            [self applyScissorWithClipRect:_pendingScissorClipRect enabled:_pendingScissorEnabled];
+
+        if (_matrix3DStackSize != 0)
         {
             [_mvpMatrix3D copyFromMatrix:_projectionMatrix3D];
             [_mvpMatrix3D prependMatrix:_modelViewMatrix3D];
-            [_quadBatchTop renderWithMvpMatrix3D:_mvpMatrix3D];
+            mvpMatrix = _mvpMatrix3D;
+        }
+
+        if (_meshBatch.numVertices)
+        {
+            // the mesh batch is only filled while no quad batches are pending
+          #if SP_RENDER_DIAGNOSTICS
+            NSInteger numBytes = SPContext.currentContext.numVertexBytesUploaded;
+          #endif
+
+            [_meshBatch renderWithMvpMatrix3D:mvpMatrix];
+
+          #if SP_RENDER_DIAGNOSTICS
+            numBytes = SPContext.currentContext.numVertexBytesUploaded - numBytes;
+            RECORD_DIAGNOSTICS([_diagnostics recordPendingBatchAtIndex:0 numQuads:_meshBatch.numIndices / 6
+                                                        numVertexBytes:numBytes]);
+          #endif
+
+            [_meshBatch reset];
+            ++_numDrawCalls;
+        }
+
+        for (NSInteger i=_pendingQuadBatchIndex; i<=_quadBatchIndex; ++i)
+        {
+            SPQuadBatch *quadBatch = _quadBatches[i];
+            if (!quadBatch.numQuads) continue;
+
+          #if SP_RENDER_DIAGNOSTICS
+            NSInteger numBytes = SPContext.currentContext.numVertexBytesUploaded;
+          #endif
+
+            [quadBatch renderWithMvpMatrix3D:mvpMatrix];
+
+            if (_overdrawAnalysis.heatTexture)
+                [self drawOverdrawOfQuadBatch:quadBatch mvpMatrix:mvpMatrix alpha:1.0f];
+
+          #if SP_RENDER_DIAGNOSTICS
+            numBytes = SPContext.currentContext.numVertexBytesUploaded - numBytes;
+            RECORD_DIAGNOSTICS([_diagnostics recordPendingBatchAtIndex:i - _pendingQuadBatchIndex
+                                                              numQuads:quadBatch.numQuads
+                                                        numVertexBytes:numBytes]);
+          #endif
+
+            [quadBatch reset];
+            ++_numDrawCalls;
         }
-        
-        [_quadBatchTop reset];
 
         if (_quadBatchSize == _quadBatchIndex + 1)
         {
-            [_quadBatches addObject:[SPQuadBatch quadBatch]];
+            [_quadBatches addObject:createQuadBatch(_maxNumTexturesPerBatch, _vertexFormat)];
             ++_quadBatchSize;
         }
 
-        ++_numDrawCalls;
         _quadBatchTop = _quadBatches[++_quadBatchIndex];
+        _pendingQuadBatchIndex = _quadBatchIndex;
+        _pendingBounds[0] = SPQuadBatchBoundsEmpty();
+    }
+}
+
+- (void)renderQuadBatches:(NSArray<SPQuadBatch*> *)quadBatches
+{
+    [self finishQuadBatchWithReason:SPBatchBreakReasonCompiledBatch object:nil];
+
+    SP_PROFILE_ZONE("SPRenderSupport.drawCompiledBatches");
+
+    SPMatrix3D *mvpMatrix = self.mvpMatrix3D;
+    SPMatrix *mvpMatrix2D = _overdrawAnalysis ? self.mvpMatrix : nil;
+    float alpha = _stateStackTop->_alpha;
+    uint supportBlendMode = _stateStackTop->_blendMode;
+
+    for (SPQuadBatch *quadBatch in quadBatches)
+    {
+        if (!quadBatch.numQuads) continue;
+
+        uint blendMode = quadBatch.blendMode;
+        if (blendMode == SPBlendModeAuto) blendMode = supportBlendMode;
+
+      #if SP_RENDER_DIAGNOSTICS
+        NSInteger numBytes = SPContext.currentContext.numVertexBytesUploaded;
+      #endif
+
+        [quadBatch renderWithMvpMatrix3D:mvpMatrix alpha:alpha blendMode:blendMode];
+        ++_numDrawCalls;
+
+        if (_overdrawAnalysis)
+        {
+            [self analyzeOverdrawOfQuadBatch:quadBatch fromIndex:0 numQuads:quadBatch.numQuads
+                                      matrix:mvpMatrix2D object:quadBatch];
+
+            if (_overdrawAnalysis.heatTexture)
+                [self drawOverdrawOfQuadBatch:quadBatch mvpMatrix:mvpMatrix alpha:alpha];
+        }
+
+      #if SP_RENDER_DIAGNOSTICS
+        numBytes = SPContext.currentContext.numVertexBytesUploaded - numBytes;
+        RECORD_DIAGNOSTICS([_diagnostics recordBatchWithReason:SPBatchBreakReasonCompiledBatch
+                                                        object:nil numQuads:quadBatch.numQuads
+                                                numVertexBytes:numBytes]);
+      #endif
     }
 }
 
@@ -434,10 +806,10 @@
     
     // intersect with the last pushed clip rect
     if (intersect && _clipRectStackSize > 0)
-        rectangle = [rectangle intersectionWithRectangle:_clipRectStack[_clipRectStackSize - 1]];
+        [rectangle copyFromRectangle:[rectangle intersectionWithRectangle:_clipRectStack[_clipRectStackSize - 1]]];
     
     ++ _clipRectStackSize;
-    [self applyClipRect];
+    if (!_clipsQuads) [self applyClipRect];
     
     // return the intersected clip rect so callers can skip draw calls if it's empty
     return rectangle;
@@ -448,22 +820,42 @@
     if (_clipRectStackSize > 0)
     {
         -- _clipRectStackSize;
-        [self applyClipRect];
+        if (!_clipsQuads) [self applyClipRect];
     }
 }
 
 - (void)applyClipRect
 {
-    [self finishQuadBatch];
+    [self finishQuadBatchWithReason:SPBatchBreakReasonClipRect object:nil];
+
+    _scissorValid = NO; // the render target or projection might have changed
+    [self applyScissorOfClipRectStack];
+}
+
+- (void)applyScissorOfClipRectStack
+{
+    if (_clipRectStackSize > 0)
+        [self applyScissorWithClipRect:_clipRectStack[_clipRectStackSize-1].rectValue enabled:YES];
+    else
+        [self applyScissorWithClipRect:SPRectValueMake(0, 0, 0, 0) enabled:NO];
+}
+
+- (void)applyScissorWithClipRect:(SPRectValue)rect enabled:(BOOL)enabled
+{
+    if (_scissorValid && enabled == _scissorEnabled && (!enabled || rectsEqual(rect, _scissorClipRect)))
+        return;
 
     SPContext *context = SPContext.currentContext;
     if (!context) return;
 
-    if (_clipRectStackSize > 0)
+    _scissorValid = YES;
+    _scissorEnabled = enabled;
+    _scissorClipRect = rect;
+
+    if (enabled)
     {
         NSInteger width, height;
-        SPRectangle *rect = _clipRectStack[_clipRectStackSize-1];
-        SPRectangle *clipRect = [SPRectangle rectangle];
+        SPMatrixValue projectionMatrix = _projectionMatrix.matrixValue;
         SPTexture *renderTarget = self.renderTarget;
 
         if (renderTarget)
@@ -478,27 +870,29 @@
         }
 
         // convert to pixel coordinates (matrix transformation ends up in range [-1, 1])
-        SPPoint *topLeft = [_projectionMatrix transformPointWithX:rect.x y:rect.y];
+        SPPointValue topLeft = SPMatrixValueTransformPoint(projectionMatrix, rect.x, rect.y);
         if (renderTarget) topLeft.y = -topLeft.y;
-        clipRect.x = (topLeft.x * 0.5f + 0.5f) * width;
-        clipRect.y = (0.5f - topLeft.y * 0.5f) * height;
 
-        SPPoint *bottomRight = [_projectionMatrix transformPointWithX:rect.right y:rect.bottom];
+        SPPointValue bottomRight = SPMatrixValueTransformPoint(projectionMatrix, rect.x + rect.width,
+                                                               rect.y + rect.height);
         if (renderTarget) bottomRight.y = -bottomRight.y;
-        clipRect.right  = (bottomRight.x * 0.5f + 0.5f) * width;
-        clipRect.bottom = (0.5f - bottomRight.y * 0.5f) * height;
+
+        SPRectValue clipRect;
+        clipRect.x = (topLeft.x * 0.5f + 0.5f) * width;
+        clipRect.y = (0.5f - topLeft.y * 0.5f) * height;
+        clipRect.width  = (bottomRight.x * 0.5f + 0.5f) * width  - clipRect.x;
+        clipRect.height = (0.5f - bottomRight.y * 0.5f) * height - clipRect.y;
 
         // flip y coordiantes when rendering to backbuffer
         if (!renderTarget) clipRect.y = height - clipRect.y - clipRect.height;
 
-        SPRectangle *scissorRect = [clipRect intersectionWithRectangle:
-                                    [SPRectangle rectangleWithX:0 y:0 width:width height:height]];
+        SPRectValue scissorRect = SPRectValueIntersection(clipRect, SPRectValueMake(0, 0, width, height));
 
         // a negative rectangle is not allowed
         if (scissorRect.width < 0 || scissorRect.height < 0)
-            [scissorRect setEmpty];
+            scissorRect = SPRectValueMake(0, 0, 0, 0);
 
-        [context setScissorRectangle:scissorRect];
+        [context setScissorRectangle:[SPRectangle rectangleWithValue:scissorRect]];
     }
     else
     {
@@ -511,8 +905,19 @@
 - (void)pushMask:(SPDisplayObject *)mask
 {
     [_maskStack addObject:mask];
-    
-    [self finishQuadBatch];
+
+    SPRectValue maskRect;
+    if ([self isRectangularMask:mask intoRect:&maskRect])
+    {
+        // no need for the stencil buffer: a clip rect has the same effect, without ending the batch
+        [_clippingMaskIndices addIndex:_maskStack.count - 1];
+        [self pushClipRect:[SPRectangle rectangleWithValue:maskRect]];
+        ++_numClippingMasks;
+        return;
+    }
+
+    ++_numStencilMasks;
+    [self finishQuadBatchWithReason:SPBatchBreakReasonMask object:mask];
     
     glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
     glStencilFunc(GL_EQUAL, _stencilReferenceValue++, 0xff);
@@ -527,20 +932,45 @@
 {
     SPDisplayObject *mask = [[_maskStack lastObject] retain];
     [_maskStack removeLastObject];
-    
-    [self finishQuadBatch];
-    
-    glStencilOp(GL_KEEP, GL_KEEP, GL_DECR);
-    glStencilFunc(GL_EQUAL, _stencilReferenceValue--, 0xff);
-    
-    [self drawMask:mask];
-    
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-    glStencilFunc(GL_EQUAL, _stencilReferenceValue, 0xff);
-    
+
+    if ([_clippingMaskIndices containsIndex:_maskStack.count])
+    {
+        [_clippingMaskIndices removeIndex:_maskStack.count];
+        [self popClipRect];
+    }
+    else
+    {
+        [self finishQuadBatchWithReason:SPBatchBreakReasonMask object:mask];
+
+        glStencilOp(GL_KEEP, GL_KEEP, GL_DECR);
+        glStencilFunc(GL_EQUAL, _stencilReferenceValue--, 0xff);
+
+        [self drawMask:mask];
+
+        glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+        glStencilFunc(GL_EQUAL, _stencilReferenceValue, 0xff);
+    }
+
     [mask release];
 }
 
+- (BOOL)isRectangularMask:(SPDisplayObject *)mask intoRect:(SPRectValue *)rect
+{
+    // A quad covers exactly its bounds in the stencil buffer (the texture is ignored), as long as
+    // it is transformed to stage coordinates without rotation (or in steps of 90 degrees).
+
+    if (![mask isKindOfClass:[SPQuad class]] || _matrix3DStackSize != 0) return NO;
+
+    SPStage *stage = mask.stage;
+    SPMatrixValue matrix = stage ? [mask transformationMatrixToSpace:stage].matrixValue :
+        SPMatrixValuePrepend(_stateStackTop->_modelViewMatrix.matrixValue, mask.transformationMatrix.matrixValue);
+
+    if (!((matrix.b == 0.0f && matrix.c == 0.0f) || (matrix.a == 0.0f && matrix.d == 0.0f))) return NO;
+
+    *rect = SPMatrixValueTransformRect(matrix, [mask boundsInSpace:mask].rectValue);
+    return YES;
+}
+
 - (void)drawMask:(SPDisplayObject *)mask
 {
     [self pushStateWithMatrix:mask.transformationMatrix alpha:0.0f blendMode:SPBlendModeAuto];
@@ -549,7 +979,7 @@
     if (stage) [_stateStackTop->_modelViewMatrix copyFromMatrix:[mask transformationMatrixToSpace:stage]];
     
     [mask render:self];
-    [self finishQuadBatch];
+    [self finishQuadBatchWithReason:SPBatchBreakReasonMask object:mask];
     
     [self popState];
 }
@@ -629,6 +1059,8 @@
 {
     SPContext *context = SPContext.currentContext;
     if (!context) return;
+
+    [self finishQuadBatchWithReason:SPBatchBreakReasonRenderTarget object:nil];
     
     if (renderTarget)
         context.data[RENDER_TARGET_NAME] = renderTarget;
@@ -648,4 +1080,388 @@
     _stencilReferenceValue = stencilReferenceValue;
 }
 
+- (BOOL)recordsDiagnostics
+{
+    return _diagnostics != nil;
+}
+
+- (void)setRecordsDiagnostics:(BOOL)recordsDiagnostics
+{
+  #if SP_RENDER_DIAGNOSTICS
+    if (recordsDiagnostics && !_diagnostics)
+        _diagnostics = [[SPRenderDiagnostics alloc] init];
+    else if (!recordsDiagnostics)
+        SP_RELEASE_AND_NIL(_diagnostics);
+  #endif
+}
+
+- (SPRenderDiagnostics *)diagnostics
+{
+    return _diagnostics;
+}
+
+- (void)setOverdrawAnalysis:(SPOverdrawAnalysis *)overdrawAnalysis
+{
+    if (overdrawAnalysis != _overdrawAnalysis)
+    {
+        [self finishQuadBatch];
+        SP_RELEASE_AND_RETAIN(_overdrawAnalysis, overdrawAnalysis);
+        _heatTextureCleared = NO;
+    }
+}
+
+- (void)setCullsOccludedObjects:(BOOL)cullsOccludedObjects
+{
+    _cullsOccludedObjects = cullsOccludedObjects;
+    if (!cullsOccludedObjects && _occludedObjects) CFSetRemoveAllValues(_occludedObjects);
+}
+
+- (NSInteger)numOccludedObjects
+{
+    return _occludedObjects ? CFSetGetCount(_occludedObjects) : 0;
+}
+
+- (NSInteger)numVertexBytesUploaded
+{
+    return SPContext.currentContext.numVertexBytesUploaded - _numVertexBytesUploadedBeforeFrame;
+}
+
+- (void)setReordersBatches:(BOOL)reordersBatches
+{
+    if (reordersBatches != _reordersBatches)
+    {
+        [self finishQuadBatch];
+        _reordersBatches = reordersBatches;
+    }
+}
+
+- (void)setClipsQuads:(BOOL)clipsQuads
+{
+    if (clipsQuads != _clipsQuads)
+    {
+        [self finishQuadBatch];
+        _clipsQuads = clipsQuads;
+        [self applyClipRect];
+    }
+}
+
+- (void)setMaxNumTexturesPerBatch:(NSInteger)value
+{
+    value = MAX(1, MIN(value, [SPBaseEffect maxNumTextures]));
+
+    if (value != _maxNumTexturesPerBatch)
+    {
+        [self finishQuadBatch];
+        _maxNumTexturesPerBatch = value;
+
+        for (SPQuadBatch *quadBatch in _quadBatches)
+            quadBatch.maxNumTextures = value;
+    }
+}
+
+- (void)setVertexFormat:(SPVertexFormat)value
+{
+    if (value != _vertexFormat)
+    {
+        [self finishQuadBatch];
+        _vertexFormat = value;
+
+        for (SPQuadBatch *quadBatch in _quadBatches)
+            quadBatch.vertexFormat = value;
+    }
+}
+
+#pragma mark Private
+
+- (SPQuadBatchBounds)visibleArea
+{
+    SPQuadBatchBounds visibleArea = { -1.0f, -1.0f, 1.0f, 1.0f };
+
+    if (_clipRectStackSize > 0)
+    {
+        SPRectangle *clipRect = _clipRectStack[_clipRectStackSize-1];
+        SPQuadBatchBounds clipBounds = projectRectangle(_projectionMatrix.matrixValue, clipRect.rectValue);
+        visibleArea.minX = MAX(visibleArea.minX, clipBounds.minX);
+        visibleArea.minY = MAX(visibleArea.minY, clipBounds.minY);
+        visibleArea.maxX = MIN(visibleArea.maxX, clipBounds.maxX);
+        visibleArea.maxY = MIN(visibleArea.maxY, clipBounds.maxY);
+    }
+
+    return visibleArea;
+}
+
+- (void)analyzeOverdrawOfQuadBatch:(SPQuadBatch *)quadBatch fromIndex:(NSInteger)quadID
+                          numQuads:(NSInteger)numQuads matrix:(SPMatrix *)matrix
+                            object:(SPDisplayObject *)object
+{
+    // the grid covers the back buffer; 3D projections and render textures are not measured
+    if (_matrix3DStackSize > 0 || self.renderTarget) return;
+
+    SPMatrixValue matrixValue = matrix.matrixValue;
+    SPQuadBatchBounds visibleArea = [self visibleArea];
+
+    for (NSInteger i=quadID, end=quadID+numQuads; i<end; ++i)
+    {
+        SPQuadBatchBounds localBounds = [quadBatch boundsOfQuadsAtIndex:i numQuads:1];
+        SPRectValue rect = { localBounds.minX, localBounds.minY,
+                             localBounds.maxX - localBounds.minX, localBounds.maxY - localBounds.minY };
+        SPQuadBatchBounds bounds = projectRectangle(matrixValue, rect);
+
+        bounds.minX = MAX(bounds.minX, visibleArea.minX);
+        bounds.minY = MAX(bounds.minY, visibleArea.minY);
+        bounds.maxX = MIN(bounds.maxX, visibleArea.maxX);
+        bounds.maxY = MIN(bounds.maxY, visibleArea.maxY);
+
+        [_overdrawAnalysis addBounds:bounds ofObject:object];
+    }
+}
+
+- (void)drawOverdrawOfQuadBatch:(SPQuadBatch *)quadBatch mvpMatrix:(SPMatrix3D *)mvpMatrix
+                          alpha:(float)alpha
+{
+    SPContext *context = SPContext.currentContext;
+    SPTexture *heatTexture = _overdrawAnalysis.heatTexture;
+
+    if (!context || self.renderTarget || quadBatch.texture.root == heatTexture.root) return;
+
+    // render textures are drawn upside down, just like with 'setupOrthographicProjection'
+    SPMatrix3D *heatMatrix = [[mvpMatrix copy] autorelease];
+    [heatMatrix appendScaleX:1.0f y:-1.0f z:1.0f];
+
+    BOOL scissorEnabled = _scissorValid && _scissorEnabled;
+    if (scissorEnabled) glDisable(GL_SCISSOR_TEST);
+    [context setRenderToTexture:heatTexture.root];
+
+    if (!_heatTextureCleared)
+    {
+        [context clearWithRed:0 green:0 blue:0 alpha:0];
+        _heatTextureCleared = YES;
+    }
+
+    [quadBatch renderOverdrawWithMvpMatrix3D:heatMatrix alpha:alpha
+                                  brightness:_overdrawAnalysis.heatIncrement];
+
+    [context setRenderToBackBuffer];
+    if (scissorEnabled) glEnable(GL_SCISSOR_TEST);
+}
+
+- (SPQuadBatchBounds)clipBounds
+{
+    SPRectValue clipRect = _clipRectStack[_clipRectStackSize-1].rectValue;
+    return (SPQuadBatchBounds){ clipRect.x, clipRect.y, clipRect.x + clipRect.width, clipRect.y + clipRect.height };
+}
+
+- (BOOL)prepareClippingOfQuadBatch:(SPQuadBatch *)quadBatch
+{
+    // Returns YES if the quads about to be batched (a single quad if 'quadBatch' is nil) can be
+    // cut to the current clip rect on the CPU. Rotated quads need the scissor rectangle instead.
+
+    if (!_clipsQuads) return NO;
+
+    SPMatrixValue matrix = _stateStackTop->_modelViewMatrix.matrixValue;
+    BOOL clippable = _clipRectStackSize > 0 && _matrix3DStackSize == 0 && matrix.b == 0.0f &&
+                     matrix.c == 0.0f && (!quadBatch || [quadBatch quadsAreAxisAligned]);
+
+    [self prepareScissorWithClippedContent:clippable];
+    return clippable;
+}
+
+- (void)prepareScissorWithClippedContent:(BOOL)clipped
+{
+    // All pending batches share one scissor rectangle, so they are drawn when it must change.
+    // Content that was cut on the CPU accepts any scissor rectangle around its clip rect.
+
+    if (!_clipsQuads) return;
+
+    BOOL hasClipRect = _clipRectStackSize > 0;
+    SPRectValue clipRect = hasClipRect ? _clipRectStack[_clipRectStackSize-1].rectValue : SPRectValueMake(0, 0, 0, 0);
+    BOOL needsScissor = hasClipRect && !clipped;
+    BOOL scissorFits;
+
+    if (needsScissor)
+        scissorFits = _pendingScissorEnabled && rectsEqual(_pendingScissorClipRect, clipRect);
+    else
+        scissorFits = !_pendingScissorEnabled ||
+                      (hasClipRect && SPRectValueContainsRect(_pendingScissorClipRect, clipRect));
+
+    if (!scissorFits)
+    {
+        if (_quadBatchTop.numQuads || _pendingQuadBatchIndex != _quadBatchIndex || _meshBatch.numVertices)
+        {
+            RECORD_DIAGNOSTICS([self setReason:SPBatchBreakReasonClipRect object:nil]);
+            [self renderPendingQuadBatches];
+        }
+
+        _pendingScissorEnabled = needsScissor;
+        _pendingScissorClipRect = clipRect;
+    }
+}
+
+- (void)findOccludedChildrenOf:(SPDisplayObjectContainer *)container withMatrix:(SPMatrixValue)matrix
+                         alpha:(float)alpha blendMode:(uint)blendMode canOcclude:(BOOL)canOcclude
+{
+    // The children are visited front to back, so that each one is tested against the opaque
+    // quads that will be drawn on top of it. Filtered objects may draw outside of their bounds,
+    // and the bounds of 3D objects are not known here; they are left alone.
+
+    for (NSInteger i=container.numChildren-1; i>=0; --i)
+    {
+        SPDisplayObject *child = [container childAtIndex:i];
+        if (!child.hasVisibleArea || child.filter || [child isKindOfClass:[SPSprite3D class]]) continue;
+
+        SPMatrixValue childMatrix = SPMatrixValuePrepend(matrix, child.transformationMatrix.matrixValue);
+        SPQuadBatchBounds bounds = projectRectangle(childMatrix, [child boundsInSpace:child].rectValue);
+
+        if ([self isOccludedBounds:bounds])
+        {
+            CFSetAddValue(_occludedObjects, child);
+            continue;
+        }
+
+        // flattened sprites draw their contents in one go, so their descendants can't be skipped
+        if ([child isKindOfClass:[SPSprite class]] && ((SPSprite *)child).isFlattened) continue;
+
+        uint childBlendMode = child.blendMode == SPBlendModeAuto ? blendMode : child.blendMode;
+        float childAlpha = alpha * child.alpha;
+
+        // masked and clipped quads hide less than their bounds
+        BOOL childCanOcclude = canOcclude && !child.mask &&
+            !([child isKindOfClass:[SPSprite class]] && ((SPSprite *)child).clipRect);
+
+        if ([child isKindOfClass:[SPDisplayObjectContainer class]])
+            [self findOccludedChildrenOf:(SPDisplayObjectContainer *)child withMatrix:childMatrix
+                                   alpha:childAlpha blendMode:childBlendMode canOcclude:childCanOcclude];
+        else if (childCanOcclude && [child isKindOfClass:[SPQuad class]] &&
+                 isOpaqueQuad((SPQuad *)child, childMatrix, childAlpha, childBlendMode))
+            [self addOccluder:bounds];
+    }
+}
+
+- (BOOL)isOccludedBounds:(SPQuadBatchBounds)bounds
+{
+    for (NSInteger i=0; i<_numOccluders; ++i)
+    {
+        SPQuadBatchBounds occluder = _occluders[i];
+        if (occluder.minX <= bounds.minX && occluder.maxX >= bounds.maxX &&
+            occluder.minY <= bounds.minY && occluder.maxY >= bounds.maxY)
+            return YES;
+    }
+
+    return NO;
+}
+
+- (void)addOccluder:(SPQuadBatchBounds)bounds
+{
+    // only the biggest occluders are kept, which are the ones most likely to hide something
+
+    if (_numOccluders < MAX_OCCLUDERS)
+    {
+        _occluders[_numOccluders++] = bounds;
+        return;
+    }
+
+    NSInteger smallestID = 0;
+    for (NSInteger i=1; i<MAX_OCCLUDERS; ++i)
+        if (boundsArea(_occluders[i]) < boundsArea(_occluders[smallestID])) smallestID = i;
+
+    if (boundsArea(bounds) > boundsArea(_occluders[smallestID]))
+        _occluders[smallestID] = bounds;
+}
+
+- (void)setReason:(SPBatchBreakReason)reason object:(SPDisplayObject *)object
+{
+    [_diagnostics setReason:reason object:object
+        forPendingBatchAtIndex:_quadBatchIndex - _pendingQuadBatchIndex];
+}
+
+- (void)advanceQuadBatch
+{
+    // Instead of drawing the current batch right away, it is kept pending for a while, so that
+    // subsequent quads with its state can still be appended to it (see 'mergeQuadBatchTop').
+
+    NSInteger numPendingBatches = _quadBatchIndex - _pendingQuadBatchIndex + 1;
+
+    if (!_reordersBatches || numPendingBatches == MAX_PENDING_QUAD_BATCHES)
+    {
+        [self renderPendingQuadBatches];
+    }
+    else
+    {
+        if (_quadBatchSize == _quadBatchIndex + 1)
+        {
+            [_quadBatches addObject:createQuadBatch(_maxNumTexturesPerBatch, _vertexFormat)];
+            ++_quadBatchSize;
+        }
+
+        // the bounds of a batch are only needed once it's finished, so they are not updated per quad
+        _pendingBounds[numPendingBatches - 1] = [_quadBatchTop boundsOfQuadsAtIndex:0
+                                                                         numQuads:_quadBatchTop.numQuads];
+        _quadBatchTop = _quadBatches[++_quadBatchIndex];
+        _pendingBounds[numPendingBatches] = SPQuadBatchBoundsEmpty();
+    }
+}
+
+- (void)mergeQuadBatchTop
+{
+    // The top batch was just started and contains only the latest quads. If one of the pending
+    // batches shares their state, they can be moved there -- as long as they don't overlap any of
+    // the batches they are jumping over.
+
+    SPQuadBatch *top = _quadBatchTop;
+    NSInteger topID = _quadBatchIndex - _pendingQuadBatchIndex;
+    if (topID == 0) return;
+
+    SPQuadBatchBounds bounds = [top boundsOfQuadsAtIndex:0 numQuads:top.numQuads];
+    BOOL blocked = NO;
+
+    for (NSInteger i=topID-1; i>=0; --i)
+    {
+        SPQuadBatch *quadBatch = _quadBatches[_pendingQuadBatchIndex + i];
+        BOOL compatible = ![quadBatch isStateChangeWithQuadBatch:top alpha:1.0f blendMode:top.blendMode];
+        if (compatible && blocked)
+        {
+            ++_numRejectedMerges;
+            return;
+        }
+        else if (compatible)
+        {
+            [quadBatch addQuadBatch:top alpha:1.0f blendMode:top.blendMode matrix:nil];
+            [top reset];
+
+            _pendingBounds[i] = SPQuadBatchBoundsUnion(_pendingBounds[i], bounds);
+            _quadBatchTop = _quadBatches[--_quadBatchIndex];
+            ++_numMergedBatches;
+            return;
+        }
+        else if (SPQuadBatchBoundsOverlap(bounds, _pendingBounds[i]))
+            blocked = YES;
+    }
+}
+
+@end
+
+@implementation SPRenderSupport (Internal)
+
+- (void)finishQuadBatchWithReason:(SPBatchBreakReason)reason object:(SPDisplayObject *)object
+{
+    RECORD_DIAGNOSTICS([self setReason:reason object:object]);
+    [self renderPendingQuadBatches];
+
+    // whatever is drawn next without batching relies on the scissor rectangle
+    if (_clipsQuads) [self applyScissorOfClipRectStack];
+}
+
+- (BOOL)isRectValueVisible:(SPRectValue)rect
+{
+    if (_matrix3DStackSize > 0) return YES;
+
+    // compare in normalized device coordinates, where the visible area is [-1, 1]
+
+    SPQuadBatchBounds bounds = projectRectangle(self.mvpMatrix.matrixValue, rect);
+    SPQuadBatchBounds visibleArea = [self visibleArea];
+
+    return bounds.maxX >= visibleArea.minX && bounds.minX <= visibleArea.maxX &&
+           bounds.maxY >= visibleArea.minY && bounds.minY <= visibleArea.maxY;
+}
+
 @end
@@ -0,0 +1,24 @@
+//
+//  SPRenderSupport_Internal.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPGeometryValues.h"
+#import "SPRenderDiagnostics.h"
+#import "SPRenderSupport.h"
+
+@interface SPRenderSupport (Internal)
+
+/// Like 'finishQuadBatch', but tells the diagnostics why the current batch had to be ended.
+- (void)finishQuadBatchWithReason:(SPBatchBreakReason)reason object:(SPDisplayObject *)object;
+
+/// Like 'isRectangleVisible:', but for a rectangle value, so that culling doesn't allocate.
+- (BOOL)isRectValueVisible:(SPRectValue)rect;
+
+@end
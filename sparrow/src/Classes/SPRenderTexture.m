@@ -19,6 +19,7 @@
 #import "SPOpenGL.h"
 #import "SPRectangle.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
 #import "SPRenderTexture.h"
 #import "SPStage.h"
 #import "SPUtils.h"
@@ -177,7 +178,7 @@
     if (!isDrawing)
     {
         _framebufferIsActive = NO;
-        [_renderSupport finishQuadBatch];
+        [_renderSupport finishQuadBatchWithReason:SPBatchBreakReasonRenderTarget object:nil];
         [_renderSupport nextFrame];
         [_renderSupport setRenderTarget:previousTarget];
         [_renderSupport popClipRect];
@@ -0,0 +1,55 @@
+//
+//  SPSpatialIndex.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class SPDisplayObject;
+@class SPDisplayObjectContainer;
+
+/** ------------------------------------------------------------------------------------------------
+
+ An SPSpatialIndex sorts the children of a container into a uniform grid, based on their bounds
+ in the coordinate system of the container. It is used to find the children that might be hit by
+ a touch without looking at all of them.
+
+ The grid is built lazily with the first query. Afterwards, only children that were marked as
+ dirty are moved to their new cells. Adding, removing or reordering children invalidates the
+ complete grid, since the entries are identified by the indices of the children.
+
+ Children that would span too many cells (or are rendered in 3D) are not sorted into the grid;
+ they are returned by every query.
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPSpatialIndex : NSObject
+
+/// Initializes an index for the children of a container. The container is not retained.
+- (instancetype)initWithContainer:(SPDisplayObjectContainer *)container;
+
+/// Discards all entries; the grid is rebuilt with the next query.
+- (void)invalidate;
+
+/// Marks the bounds of a child as outdated; its entry is updated with the next query.
+- (void)markChildDirty:(SPDisplayObject *)child;
+
+/// Returns the indices of all children whose bounds might contain a point (in the coordinate
+/// system of the container). The indices are sorted from back to front.
+- (NSIndexSet *)childIndicesAtX:(float)x y:(float)y;
+
+/// The side length of a grid cell; it is derived from the average size of the children whenever
+/// the grid is rebuilt.
+@property (nonatomic, readonly) float cellSize;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,261 @@
+//
+//  SPSpatialIndex.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPDisplayObject_Internal.h"
+#import "SPDisplayObjectContainer.h"
+#import "SPMacros.h"
+#import "SPRectangle.h"
+#import "SPSpatialIndex.h"
+
+// --- private constants ---------------------------------------------------------------------------
+
+// A grid cell is this many times as large as the average child.
+#define CELL_SIZE_FACTOR 2.0f
+
+// Children that would be sorted into more cells than this are returned by every query instead.
+#define MAX_CELLS_PER_CHILD 64
+
+// --- private types -------------------------------------------------------------------------------
+
+typedef struct
+{
+    int minX, minY;
+    int maxX, maxY;
+    BOOL inGrid;
+} SPSpatialEntry;
+
+// --- C functions ---------------------------------------------------------------------------------
+
+SP_INLINE NSNumber *cellKey(int x, int y)
+{
+    return @(((int64_t)x << 32) | (uint32_t)y);
+}
+
+// --- class implementation ------------------------------------------------------------------------
+
+@implementation SPSpatialIndex
+{
+    SPDisplayObjectContainer *__weak _container;
+    BOOL _valid;
+    float _cellSize;
+    NSInteger _numEntries;
+    SPSpatialEntry *_entries;
+    CFMutableDictionaryRef _childIndices;
+    NSMutableDictionary<NSNumber*, NSMutableIndexSet*> *_cells;
+    NSMutableIndexSet *_outsiders;
+    NSMutableIndexSet *_dirtyChildren;
+}
+
+#pragma mark Initialization
+
+- (instancetype)initWithContainer:(SPDisplayObjectContainer *)container
+{
+    if ((self = [super init]))
+    {
+        _container = container;
+        _cellSize = 1.0f;
+        _childIndices = CFDictionaryCreateMutable(NULL, 0, NULL, NULL); // pointers only
+        _cells = [[NSMutableDictionary alloc] init];
+        _outsiders = [[NSMutableIndexSet alloc] init];
+        _dirtyChildren = [[NSMutableIndexSet alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_entries);
+    CFRelease(_childIndices);
+    [_cells release];
+    [_outsiders release];
+    [_dirtyChildren release];
+    [super dealloc];
+}
+
+#pragma mark Methods
+
+- (void)invalidate
+{
+    _valid = NO;
+}
+
+- (void)markChildDirty:(SPDisplayObject *)child
+{
+    if (!_valid) return;
+
+    const void *value;
+    if (CFDictionaryGetValueIfPresent(_childIndices, child, &value))
+        [_dirtyChildren addIndex:(NSUInteger)value];
+    else
+        _valid = NO; // not a known child; better start from scratch
+}
+
+- (NSIndexSet *)childIndicesAtX:(float)x y:(float)y
+{
+    if (!_valid || _numEntries != _container.numChildren)
+        [self rebuild];
+    else if (_dirtyChildren.count)
+        [self updateDirtyChildren];
+
+    // the next change of any child must reach us again, even if it happens within the same frame
+    [_container snapshotContentStamp];
+
+    NSIndexSet *cell = nil;
+    float cellX = floorf(x / _cellSize);
+    float cellY = floorf(y / _cellSize);
+
+    if (fabsf(cellX) < INT_MAX && fabsf(cellY) < INT_MAX)
+        cell = _cells[cellKey((int)cellX, (int)cellY)];
+
+    if (!_outsiders.count) return cell ? [[cell copy] autorelease] : [NSIndexSet indexSet];
+    else if (!cell)        return [[_outsiders copy] autorelease];
+    else
+    {
+        NSMutableIndexSet *indices = [[cell mutableCopy] autorelease];
+        [indices addIndexes:_outsiders];
+        return indices;
+    }
+}
+
+#pragma mark Grid
+
+- (void)rebuild
+{
+    NSArray<SPDisplayObject*> *children = _container.children;
+    NSInteger numChildren = children.count;
+
+    CFDictionaryRemoveAllValues(_childIndices);
+    [_cells removeAllObjects];
+    [_outsiders removeAllIndexes];
+    [_dirtyChildren removeAllIndexes];
+
+    if (numChildren != _numEntries)
+    {
+        _entries = realloc(_entries, sizeof(SPSpatialEntry) * MAX(1, numChildren));
+        _numEntries = numChildren;
+    }
+
+    // the cell size follows the average child, so that most children cover only a few cells
+
+    SPRectValue *bounds = malloc(sizeof(SPRectValue) * MAX(1, numChildren));
+    double sumOfSizes = 0.0;
+    NSInteger numSizedChildren = 0;
+
+    for (NSInteger i=0; i<numChildren; ++i)
+    {
+        SPDisplayObject *child = children[i];
+        CFDictionarySetValue(_childIndices, child, (const void *)i);
+
+        bounds[i] = [child boundsInSpace:_container].rectValue;
+        float size = MAX(bounds[i].width, bounds[i].height);
+
+        if (size > 0.0f && isfinite(size))
+        {
+            sumOfSizes += size;
+            ++numSizedChildren;
+        }
+    }
+
+    _cellSize = numSizedChildren ? MAX(1.0f, (float)(CELL_SIZE_FACTOR * sumOfSizes / numSizedChildren)) : 1.0f;
+
+    for (NSInteger i=0; i<numChildren; ++i)
+        [self addEntryAtIndex:i child:children[i] bounds:bounds[i]];
+
+    free(bounds);
+    _valid = YES;
+}
+
+- (void)updateDirtyChildren
+{
+    NSArray<SPDisplayObject*> *children = _container.children;
+
+    for (NSUInteger i=_dirtyChildren.firstIndex; i!=NSNotFound; i=[_dirtyChildren indexGreaterThanIndex:i])
+    {
+        SPDisplayObject *child = children[i];
+        [self removeEntryAtIndex:i];
+        [self addEntryAtIndex:i child:child bounds:[child boundsInSpace:_container].rectValue];
+    }
+
+    [_dirtyChildren removeAllIndexes];
+}
+
+- (void)addEntryAtIndex:(NSInteger)index child:(SPDisplayObject *)child bounds:(SPRectValue)bounds
+{
+    SPSpatialEntry *entry = &_entries[index];
+
+    float minX = floorf(bounds.x / _cellSize);
+    float minY = floorf(bounds.y / _cellSize);
+    float maxX = floorf((bounds.x + bounds.width)  / _cellSize);
+    float maxY = floorf((bounds.y + bounds.height) / _cellSize);
+    float numCells = (maxX - minX + 1.0f) * (maxY - minY + 1.0f);
+
+    // the bounds of 3D objects depend on the camera, which might not be known yet
+    if (child.is3D || !(numCells <= MAX_CELLS_PER_CHILD) ||
+        fabsf(minX) >= INT_MAX || fabsf(minY) >= INT_MAX || fabsf(maxX) >= INT_MAX || fabsf(maxY) >= INT_MAX)
+    {
+        entry->inGrid = NO;
+        [_outsiders addIndex:index];
+        return;
+    }
+
+    entry->inGrid = YES;
+    entry->minX = (int)minX; entry->maxX = (int)maxX;
+    entry->minY = (int)minY; entry->maxY = (int)maxY;
+
+    for (int y=entry->minY; y<=entry->maxY; ++y)
+    {
+        for (int x=entry->minX; x<=entry->maxX; ++x)
+        {
+            NSNumber *key = cellKey(x, y);
+            NSMutableIndexSet *cell = _cells[key];
+
+            if (!cell)
+            {
+                cell = [[NSMutableIndexSet alloc] init];
+                _cells[key] = cell;
+                [cell release];
+            }
+
+            [cell addIndex:index];
+        }
+    }
+}
+
+- (void)removeEntryAtIndex:(NSInteger)index
+{
+    SPSpatialEntry *entry = &_entries[index];
+
+    if (!entry->inGrid)
+    {
+        [_outsiders removeIndex:index];
+        return;
+    }
+
+    for (int y=entry->minY; y<=entry->maxY; ++y)
+    {
+        for (int x=entry->minX; x<=entry->maxX; ++x)
+        {
+            NSNumber *key = cellKey(x, y);
+            NSMutableIndexSet *cell = _cells[key];
+            [cell removeIndex:index];
+            if (!cell.count) [_cells removeObjectForKey:key];
+        }
+    }
+}
+
+#pragma mark Properties
+
+- (float)cellSize
+{
+    return _cellSize;
+}
+
+@end
@@ -71,9 +71,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// before the next rendering.
 - (void)flatten;
 
-/// Optimizes the sprite for optimal rendering performance as well as optionally optimizing the
-/// children order to further reduce the number of draw calls. Naturally, this is not an option
-/// for all use-cases.
+/// Optimizes the sprite for optimal rendering performance as well as optionally merging batches
+/// with an identical state across the children order to further reduce the number of draw calls.
+/// Batches are only merged where they don't overlap, so the result looks the same.
 - (void)flattenIgnoringChildOrder:(BOOL)ignoreChildOrder;
 
 /// Removes the rendering optimizations that were created when flattening the sprite.
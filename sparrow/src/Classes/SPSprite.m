@@ -9,7 +9,7 @@
 //  it under the terms of the Simplified BSD License.
 //
 
-#import "SPBlendMode.h"
+#import "SPDisplayObject_Internal.h"
 #import "SPMacros.h"
 #import "SPMatrix.h"
 #import "SPPoint.h"
@@ -142,23 +142,7 @@
         _flattenRequested = NO;
     }
 
-    if (_flattenedContents)
-    {
-        [support finishQuadBatch];
-        [support addDrawCalls:_flattenedContents.count];
-
-        SPMatrix3D *mvpMatrix = support.mvpMatrix3D;
-        float alpha = support.alpha;
-        uint supportBlendMode = support.blendMode;
-
-        for (SPQuadBatch *quadBatch in _flattenedContents)
-        {
-            uint blendMode = quadBatch.blendMode;
-            if (blendMode == SPBlendModeAuto) blendMode = supportBlendMode;
-
-            [quadBatch renderWithMvpMatrix3D:mvpMatrix alpha:alpha blendMode:blendMode];
-        }
-    }
+    if (_flattenedContents) [support renderQuadBatches:_flattenedContents];
     else [super render:support];
 
     if (_clipRect)
@@ -184,4 +168,20 @@
         return [super hitTestPoint:localPoint forTouch:forTouch];
 }
 
+- (BOOL)isRenderCacheable
+{
+    return !_clipRect && [super isRenderCacheable];
+}
+
+#pragma mark Properties
+
+- (void)setClipRect:(SPRectangle *)clipRect
+{
+    if (clipRect != _clipRect)
+    {
+        SP_RELEASE_AND_COPY(_clipRect, clipRect);
+        [self markDirty:SPDirtyFlagEffects];
+    }
+}
+
 @end
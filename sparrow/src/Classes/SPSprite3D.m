@@ -14,6 +14,7 @@
 #import "SPMatrix3D.h"
 #import "SPPoint.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
 #import "SPSprite3D.h"
 #import "SPStage.h"
 #import "SPVector3D.h"
@@ -109,13 +110,13 @@ SP_INLINE void recursivelySetIs3D(SPDisplayObject *object, BOOL value)
     if (is2D(self)) [super render:support];
     else
     {
-        [support finishQuadBatch];
+        [support finishQuadBatchWithReason:SPBatchBreakReasonSprite3D object:self];
         [support pushMatrix3D];
         [support transformMatrix3DWithObject:self];
         
         [super render:support];
         
-        [support finishQuadBatch];
+        [support finishQuadBatchWithReason:SPBatchBreakReasonSprite3D object:self];
         [support popMatrix3D];
     }
 }
@@ -140,6 +141,11 @@ SP_INLINE void recursivelySetIs3D(SPDisplayObject *object, BOOL value)
     }
 }
 
+- (BOOL)isRenderCacheable
+{
+    return NO; // 3D objects cannot be compiled into quad batches
+}
+
 #pragma mark Events
 
 - (void)onAddedChild:(SPEvent *)event
@@ -230,6 +236,7 @@ SP_INLINE void recursivelySetIs3D(SPDisplayObject *object, BOOL value)
 {
     _z = z;
     _transformationChanged = YES;
+    [self markDirty:SPDirtyFlagTransform];
 }
 
 - (void)setPivotX:(float)pivotX
@@ -248,6 +255,7 @@ SP_INLINE void recursivelySetIs3D(SPDisplayObject *object, BOOL value)
 {
     _pivotZ = pivotZ;
     _transformationChanged = YES;
+    [self markDirty:SPDirtyFlagTransform];
 }
 
 - (void)setScaleX:(float)scaleX
@@ -266,6 +274,7 @@ SP_INLINE void recursivelySetIs3D(SPDisplayObject *object, BOOL value)
 {
     _scaleZ = scaleZ;
     _transformationChanged = YES;
+    [self markDirty:SPDirtyFlagTransform];
 }
 
 - (void)setSkewX:(float)skewX
@@ -288,12 +297,14 @@ SP_INLINE void recursivelySetIs3D(SPDisplayObject *object, BOOL value)
 {
     _rotationX = rotationX;
     _transformationChanged = YES;
+    [self markDirty:SPDirtyFlagTransform];
 }
 
 - (void)setRotationY:(float)rotationY
 {
     _rotationY = rotationY;
     _transformationChanged = YES;
+    [self markDirty:SPDirtyFlagTransform];
 }
 
 - (float)rotationZ
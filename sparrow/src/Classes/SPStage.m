@@ -19,7 +19,9 @@
 #import "SPMacros.h"
 #import "SPMatrix3D.h"
 #import "SPOpenGL.h"
+#import "SPProfiler.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
 #import "SPStage.h"
 #import "SPVector3D.h"
 
@@ -108,7 +110,7 @@
         
         [super render:support];
         
-        [support finishQuadBatch];
+        [support finishQuadBatchWithReason:SPBatchBreakReasonEndOfFrame object:nil];
         image = [[SPContext currentContext] drawToImage];
         [support release];
     }];
@@ -239,6 +241,8 @@
 
 - (void)advanceTime:(double)passedTime
 {
+    SP_PROFILE_ZONE("SPStage.enterFrame");
+
     SPEnterFrameEvent* enterFrameEvent = [[SPEnterFrameEvent alloc] initWithType:SPEventTypeEnterFrame passedTime:passedTime];
     [self broadcastEvent:enterFrameEvent];
     [enterFrameEvent release];
@@ -58,6 +58,10 @@ NS_ASSUME_NONNULL_BEGIN
 /// If YES, the sub texture will show the parent region rotated by 90 degrees (CCW).
 @property (nonatomic, readonly) BOOL rotated;
 
+/// Indicates if the region is fully opaque. Set this to `YES` for opaque regions of a texture that
+/// contains an alpha channel; otherwise, the value of the parent texture is used.
+@property (nonatomic, assign) BOOL opaque;
+
 /// The clipping rectangle, which is the region provided on initialization.
 /// CAUTION: not a copy, but the actual object! Do not modify!
 @property (nonatomic, readonly) SPRectangle *region;
@@ -37,6 +37,7 @@ static GLKVector2 transformVector2WithMatrix3(const GLKMatrix3 *glkMatrix, const
     SPRectangle *_region;
     SPRectangle *_frame;
     BOOL _rotated;
+    BOOL _opaque;
     float _width;
     float _height;
     SPMatrix *_transformationMatrix;
@@ -225,6 +226,16 @@ static GLKVector2 transformVector2WithMatrix3(const GLKMatrix3 *glkMatrix, const
     return _parent.format;
 }
 
+- (BOOL)opaque
+{
+    return _opaque || _parent.opaque;
+}
+
+- (void)setOpaque:(BOOL)value
+{
+    _opaque = value;
+}
+
 - (BOOL)mipmaps
 {
     return _parent.mipmaps;
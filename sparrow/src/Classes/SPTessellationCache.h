@@ -0,0 +1,135 @@
+//
+//  SPTessellationCache.h
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import <Sparrow/SparrowBase.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class SPIndexData;
+@class SPPolygon;
+@class SPVertexData;
+
+/** ------------------------------------------------------------------------------------------------
+
+ The triangulated form of a shape, as stored by an SPTessellationCache.
+
+ Ellipses and rectangles are stored at the origin; their vertices have to be translated to the
+ position they are drawn at. Only the positions of the vertex data are set; the colors have their
+ default values. A tessellation returned by the cache stays valid until the next request, which
+ might discard it; retain it to keep it longer.
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPTessellation : NSObject
+
+/// The vertices of the shape.
+@property (nonatomic, readonly) SPVertexData *vertexData;
+
+/// The triangles of the shape, referencing the vertices starting at index 0.
+@property (nonatomic, readonly) SPIndexData *indexData;
+
+/// The shape as a polygon, e.g. for hit tests. It is immutable, since the cache looks it up by its
+/// vertices; modifying it raises an exception.
+@property (nonatomic, readonly) SPPolygon *polygon;
+
+/// The time in seconds it took to create the tessellation.
+@property (nonatomic, readonly) double cost;
+
+@end
+
+/** ------------------------------------------------------------------------------------------------
+
+ SPTessellationCache keeps the triangulated vertices and indices of recently used shapes, so that
+ drawing the same shape repeatedly (e.g. when an SPCanvas is cleared and redrawn each frame) does
+ not create and triangulate a new polygon each time.
+
+ Ellipses are looked up by their radii (which determine their number of sides), rectangles by
+ their size, and any other polygon by its vertex coordinates. The cache is bounded by the total
+ number of vertices it stores; when that limit is exceeded, the least recently used shapes are
+ discarded first.
+
+ SPCanvas uses the `sharedCache` for all its drawing methods. To see if that pays off, look at
+ `hitRate` and `savedTime`:
+
+	SPTessellationCache *cache = SPTessellationCache.sharedCache;
+	NSLog(@"hit rate: %.2f, saved: %.2f ms", cache.hitRate, cache.savedTime * 1000);
+
+ The cache is not thread-safe; use it on the main thread only.
+
+------------------------------------------------------------------------------------------------- */
+
+@interface SPTessellationCache : NSObject
+
+/// --------------------
+/// @name Initialization
+/// --------------------
+
+/// Initializes a cache that stores up to a certain number of vertices. _Designated Initializer_.
+- (instancetype)initWithCapacity:(NSInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/// Initializes a cache that stores up to 16384 vertices.
+- (instancetype)init;
+
+/// The cache used by SPCanvas. Must only be accessed on the main thread.
++ (instancetype)sharedCache;
+
+/// -------------
+/// @name Methods
+/// -------------
+
+/// Returns the tessellation of an ellipse around the origin, with the same number of sides as
+/// `[SPPolygon elipseWithX:y:radiusX:radiusY:]`, creating it if necessary.
+- (SPTessellation *)tessellationOfEllipseWithRadiusX:(float)radiusX radiusY:(float)radiusY;
+
+/// Returns the tessellation of a rectangle with its top left corner at the origin, creating it if
+/// necessary.
+- (SPTessellation *)tessellationOfRectangleWithWidth:(float)width height:(float)height;
+
+/// Returns the tessellation of a polygon (including its holes), creating it if necessary. The
+/// cache stores an immutable copy of the polygon, so the original can be modified afterwards.
+- (SPTessellation *)tessellationOfPolygon:(SPPolygon *)polygon;
+
+/// Removes all tessellations from the cache.
+- (void)purge;
+
+/// Resets `numHits`, `numMisses` and `savedTime` to zero.
+- (void)resetStatistics;
+
+/// ----------------
+/// @name Properties
+/// ----------------
+
+/// The maximum number of vertices the cache stores. Shapes with more vertices are created on each
+/// request. Lowering the capacity discards shapes right away. Default: 16384.
+@property (nonatomic, assign) NSInteger capacity;
+
+/// The number of vertices currently stored in the cache.
+@property (nonatomic, readonly) NSInteger numVertices;
+
+/// The number of shapes currently stored in the cache.
+@property (nonatomic, readonly) NSInteger numTessellations;
+
+/// The number of requests that were answered with a stored tessellation.
+@property (nonatomic, readonly) NSInteger numHits;
+
+/// The number of requests for which a tessellation had to be created.
+@property (nonatomic, readonly) NSInteger numMisses;
+
+/// The ratio of hits to all requests, between 0 and 1.
+@property (nonatomic, readonly) float hitRate;
+
+/// The time in seconds that was saved by the hits, i.e. the sum of the times it took to create
+/// the tessellations that were returned from the cache.
+@property (nonatomic, readonly) double savedTime;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,328 @@
+//
+//  SPTessellationCache.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPIndexData.h"
+#import "SPMacros.h"
+#import "SPPolygon.h"
+#import "SPPolygon_Internal.h"
+#import "SPTessellationCache.h"
+#import "SPVertexData.h"
+
+#import <QuartzCore/QuartzCore.h>
+
+#define DEFAULT_CAPACITY 16384
+
+typedef NS_ENUM(NSInteger, SPShapeType)
+{
+    SPShapeTypeEllipse,
+    SPShapeTypeRectangle,
+    SPShapeTypePolygon,
+};
+
+typedef struct
+{
+    SPShapeType type;
+    float width;  // radiusX for ellipses
+    float height; // radiusY for ellipses
+    NSInteger numVertices;
+    NSInteger numHoles;
+    const GLKVector2 *vertices;
+    const NSInteger *holeIndices;
+    CFHashCode hash;
+} SPShapeKey;
+
+// --- C functions ---------------------------------------------------------------------------------
+
+static CFHashCode hashWords(CFHashCode hash, const void *data, size_t numBytes)
+{
+    // FNV-1a, applied to 32 bit words; all key data consists of floats and integers
+    const uint32_t *words = data;
+    for (size_t i=0; i<numBytes / 4; ++i)
+        hash = (hash ^ words[i]) * 16777619;
+
+    return hash;
+}
+
+static SPShapeKey makeShapeKey(SPShapeType type, float width, float height, SPPolygon *polygon)
+{
+    SPShapeKey key = { type, width, height, 0, 0, NULL, NULL, 2166136261 };
+    key.hash = hashWords(key.hash, &key.type, sizeof(key.type));
+    key.hash = hashWords(key.hash, &key.width, sizeof(float) * 2);
+
+    if (polygon)
+    {
+        key.numVertices = polygon.numVertices;
+        key.numHoles = polygon.numHoles;
+        key.vertices = polygon.vertices;
+        key.holeIndices = polygon.holeIndices;
+        key.hash = hashWords(key.hash, key.vertices, sizeof(GLKVector2) * key.numVertices);
+        key.hash = hashWords(key.hash, key.holeIndices, sizeof(NSInteger) * key.numHoles);
+    }
+
+    return key;
+}
+
+static Boolean shapeKeysEqual(const void *value1, const void *value2)
+{
+    // floats are compared bitwise, so that keys containing NaN can still be found (and removed)
+    const SPShapeKey *a = value1;
+    const SPShapeKey *b = value2;
+
+    if (a->hash != b->hash || a->type != b->type || a->numVertices != b->numVertices ||
+        a->numHoles != b->numHoles || memcmp(&a->width, &b->width, sizeof(float) * 2))
+        return false;
+
+    return (!a->numVertices || !memcmp(a->vertices, b->vertices, sizeof(GLKVector2) * a->numVertices)) &&
+           (!a->numHoles || !memcmp(a->holeIndices, b->holeIndices, sizeof(NSInteger) * a->numHoles));
+}
+
+static CFHashCode shapeKeyHash(const void *value)
+{
+    return ((const SPShapeKey *)value)->hash;
+}
+
+// --- SPTessellation ------------------------------------------------------------------------------
+
+@interface SPTessellation ()
+
+- (instancetype)initWithPolygon:(SPPolygon *)polygon;
+
+@end
+
+@implementation SPTessellation
+{
+  @package
+    SPShapeKey _key;
+    double _cost;
+    SPTessellation *_newer; // not retained
+    SPTessellation *_older; // not retained
+}
+
+- (instancetype)initWithPolygon:(SPPolygon *)polygon
+{
+    if ((self = [super init]))
+    {
+        _polygon = [polygon retain];
+        _indexData = [[polygon triangulate:nil] retain];
+        _vertexData = [[SPVertexData alloc] initWithSize:polygon.numVertices];
+        [polygon copyToVertexData:_vertexData atIndex:0];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_polygon release];
+    [_indexData release];
+    [_vertexData release];
+    [super dealloc];
+}
+
+@end
+
+// --- class implementation ------------------------------------------------------------------------
+
+@implementation SPTessellationCache
+{
+    CFMutableDictionaryRef _tessellations;
+    SPTessellation *_newest;
+    SPTessellation *_oldest;
+}
+
+#pragma mark Initialization
+
+- (instancetype)initWithCapacity:(NSInteger)capacity
+{
+    if ((self = [super init]))
+    {
+        // the keys are stored within the tessellations, which are retained as values
+        CFDictionaryKeyCallBacks keyCallBacks = { 0, NULL, NULL, NULL, shapeKeysEqual, shapeKeyHash };
+        _tessellations = CFDictionaryCreateMutable(NULL, 0, &keyCallBacks, &kCFTypeDictionaryValueCallBacks);
+        _capacity = capacity;
+    }
+    return self;
+}
+
+- (instancetype)init
+{
+    return [self initWithCapacity:DEFAULT_CAPACITY];
+}
+
+- (void)dealloc
+{
+    CFRelease(_tessellations);
+    [super dealloc];
+}
+
++ (instancetype)sharedCache
+{
+    static SPTessellationCache *sharedCache = nil;
+    static dispatch_once_t onceToken;
+
+    NSAssert([NSThread isMainThread], @"the shared tessellation cache must only be used on the main thread");
+
+    dispatch_once(&onceToken, ^
+    {
+        sharedCache = [[SPTessellationCache alloc] init];
+    });
+
+    return sharedCache;
+}
+
+#pragma mark Methods
+
+- (SPTessellation *)tessellationOfEllipseWithRadiusX:(float)radiusX radiusY:(float)radiusY
+{
+    SPShapeKey key = makeShapeKey(SPShapeTypeEllipse, radiusX, radiusY, nil);
+    return [self tessellationWithKey:&key polygon:nil];
+}
+
+- (SPTessellation *)tessellationOfRectangleWithWidth:(float)width height:(float)height
+{
+    SPShapeKey key = makeShapeKey(SPShapeTypeRectangle, width, height, nil);
+    return [self tessellationWithKey:&key polygon:nil];
+}
+
+- (SPTessellation *)tessellationOfPolygon:(SPPolygon *)polygon
+{
+    SPShapeKey key = makeShapeKey(SPShapeTypePolygon, 0, 0, polygon);
+    return [self tessellationWithKey:&key polygon:polygon];
+}
+
+- (void)purge
+{
+    CFDictionaryRemoveAllValues(_tessellations);
+    _newest = _oldest = nil;
+    _numVertices = 0;
+}
+
+- (void)resetStatistics
+{
+    _numHits = _numMisses = 0;
+    _savedTime = 0.0;
+}
+
+#pragma mark Properties
+
+- (void)setCapacity:(NSInteger)capacity
+{
+    _capacity = capacity;
+    [self discardTessellationsUntilNumVertices:capacity];
+}
+
+- (NSInteger)numTessellations
+{
+    return CFDictionaryGetCount(_tessellations);
+}
+
+- (float)hitRate
+{
+    NSInteger numRequests = _numHits + _numMisses;
+    return numRequests ? (float)_numHits / numRequests : 0.0f;
+}
+
+#pragma mark Private
+
+- (SPTessellation *)tessellationWithKey:(SPShapeKey *)key polygon:(SPPolygon *)polygon
+{
+    SPTessellation *tessellation = (SPTessellation *)CFDictionaryGetValue(_tessellations, key);
+
+    if (tessellation)
+    {
+        ++_numHits;
+        _savedTime += tessellation->_cost;
+
+        [self unlinkTessellation:tessellation];
+        [self linkTessellation:tessellation];
+        return tessellation;
+    }
+
+    ++_numMisses;
+
+    double startTime = CACurrentMediaTime();
+    SPPolygon *shape;
+
+    switch (key->type)
+    {
+        case SPShapeTypeEllipse:
+            shape = [SPPolygon elipseWithX:0 y:0 radiusX:key->width radiusY:key->height];
+            break;
+        case SPShapeTypeRectangle:
+            shape = [SPPolygon rectangleWithX:0 y:0 width:key->width height:key->height];
+            break;
+        default:
+            shape = [polygon immutableCopy];
+            break;
+    }
+
+    tessellation = [[[SPTessellation alloc] initWithPolygon:shape] autorelease];
+    tessellation->_cost = CACurrentMediaTime() - startTime;
+    tessellation->_key = *key;
+
+    // the key must not reference the vertices of the original polygon, which might change;
+    // those of the copy can't
+    if (key->type == SPShapeTypePolygon)
+    {
+        tessellation->_key.vertices = shape.vertices;
+        tessellation->_key.holeIndices = shape.holeIndices;
+    }
+
+    NSInteger numVertices = tessellation.vertexData.numVertices;
+
+    if (numVertices <= _capacity)
+    {
+        [self discardTessellationsUntilNumVertices:_capacity - numVertices];
+
+        CFDictionarySetValue(_tessellations, &tessellation->_key, tessellation);
+        [self linkTessellation:tessellation];
+        _numVertices += numVertices;
+    }
+
+    return tessellation;
+}
+
+- (void)discardTessellationsUntilNumVertices:(NSInteger)numVertices
+{
+    while (_oldest && _numVertices > numVertices)
+    {
+        SPTessellation *tessellation = [_oldest retain];
+
+        [self unlinkTessellation:tessellation];
+        CFDictionaryRemoveValue(_tessellations, &tessellation->_key);
+        _numVertices -= tessellation.vertexData.numVertices;
+
+        [tessellation release];
+    }
+}
+
+- (void)linkTessellation:(SPTessellation *)tessellation
+{
+    tessellation->_older = _newest;
+    tessellation->_newer = nil;
+
+    if (_newest) _newest->_newer = tessellation;
+    else _oldest = tessellation;
+
+    _newest = tessellation;
+}
+
+- (void)unlinkTessellation:(SPTessellation *)tessellation
+{
+    if (tessellation->_newer) tessellation->_newer->_older = tessellation->_older;
+    else _newest = tessellation->_older;
+
+    if (tessellation->_older) tessellation->_older->_newer = tessellation->_newer;
+    else _oldest = tessellation->_newer;
+
+    tessellation->_newer = tessellation->_older = nil;
+}
+
+@end
@@ -11,6 +11,7 @@
 
 #import "SparrowClass.h"
 #import "SPBitmapFont.h"
+#import "SPDisplayObject_Internal.h"
 #import "SPEnterFrameEvent.h"
 #import "SPGLTexture.h"
 #import "SPImage.h"
@@ -214,6 +215,12 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     return [_hitArea boundsAfterTransformation:matrix];
 }
 
+- (SPRectValue)boundsValueInParent
+{
+    if (_requiresRedraw) [self redraw];
+    return [super boundsValueInParent];
+}
+
 - (void)setWidth:(float)width
 {
     // other than in SPDisplayObject, changing the size of the object should not change the scaling;
@@ -221,13 +228,19 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     // keeping the size of the text/font unchanged. (this applies to setHeight:, as well.)
 
     _hitArea.width = width;
-    _requiresRedraw = YES;
+    [self setRequiresRedraw];
 }
 
 - (void)setHeight:(float)height
 {
     _hitArea.height = height;
-    _requiresRedraw = YES;
+    [self setRequiresRedraw];
+}
+
+- (void)applyPendingUpdates
+{
+    if (_requiresRedraw) [self redraw];
+    [super applyPendingUpdates];
 }
 
 #pragma mark Events
@@ -270,7 +283,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (![text isEqualToString:_text])
     {
         SP_RELEASE_AND_COPY(_text, text);
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -282,7 +295,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
             [SPTextField registerBitmapFont:[[[SPBitmapFont alloc] initWithMiniFont] autorelease]];
 
         SP_RELEASE_AND_COPY(_fontName, fontName);
-        _requiresRedraw = YES;        
+        [self setRequiresRedraw];        
         _isRenderedText = !bitmapFonts[_fontName];
     }
 }
@@ -292,7 +305,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (fontSize != _fontSize)
     {
         _fontSize = fontSize;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -301,7 +314,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (color != _color)
     {
         _color = color;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
  
@@ -310,7 +323,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (hAlign != _hAlign)
     {
         _hAlign = hAlign;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -319,7 +332,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (vAlign != _vAlign)
     {
         _vAlign = vAlign;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -352,7 +365,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (bold != _bold)
     {
         _bold = bold;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -361,7 +374,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (italic != _italic)
     {
         _italic = italic;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -370,7 +383,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (underline != _underline)
     {
         _underline = underline;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -379,7 +392,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
 	if (kerning != _kerning)
 	{
 		_kerning = kerning;
-		_requiresRedraw = YES;
+		[self setRequiresRedraw];
 	}
 }
 
@@ -388,7 +401,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (autoScale != _autoScale)
     {
         _autoScale = autoScale;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -397,7 +410,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (autoSize != _autoSize)
     {
         _autoSize = autoSize;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -412,7 +425,7 @@ static NSTextAlignment hAlignToTextAlignment[] = {
     if (leading != _leading)
     {
         _leading = leading;
-        _requiresRedraw = YES;
+        [self setRequiresRedraw];
     }
 }
 
@@ -425,6 +438,12 @@ static NSTextAlignment hAlignToTextAlignment[] = {
 
 #pragma mark Private
 
+- (void)setRequiresRedraw
+{
+    _requiresRedraw = YES;
+    [self markDirty:SPDirtyFlagVertices];
+}
+
 - (BOOL)isVerticalAutoSize
 {
     return (_autoSize & SPTextFieldAutoSizeVertical) != 0;
@@ -280,6 +280,11 @@ typedef void (^SPTextureLoadingBlock)(SPTexture *__nullable texture, NSError *__
 /// The OpenGL texture format of this texture.
 @property (nonatomic, readonly) SPTextureFormat format;
 
+/// Indicates if every pixel of the texture is fully opaque, which is the case for formats without
+/// an alpha channel. Opaque images hide whatever lies behind them; see
+/// `[SPRenderSupport cullsOccludedObjects]`.
+@property (nonatomic, readonly) BOOL opaque;
+
 /// Indicates if the texture contains mipmaps.
 @property (nonatomic, readonly) BOOL mipmaps;
 
@@ -16,6 +16,7 @@
 #import "SPNSExtensions.h"
 #import "SPOpenGL.h"
 #import "SPPVRData.h"
+#import "SPProfiler.h"
 #import "SPRectangle.h"
 #import "SPStage.h"
 #import "SPSubTexture.h"
@@ -66,6 +67,8 @@ static SPCache<NSString*, SPTexture*> *textureCache = nil;
         return [cachedTexture retain];
     }
 
+    SP_PROFILE_ZONE("SPTexture.loadFile");
+
     NSString *fullPath = [SPUtils absolutePathToFile:path];
     if (!fullPath)
         [NSException raise:SPExceptionFileNotFound format:@"File '%@' not found", path];
@@ -185,6 +188,7 @@ static SPCache<NSString*, SPTexture*> *textureCache = nil;
 
 - (instancetype)initWithContentsOfImage:(UIImage *)image generateMipmaps:(BOOL)mipmaps
 {
+    SP_PROFILE_ZONE("SPTexture.loadImage");
     return [self initWithWidth:image.size.width height:image.size.height generateMipmaps:mipmaps
                          scale:image.scale draw:^(CGContextRef context)
             {
@@ -410,6 +414,21 @@ static SPCache<NSString*, SPTexture*> *textureCache = nil;
     return SPTextureFormatRGBA;
 }
 
+- (BOOL)opaque
+{
+    switch (self.format)
+    {
+        case SPTextureFormat565:
+        case SPTextureFormat888:
+        case SPTextureFormatPvrtcRGB2:
+        case SPTextureFormatPvrtcRGB4:
+        case SPTextureFormatI8:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
 - (BOOL)mipmaps
 {
     return NO;
@@ -55,6 +55,10 @@ NS_ASSUME_NONNULL_BEGIN
 	<SubTexture name='trimmed' x='0' y='0' height='10' width='10'
 	            frameX='-10' frameY='-10' frameWidth='30' frameHeight='30'/>
  
+ Regions that contain no transparent pixels at all (like backgrounds) can be marked with
+ `opaque='true'`. Images showing them hide whatever lies behind them, which allows the render
+ support to skip those objects (see `[SPRenderSupport cullsOccludedObjects]`).
+ 
 ------------------------------------------------------------------------------------------------- */
 
 @interface SPTextureAtlas : NSObject
@@ -106,6 +110,11 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)addRegion:(SPRectangle *)region withName:(NSString *)name frame:(nullable SPRectangle *)frame
           rotated:(BOOL)rotated;
 
+/// Creates a region for a subtexture with a frame and gives it a name. If `opaque` is `YES`, the
+/// region contains no transparent pixels, even though the atlas texture has an alpha channel.
+- (void)addRegion:(SPRectangle *)region withName:(NSString *)name frame:(nullable SPRectangle *)frame
+          rotated:(BOOL)rotated opaque:(BOOL)opaque;
+
 /// Removes a region with a certain name.
 - (void)removeRegion:(NSString *)name;
 
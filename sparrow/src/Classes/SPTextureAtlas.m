@@ -26,27 +26,30 @@
     SPRectangle *_region;
     SPRectangle *_frame;
     BOOL _rotated;
+    BOOL _opaque;
 }
 
 - (instancetype)initWithRegion:(SPRectangle *)region frame:(SPRectangle *)frame
-                       rotated:(BOOL)rotated;
+                       rotated:(BOOL)rotated opaque:(BOOL)opaque;
 
 @property (nonatomic, readonly) SPRectangle *region;
 @property (nonatomic, readonly) SPRectangle *frame;
 @property (nonatomic, readonly) BOOL rotated;
+@property (nonatomic, readonly) BOOL opaque;
 
 @end
 
 @implementation SPTextureInfo
 
 - (instancetype)initWithRegion:(SPRectangle *)region frame:(SPRectangle *)frame
-                       rotated:(BOOL)rotated;
+                       rotated:(BOOL)rotated opaque:(BOOL)opaque;
 {
     if ((self = [super init]))
     {
         _region  = [region copy];
         _frame   = [frame  copy];
         _rotated = rotated;
+        _opaque  = opaque;
     }
     return self;
 }
@@ -121,6 +124,7 @@
     {
         texture = [[SPSubTexture alloc] initWithRegion:info.region frame:info.frame
                                                rotated:info.rotated ofTexture:_atlasTexture];
+        texture.opaque = info.opaque;
         [texture autorelease];
     }
 
@@ -180,7 +184,14 @@
 - (void)addRegion:(SPRectangle *)region withName:(NSString *)name frame:(SPRectangle *)frame
           rotated:(BOOL)rotated
 {
-    SPTextureInfo *info = [[SPTextureInfo alloc] initWithRegion:region frame:frame rotated:rotated];
+    [self addRegion:region withName:name frame:frame rotated:rotated opaque:NO];
+}
+
+- (void)addRegion:(SPRectangle *)region withName:(NSString *)name frame:(SPRectangle *)frame
+          rotated:(BOOL)rotated opaque:(BOOL)opaque
+{
+    SPTextureInfo *info = [[SPTextureInfo alloc] initWithRegion:region frame:frame
+                                                        rotated:rotated opaque:opaque];
     _textureInfos[name] = info;
     [info release];
 }
@@ -236,6 +247,7 @@
             float frameWidth = [attributes[@"frameWidth"] floatValue] / scale;
             float frameHeight = [attributes[@"frameHeight"] floatValue] / scale;
             BOOL  rotated = [attributes[@"rotated"] boolValue];
+            BOOL  opaque = [attributes[@"opaque"] boolValue];
 
             SPRectangle *region = [SPRectangle rectangleWithX:x y:y width:width height:height];
             SPRectangle *frame = nil;
@@ -243,7 +255,7 @@
             if (frameWidth && frameHeight)
                 frame = [SPRectangle rectangleWithX:frameX y:frameY width:frameWidth height:frameHeight];
 
-            [self addRegion:region withName:name frame:frame rotated:rotated];
+            [self addRegion:region withName:name frame:frame rotated:rotated opaque:opaque];
         }
         else if ([elementName isEqualToString:@"TextureAtlas"] && !_atlasTexture)
         {
@@ -38,6 +38,58 @@ typedef struct
 SP_EXTERN SPVertexColor SPVertexColorMake(uchar r, uchar g, uchar b, uchar a);
 SP_EXTERN SPVertexColor SPVertexColorMakeWithColorAndAlpha(uint rgb, float alpha);
 
+/// Transforms the positions of 'count' vertices in place. Texture coordinates and colors are not
+/// touched. Uses a SIMD kernel that processes four vertices per iteration where available.
+SP_EXTERN void SPVertexTransformPositions(SPVertex *vertices, NSInteger count, GLKMatrix3 matrix);
+
+/// Portable scalar version of 'SPVertexTransformPositions'.
+SP_EXTERN void SPVertexTransformPositionsScalar(SPVertex *vertices, NSInteger count, GLKMatrix3 matrix);
+
+/// The layout of vertices uploaded to a vertex buffer. The standard format uploads the `SPVertex`
+/// structs unchanged; the other options pack them more tightly and may be combined.
+typedef NS_OPTIONS(uint, SPVertexFormat)
+{
+    /// The unchanged `SPVertex` struct.
+    SPVertexFormatStandard          = 0,
+
+    /// Positions are stored as half floats (requires `OES_vertex_half_float`, which is available
+    /// on all iOS devices). Coordinates up to 1024 keep a precision of half a point, so this only
+    /// suits batches with small local coordinates, like the elements of a user interface.
+    SPVertexFormatHalfPositions     = 1 << 0,
+
+    /// Texture coordinates are stored as normalized unsigned shorts, which requires coordinates
+    /// between zero and one (i.e. textures that don't repeat).
+    SPVertexFormatShortTexCoords    = 1 << 1,
+
+    /// Colors are left out; only possible for untinted, textured quads.
+    SPVertexFormatNoColors          = 1 << 2,
+
+    /// Texture coordinates are left out; only possible for untextured quads.
+    SPVertexFormatNoTexCoords       = 1 << 3,
+
+    /// A texture slot is appended to each vertex; needed for quads that sample from several
+    /// textures. `SPVertex` has no such field, so the slot is left for its owner to fill in.
+    SPVertexFormatTextureSlot       = 1 << 4,
+
+    /// Packs texture coordinates and leaves out everything the quads don't need.
+    SPVertexFormatCompact           = SPVertexFormatShortTexCoords | SPVertexFormatNoColors |
+                                      SPVertexFormatNoTexCoords,
+};
+
+/// The byte offsets of the attributes within a packed vertex. Attributes that are left out
+/// have an offset of -1.
+typedef struct
+{
+    int stride;
+    int position;
+    int texCoords;
+    int color;
+    int textureSlot;
+} SPVertexLayout;
+
+/// Returns the layout of vertices in a certain format.
+SP_EXTERN SPVertexLayout SPVertexLayoutMake(SPVertexFormat format);
+
 /** ------------------------------------------------------------------------------------------------
  
  The SPVertexData class manages a raw list of vertex information, allowing direct upload
@@ -196,6 +248,12 @@ SP_EXTERN SPVertexColor SPVertexColorMakeWithColorAndAlpha(uint rgb, float alpha
 - (SPRectangle *)projectedBoundsAfterTransformation:(nullable SPMatrix3D *)matrix camPos:(SPVector3D *)camPos
                                             atIndex:(NSInteger)index numVertices:(NSInteger)count;
 
+/// Writes a range of vertices into a buffer, using a certain vertex format. The buffer must provide
+/// room for 'count' vertices of the format's stride. Texture slots are written as zero. Returns the
+/// number of bytes written.
+- (NSInteger)packVerticesInFormat:(SPVertexFormat)format intoBuffer:(void *)buffer
+                          atIndex:(NSInteger)index numVertices:(NSInteger)count;
+
 /// ----------------
 /// @name Properties
 /// ----------------
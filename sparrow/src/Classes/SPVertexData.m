@@ -17,6 +17,13 @@
 #import "SPVertexData.h"
 #import "SPVector3D.h"
 
+#if defined(__has_include) && __has_include(<simd/simd.h>)
+    #import <simd/simd.h>
+    #define SP_SIMD_VERTEX_TRANSFORM 1
+#else
+    #define SP_SIMD_VERTEX_TRANSFORM 0
+#endif
+
 #define MIN_ALPHA (5.0f / 255.0f)
 
 /// --- C methods ----------------------------------------------------------------------------------
@@ -65,6 +72,116 @@ BOOL isOpaqueWhite(SPVertexColor color)
     return color.a == 255 && color.r == 255 && color.g == 255 && color.b == 255;
 }
 
+SP_INLINE void transformPosition(SPVertex *vertex, GLKMatrix3 m)
+{
+    GLKVector2 pos = vertex->position;
+    vertex->position.x = m.m00 * pos.x + m.m10 * pos.y + m.m20;
+    vertex->position.y = m.m11 * pos.y + m.m01 * pos.x + m.m21;
+}
+
+void SPVertexTransformPositionsScalar(SPVertex *vertices, NSInteger count, GLKMatrix3 matrix)
+{
+    for (NSInteger i=0; i<count; ++i)
+        transformPosition(&vertices[i], matrix);
+}
+
+void SPVertexTransformPositions(SPVertex *vertices, NSInteger count, GLKMatrix3 matrix)
+{
+  #if SP_SIMD_VERTEX_TRANSFORM
+
+    // Four vertices of 20 bytes each are exactly five vectors. They are loaded as a whole, the
+    // coordinates are deinterleaved into one vector for x and one for y, transformed at once and
+    // shuffled back into place. The other lanes (texture coordinates and the color bits) are only
+    // moved by the shuffles, never computed with, so they come out unchanged.
+    //
+    //   a0: x0 y0 u0 v0 | a1: c0 x1 y1 u1 | a2: v1 c1 x2 y2 | a3: u2 v2 c2 x3 | a4: y3 u3 v3 c3
+
+    _Static_assert(sizeof(SPVertex) == 5 * sizeof(float), "SIMD kernel expects 20 byte vertices");
+
+    const float m00 = matrix.m00, m01 = matrix.m01, m10 = matrix.m10;
+    const float m11 = matrix.m11, m20 = matrix.m20, m21 = matrix.m21;
+    NSInteger i = 0;
+
+    for (NSInteger end = count & ~3; i<end; i+=4)
+    {
+        float *data = (float *)&vertices[i];
+        simd_float4 a0, a1, a2, a3, a4;
+
+        // 'memcpy' compiles to unaligned vector loads and stores
+        memcpy(&a0, data,      sizeof(a0));
+        memcpy(&a1, data + 4,  sizeof(a1));
+        memcpy(&a2, data + 8,  sizeof(a2));
+        memcpy(&a3, data + 12, sizeof(a3));
+        memcpy(&a4, data + 16, sizeof(a4));
+
+        simd_float4 xy01 = __builtin_shufflevector(a0, a1, 0, 1, 5, 6);
+        simd_float4 xy2x = __builtin_shufflevector(a2, a3, 2, 3, 7, 7);
+        simd_float4 xy23 = __builtin_shufflevector(xy2x, a4, 0, 1, 2, 4);
+
+        simd_float4 x = __builtin_shufflevector(xy01, xy23, 0, 2, 4, 6);
+        simd_float4 y = __builtin_shufflevector(xy01, xy23, 1, 3, 5, 7);
+        simd_float4 tx = m00 * x + m10 * y + m20;
+        simd_float4 ty = m11 * y + m01 * x + m21;
+
+        xy01 = __builtin_shufflevector(tx, ty, 0, 4, 1, 5);
+        xy23 = __builtin_shufflevector(tx, ty, 2, 6, 3, 7);
+
+        a0 = __builtin_shufflevector(a0, xy01, 4, 5, 2, 3);
+        a1 = __builtin_shufflevector(a1, xy01, 0, 6, 7, 3);
+        a2 = __builtin_shufflevector(a2, xy23, 0, 1, 4, 5);
+        a3 = __builtin_shufflevector(a3, xy23, 0, 1, 2, 6);
+        a4 = __builtin_shufflevector(a4, xy23, 7, 1, 2, 3);
+
+        memcpy(data,      &a0, sizeof(a0));
+        memcpy(data + 4,  &a1, sizeof(a1));
+        memcpy(data + 8,  &a2, sizeof(a2));
+        memcpy(data + 12, &a3, sizeof(a3));
+        memcpy(data + 16, &a4, sizeof(a4));
+    }
+
+    for (; i<count; ++i)
+        transformPosition(&vertices[i], matrix);
+
+  #else
+
+    SPVertexTransformPositionsScalar(vertices, count, matrix);
+
+  #endif
+}
+
+SPVertexLayout SPVertexLayoutMake(SPVertexFormat format)
+{
+    // every attribute starts at a multiple of four bytes, as recommended for OpenGL ES
+    SPVertexLayout layout = { 0, 0, -1, -1, -1 };
+    int offset = (format & SPVertexFormatHalfPositions) ? 4 : 8;
+
+    if (!(format & SPVertexFormatNoTexCoords))
+    {
+        layout.texCoords = offset;
+        offset += (format & SPVertexFormatShortTexCoords) ? 4 : 8;
+    }
+
+    if (!(format & SPVertexFormatNoColors))
+    {
+        layout.color = offset;
+        offset += 4;
+    }
+
+    if (format & SPVertexFormatTextureSlot)
+    {
+        layout.textureSlot = offset;
+        offset += 4;
+    }
+
+    layout.stride = offset;
+    return layout;
+}
+
+SP_INLINE ushort normalizeTexCoord(float value)
+{
+    return (ushort)(MAX(0.0f, MIN(1.0f, value)) * 65535.0f + 0.5f);
+}
+
 /// --- class implementation -----------------------------------------------------------------------
 
 @implementation SPVertexData
@@ -142,23 +259,13 @@ BOOL isOpaqueWhite(SPVertexColor color)
     SPVertex *targetVertices = &target->_vertices[targetIndex];
     SPVertex *fromVertices   = &_vertices[fromIndex];
     
+    // texture coordinates and colors are copied in bulk, positions are transformed afterwards;
+    // the target may be this instance, with overlapping ranges
+    if (targetVertices != fromVertices)
+        memmove(targetVertices, fromVertices, sizeof(SPVertex) * count);
+
     if (matrix)
-    {
-        GLKMatrix3 glkMatrix = [matrix convertToGLKMatrix3];
-        
-        for (NSInteger i=0; i<count; ++i)
-        {
-            GLKVector2 pos = fromVertices[i].position;
-            targetVertices[i].position.x = glkMatrix.m00 * pos.x + glkMatrix.m10 * pos.y + glkMatrix.m20;
-            targetVertices[i].position.y = glkMatrix.m11 * pos.y + glkMatrix.m01 * pos.x + glkMatrix.m21;
-            targetVertices[i].texCoords = fromVertices[i].texCoords;
-            targetVertices[i].color = fromVertices[i].color;
-        }
-    }
-    else
-    {
-        memcpy(&target->_vertices[targetIndex], _vertices, sizeof(SPVertex) * count);
-    }
+        SPVertexTransformPositions(targetVertices, count, [matrix convertToGLKMatrix3]);
 }
 
 - (SPVertex)vertexAtIndex:(NSInteger)index
@@ -338,15 +445,8 @@ BOOL isOpaqueWhite(SPVertexColor color)
         [NSException raise:SPExceptionIndexOutOfBounds format:@"Invalid index range"];
     
     if (!matrix) return;
-    
-    GLKMatrix3 glkMatrix = [matrix convertToGLKMatrix3];
-    
-    for (NSInteger i=index, end=index+count; i<end; ++i)
-    {
-        GLKVector2 pos = _vertices[i].position;
-        _vertices[i].position.x = glkMatrix.m00 * pos.x + glkMatrix.m10 * pos.y + glkMatrix.m20;
-        _vertices[i].position.y = glkMatrix.m11 * pos.y + glkMatrix.m01 * pos.x + glkMatrix.m21;
-    }
+
+    SPVertexTransformPositions(&_vertices[index], count, [matrix convertToGLKMatrix3]);
 }
 
 - (SPRectangle *)bounds
@@ -369,19 +469,20 @@ BOOL isOpaqueWhite(SPVertexColor color)
     
     if (count == 0)
     {
-        SPPoint *point = nil;
-        if (matrix) point = [matrix transformPointWithX:0 y:0];
-        else        point = [SPPoint pointWithX:0 y:0];
+        SPPointValue point = SPPointValueMake(0, 0);
+        if (matrix) point = SPMatrixValueTransformPoint(matrix.matrixValue, 0, 0);
         return [SPRectangle rectangleWithX:point.x y:point.y width:0 height:0];
     }
     else
     {
         if (matrix)
         {
+            SPMatrixValue matrixValue = matrix.matrixValue;
+
             for (NSInteger i=index; i<endIndex; ++i)
             {
                 GLKVector2 position = _vertices[i].position;
-                SPPoint *transformedPoint = [matrix transformPointWithX:position.x y:position.y];
+                SPPointValue transformedPoint = SPMatrixValueTransformPoint(matrixValue, position.x, position.y);
                 float tfX = transformedPoint.x;
                 float tfY = transformedPoint.y;
                 minX = MIN(minX, tfX);
@@ -453,6 +554,55 @@ BOOL isOpaqueWhite(SPVertexColor color)
     }
 }
 
+- (NSInteger)packVerticesInFormat:(SPVertexFormat)format intoBuffer:(void *)buffer
+                          atIndex:(NSInteger)index numVertices:(NSInteger)count
+{
+    if (index < 0 || count < 0 || index + count > _numVertices)
+        [NSException raise:SPExceptionIndexOutOfBounds format:@"Invalid vertex range"];
+
+    SPVertexLayout layout = SPVertexLayoutMake(format);
+
+    if (format == SPVertexFormatStandard)
+    {
+        memcpy(buffer, &_vertices[index], sizeof(SPVertex) * count);
+        return sizeof(SPVertex) * count;
+    }
+
+    BOOL halfPositions  = (format & SPVertexFormatHalfPositions)  != 0;
+    BOOL shortTexCoords = (format & SPVertexFormatShortTexCoords) != 0;
+    char *target = (char *)buffer;
+
+    for (NSInteger i=0; i<count; ++i, target += layout.stride)
+    {
+        SPVertex *vertex = &_vertices[index + i];
+
+        if (halfPositions)
+        {
+            ((__fp16 *)target)[0] = vertex->position.x;
+            ((__fp16 *)target)[1] = vertex->position.y;
+        }
+        else memcpy(target, &vertex->position, sizeof(GLKVector2));
+
+        if (layout.texCoords != -1)
+        {
+            if (shortTexCoords)
+            {
+                ((ushort *)(target + layout.texCoords))[0] = normalizeTexCoord(vertex->texCoords.x);
+                ((ushort *)(target + layout.texCoords))[1] = normalizeTexCoord(vertex->texCoords.y);
+            }
+            else memcpy(target + layout.texCoords, &vertex->texCoords, sizeof(GLKVector2));
+        }
+
+        if (layout.color != -1)
+            memcpy(target + layout.color, &vertex->color, sizeof(SPVertexColor));
+
+        if (layout.textureSlot != -1)
+            memset(target + layout.textureSlot, 0, 4);
+    }
+
+    return layout.stride * count;
+}
+
 #pragma mark NSObject
 
 - (NSString *)description
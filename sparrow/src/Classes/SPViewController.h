@@ -17,8 +17,10 @@ NS_ASSUME_NONNULL_BEGIN
 @class SPContext;
 @class SPDisplayObject;
 @class SPJuggler;
+@class SPOverdrawAnalysis;
 @class SPProgram;
 @class SPRectangle;
+@class SPRenderDiagnostics;
 @class SPSprite;
 @class SPStage;
 @class SPTouchProcessor;
@@ -195,6 +197,20 @@ typedef void (^SPRootCreatedBlock)(SPSprite *root);
 /// Indicates if a small statistics box (with FPS and draw count) is displayed.
 @property (nonatomic, assign) BOOL showStats;
 
+/// Indicates if the render support records why each batch of a frame was drawn; see
+/// `renderDiagnostics`. Only available in builds with `SP_RENDER_DIAGNOSTICS` (e.g. debug builds).
+@property (nonatomic, assign) BOOL recordsRenderDiagnostics;
+
+/// The batches drawn in the last frame, or `nil` if `recordsRenderDiagnostics` is disabled.
+@property (nonatomic, readonly, nullable) SPRenderDiagnostics *renderDiagnostics;
+
+/// Indicates if objects that are completely hidden behind opaque quads are skipped while rendering
+/// the stage; see `[SPRenderSupport cullsOccludedObjects]`. Default: `NO`.
+@property (nonatomic, assign) BOOL cullsOccludedObjects;
+
+/// Measures the overdraw of each frame that is rendered; see SPOverdrawAnalysis. Default: `nil`.
+@property (nonatomic, strong, nullable) SPOverdrawAnalysis *overdrawAnalysis;
+
 /// Indicates if retina display support is enabled.
 @property (nonatomic, readonly) BOOL supportHighResolutions;
 
@@ -16,9 +16,11 @@
 #import "SPOpenGL.h"
 #import "SPJuggler.h"
 #import "SPPoint.h"
+#import "SPProfiler.h"
 #import "SPProgram.h"
 #import "SPRectangle.h"
 #import "SPRenderSupport.h"
+#import "SPRenderSupport_Internal.h"
 #import "SPResizeEvent.h"
 #import "SPStage_Internal.h"
 #import "SPStatsDisplay.h"
@@ -248,6 +250,9 @@
 
 - (void)nextFrame
 {
+    [SPProfiler beginFrame];
+    SP_PROFILE_ZONE("SPViewController.nextFrame");
+
     double now = _displayLink.timestamp;
     double passedTime = now - _lastFrameTimestamp;
     _lastFrameTimestamp = now;
@@ -262,6 +267,8 @@
 
 - (void)advanceTime:(double)passedTime
 {
+    SP_PROFILE_ZONE("SPViewController.advanceTime");
+
     @autoreleasepool
     {
         [self makeCurrent];
@@ -276,6 +283,8 @@
     if (!_context)   [self setupContext];
     if (!_context)   return;
     
+    SP_PROFILE_ZONE("SPViewController.render");
+    
     @autoreleasepool
     {
         if ([_context makeCurrentContext])
@@ -293,8 +302,13 @@
             [_support nextFrame];
             [_support setStencilReferenceValue:0];
             [_support setRenderTarget:nil];
-            [_stage render:_support];
-            [_support finishQuadBatch];
+            
+            {
+                SP_PROFILE_ZONE("SPViewController.renderStage");
+                [_support findOccludedObjectsOf:_stage];
+                [_stage render:_support];
+                [_support finishQuadBatchWithReason:SPBatchBreakReasonEndOfFrame object:nil];
+            }
             
             if (_statsDisplay)
                 _statsDisplay.numDrawCalls = _support.numDrawCalls - 2; // stats display requires 2 itself
@@ -303,7 +317,10 @@
             [SPRenderSupport checkForOpenGLError];
           #endif
             
-            [_context present];
+            {
+                SP_PROFILE_ZONE("SPViewController.present");
+                [_context present];
+            }
         }
         else SPLog(@"WARNING: Unable to set the current rendering context.");
     }
@@ -343,6 +360,7 @@
     
     (async ? dispatch_async : dispatch_sync)(_resourceQueue, ^
     {
+        SP_PROFILE_ZONE("SPViewController.resourceQueue");
         [_resourceContext makeCurrentContext];
         block();
     });
@@ -554,6 +572,41 @@
     _statsDisplay.visible = showStats;
 }
 
+- (BOOL)recordsRenderDiagnostics
+{
+    return _support.recordsDiagnostics;
+}
+
+- (void)setRecordsRenderDiagnostics:(BOOL)recordsRenderDiagnostics
+{
+    _support.recordsDiagnostics = recordsRenderDiagnostics;
+}
+
+- (SPRenderDiagnostics *)renderDiagnostics
+{
+    return _support.diagnostics;
+}
+
+- (BOOL)cullsOccludedObjects
+{
+    return _support.cullsOccludedObjects;
+}
+
+- (void)setCullsOccludedObjects:(BOOL)cullsOccludedObjects
+{
+    _support.cullsOccludedObjects = cullsOccludedObjects;
+}
+
+- (SPOverdrawAnalysis *)overdrawAnalysis
+{
+    return _support.overdrawAnalysis;
+}
+
+- (void)setOverdrawAnalysis:(SPOverdrawAnalysis *)overdrawAnalysis
+{
+    _support.overdrawAnalysis = overdrawAnalysis;
+}
+
 - (void)setAntiAliasing:(NSInteger)antiAliasing
 {
     if (antiAliasing != _antiAliasing)
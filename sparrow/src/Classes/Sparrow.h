@@ -48,6 +48,7 @@ FOUNDATION_EXPORT const unsigned char SparrowVersionString[];
 #import <Sparrow/SPEnterFrameEvent.h>
 #import <Sparrow/SPEvent.h>
 #import <Sparrow/SPEventDispatcher.h>
+#import <Sparrow/SPGeometryValues.h>
 #import <Sparrow/SPGLTexture.h>
 #import <Sparrow/SPJuggler.h>
 #import <Sparrow/SPImage.h>
@@ -55,17 +56,22 @@ FOUNDATION_EXPORT const unsigned char SparrowVersionString[];
 #import <Sparrow/SPMacros.h>
 #import <Sparrow/SPMatrix.h>
 #import <Sparrow/SPMatrix3D.h>
+#import <Sparrow/SPMeshBatch.h>
 #import <Sparrow/SPMovieClip.h>
 #import <Sparrow/SPNSExtensions.h>
 #import <Sparrow/SPOpenGL.h>
+#import <Sparrow/SPOpenGLRecorder.h>
+#import <Sparrow/SPOverdrawAnalysis.h>
 #import <Sparrow/SPOverlayView.h>
 #import <Sparrow/SPPolygon.h>
 #import <Sparrow/SPPoint.h>
+#import <Sparrow/SPProfiler.h>
 #import <Sparrow/SPProgram.h>
 #import <Sparrow/SPPVRData.h>
 #import <Sparrow/SPQuad.h>
 #import <Sparrow/SPQuadBatch.h>
 #import <Sparrow/SPRectangle.h>
+#import <Sparrow/SPRenderDiagnostics.h>
 #import <Sparrow/SPRenderSupport.h>
 #import <Sparrow/SPRenderTexture.h>
 #import <Sparrow/SPResizeEvent.h>
@@ -75,6 +81,7 @@ FOUNDATION_EXPORT const unsigned char SparrowVersionString[];
 #import <Sparrow/SPSprite3D.h>
 #import <Sparrow/SPStage.h>
 #import <Sparrow/SPSubTexture.h>
+#import <Sparrow/SPTessellationCache.h>
 #import <Sparrow/SPTextField.h>
 #import <Sparrow/SPTexture.h>
 #import <Sparrow/SPTextureAtlas.h>
@@ -0,0 +1,190 @@
+//
+//  SPCanvasTest.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPTestCase.h"
+
+@interface SPCanvasTest : SPTestCase
+
+@end
+
+@implementation SPCanvasTest
+{
+    SGLRecorderRef _recorder;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    _recorder = sglRecorderCreate();
+    sglRecorderBegin(_recorder);
+}
+
+- (void)tearDown
+{
+    sglRecorderEnd(_recorder);
+    sglRecorderRelease(_recorder);
+
+    [super tearDown];
+}
+
+- (void)testAppendedPolygonsAreUploadedIncrementally
+{
+    // only canvases too big to be batched use buffers of their own
+
+    SPCanvas *canvas = [[SPCanvas alloc] init];
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    NSInteger numBytesPerRectangle = 4 * sizeof(SPVertex) + 6 * sizeof(ushort);
+
+    [self drawNumRectangles:100 onCanvas:canvas];
+    [self renderObject:canvas withSupport:support];
+
+    XCTAssertEqual(2, [self numCommandsNamed:"glGenBuffers"], @"buffers were not created");
+    XCTAssertEqual(100 * numBytesPerRectangle, sglRecorderGetNumBytesUploaded(_recorder), @"wrong upload");
+
+    // appending a polygon uploads only that polygon
+
+    [canvas drawRectangleWithX:20 y:0 width:10 height:10];
+    [self renderObject:canvas withSupport:support];
+
+    XCTAssertEqual(0, [self numCommandsNamed:"glGenBuffers"], @"buffers were recreated");
+    XCTAssertEqual(0, [self numCommandsNamed:"glBufferData"], @"buffers were reallocated");
+    XCTAssertEqual(numBytesPerRectangle, sglRecorderGetNumBytesUploaded(_recorder), @"wrong upload");
+
+    // nothing is uploaded if nothing changed
+
+    [self renderObject:canvas withSupport:support];
+    XCTAssertEqual(0, sglRecorderGetNumBytesUploaded(_recorder), @"unchanged canvas was uploaded");
+
+    // after clearing, the buffers are filled up from the start
+
+    [canvas clear];
+    [self drawNumRectangles:100 onCanvas:canvas];
+    [self renderObject:canvas withSupport:support];
+
+    XCTAssertEqual(0, [self numCommandsNamed:"glGenBuffers"], @"buffers were recreated");
+    XCTAssertEqual(100 * numBytesPerRectangle, sglRecorderGetNumBytesUploaded(_recorder), @"wrong upload");
+    XCTAssertEqual(600, sglRecorderGetNumElementsDrawn(_recorder), @"old polygons were drawn");
+}
+
+- (void)testBuffersGrowByDoubling
+{
+    SPCanvas *canvas = [[SPCanvas alloc] init];
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    NSInteger numReallocations = 0;
+
+    [self drawNumRectangles:100 onCanvas:canvas];
+    [self renderObject:canvas withSupport:support];
+
+    for (int i=0; i<1000; ++i)
+    {
+        [canvas drawRectangleWithX:i y:0 width:1 height:1];
+        [self renderObject:canvas withSupport:support];
+        numReallocations += [self numCommandsNamed:"glBufferData"];
+    }
+
+    // 4400 vertices and 6600 indices outgrow their initial buffers 4 and 3 times, respectively
+    XCTAssertEqual(7, numReallocations, @"buffers did not grow by doubling");
+    XCTAssertEqual(6600, sglRecorderGetNumElementsDrawn(_recorder), @"not all polygons were drawn");
+}
+
+- (void)testSmallCanvasesAreBatched
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [SPSprite sprite];
+
+    for (int i=0; i<5; ++i)
+    {
+        SPQuad *quad = [SPQuad quadWithWidth:10 height:10 color:0xff0000];
+        quad.x = i * 20;
+        [sprite addChild:quad];
+
+        SPCanvas *canvas = [[SPCanvas alloc] init];
+        [canvas beginFill:0x00ff00 alpha:0.5f];
+        [canvas drawRectangleWithX:i * 20 y:20 width:10 height:10];
+        [sprite addChild:canvas];
+    }
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(1, support.numDrawCalls, @"canvases and quads were not batched");
+    XCTAssertEqual(1, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of recorded draw calls");
+    XCTAssertEqual(60, sglRecorderGetNumElementsDrawn(_recorder), @"wrong number of indices drawn");
+
+    // textured quads can't join the mesh; they end it
+
+    SPTexture *texture = [[SPGLTexture alloc] initWithName:1 format:SPTextureFormatRGBA width:16 height:16
+                                           containsMipmaps:NO scale:1.0f premultipliedAlpha:YES];
+    SPImage *image = [SPImage imageWithTexture:texture];
+    [sprite addChildAtIndex:image atIndex:4];
+
+  #if SP_RENDER_DIAGNOSTICS
+    support.recordsDiagnostics = YES;
+  #endif
+
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual(4, support.numDrawCalls, @"wrong number of draw calls");
+
+  #if SP_RENDER_DIAGNOSTICS
+    SPRenderDiagnostics *diagnostics = support.diagnostics;
+    XCTAssertEqual(2, [diagnostics numBatchesWithReason:SPBatchBreakReasonMesh], @"wrong reason");
+    XCTAssertEqual(image, diagnostics.batches[0].object, @"wrong object caused the break");
+  #endif
+}
+
+- (void)testBatchedCanvasesStreamIndices
+{
+    SPContext *context = [[SPContext alloc] init];
+    [context makeCurrentContext];
+
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPCanvas *canvas = [[SPCanvas alloc] init];
+    [canvas drawRectangleWithX:0 y:0 width:10 height:10];
+
+    [self renderObject:canvas withSupport:support];
+    [self renderObject:canvas withSupport:support];
+
+    // vertices and indices are appended to the context's buffers without reallocating them
+
+    XCTAssertEqual(1, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of draw calls");
+    XCTAssertEqual(2, [self numCommandsNamed:"glMapBufferRange"], @"data was not streamed");
+    XCTAssertEqual(0, [self numCommandsNamed:"glBufferData"], @"buffers were reallocated");
+    XCTAssertEqual(0, [self numCommandsNamed:"glBufferSubData"], @"data was uploaded synchronously");
+
+    [SPContext setCurrentContext:nil];
+}
+
+- (NSInteger)numCommandsNamed:(const char *)name
+{
+    NSInteger count = 0;
+
+    for (NSInteger i=0; i<sglRecorderGetNumCommands(_recorder); ++i)
+        if (strcmp(sglRecorderGetCommandAtIndex(_recorder, i)->name, name) == 0) ++count;
+
+    return count;
+}
+
+- (void)drawNumRectangles:(int)numRectangles onCanvas:(SPCanvas *)canvas
+{
+    for (int i=0; i<numRectangles; ++i)
+        [canvas drawRectangleWithX:i * 10 y:0 width:10 height:10];
+}
+
+- (void)renderObject:(SPDisplayObject *)object withSupport:(SPRenderSupport *)support
+{
+    sglRecorderReset(_recorder);
+
+    [support nextFrame];
+    [object render:support];
+    [support finishQuadBatch];
+}
+
+@end
@@ -201,6 +201,118 @@
     XCTAssertTrue([bounds isEqualToRectangle:expectedBounds], @"wrong bounds: %@", bounds);
 }
 
+- (void)testBoundsCache
+{
+    SPQuad *quad = [[SPQuad alloc] initWithWidth:10 height:20];
+    SPSprite *child = [[SPSprite alloc] init];
+    [child addChild:quad];
+    [child addChild:[SPQuad quadWithWidth:5 height:5]];
+
+    SPSprite *sprite = [[SPSprite alloc] init];
+    [sprite addChild:child];
+
+    SPRectangle *expectedBounds = [SPRectangle rectangleWithX:0 y:0 width:10 height:20];
+    SPRectangle *bounds = [sprite boundsInSpace:sprite];
+    XCTAssertTrue([bounds isEqualToRectangle:expectedBounds], @"wrong bounds: %@", bounds);
+
+    // the returned rectangle must not be the cache itself
+
+    bounds.width = 100;
+    bounds = [sprite boundsInSpace:sprite];
+    XCTAssertTrue([bounds isEqualToRectangle:expectedBounds], @"cache was modified: %@", bounds);
+
+    // changes deep down in the tree invalidate the cache
+
+    quad.x = 10;
+    quad.width = 30;
+    expectedBounds = [SPRectangle rectangleWithX:0 y:0 width:40 height:20];
+    bounds = [sprite boundsInSpace:sprite];
+    XCTAssertTrue([bounds isEqualToRectangle:expectedBounds], @"wrong bounds: %@", bounds);
+
+    [child removeChild:quad];
+    expectedBounds = [SPRectangle rectangleWithX:0 y:0 width:5 height:5];
+    bounds = [sprite boundsInSpace:sprite];
+    XCTAssertTrue([bounds isEqualToRectangle:expectedBounds], @"wrong bounds: %@", bounds);
+
+    // scaled and translated spaces use the cache, rotated ones stay exact
+
+    SPSprite *root = [[SPSprite alloc] init];
+    [root addChild:sprite];
+    child.x = -5;
+    sprite.x = 10;
+    sprite.scaleX = 2;
+    expectedBounds = [SPRectangle rectangleWithX:0 y:0 width:10 height:5];
+    bounds = [sprite boundsInSpace:root];
+    XCTAssertTrue([bounds isEqualToRectangle:expectedBounds], @"wrong bounds: %@", bounds);
+
+    sprite.scaleX = 1;
+    child.x = 0;
+    child.rotation = PI_HALF;
+    expectedBounds = [SPRectangle rectangleWithX:5 y:0 width:5 height:5];
+    bounds = [sprite boundsInSpace:root];
+    XCTAssertTrue([bounds isEqualToRectangle:expectedBounds], @"wrong bounds: %@", bounds);
+}
+
+- (void)testSpatialIndex
+{
+    SPSprite *sprite = [[SPSprite alloc] init];
+    sprite.usesSpatialIndex = YES;
+
+    for (int i=0; i<100; ++i)
+    {
+        SPQuad *tile = [SPQuad quadWithWidth:10 height:10];
+        tile.x = (i % 10) * 20;
+        tile.y = (i / 10) * 20;
+        [sprite addChild:tile];
+    }
+
+    SPDisplayObject *tile = [sprite childAtIndex:23];
+    XCTAssertEqual(tile, [sprite hitTestPoint:[SPPoint pointWithX:65 y:45]], @"wrong child hit");
+    XCTAssertNil([sprite hitTestPoint:[SPPoint pointWithX:75 y:45]], @"space between tiles was hit");
+
+    // moving children are found at their new position
+
+    tile.x = 70;
+    XCTAssertEqual(tile, [sprite hitTestPoint:[SPPoint pointWithX:75 y:45]], @"moved child not hit");
+    XCTAssertNil([sprite hitTestPoint:[SPPoint pointWithX:65 y:45]], @"old position was hit");
+
+    // so are children whose contents change; the front-most child wins
+
+    SPQuad *unitQuad = [SPQuad quadWithWidth:10 height:10];
+    SPSprite *unit = [SPSprite sprite];
+    [unit addChild:unitQuad];
+    [sprite addChild:unit];
+    XCTAssertEqual(unitQuad, [sprite hitTestPoint:[SPPoint pointWithX:5 y:5]], @"wrong z-order");
+
+    unitQuad.x = 150;
+    unitQuad.y = 150;
+    XCTAssertEqual(unitQuad, [sprite hitTestPoint:[SPPoint pointWithX:155 y:155]], @"moved content not hit");
+    XCTAssertEqual([sprite childAtIndex:0], [sprite hitTestPoint:[SPPoint pointWithX:5 y:5]],
+                   @"old position was hit");
+
+    // children spanning lots of cells are tested at any position
+
+    SPQuad *background = [SPQuad quadWithWidth:1000 height:1000];
+    [sprite addChild:background atIndex:0];
+    XCTAssertEqual(background, [sprite hitTestPoint:[SPPoint pointWithX:15 y:15]], @"background not hit");
+    XCTAssertEqual(tile, [sprite hitTestPoint:[SPPoint pointWithX:75 y:45]], @"wrong z-order");
+
+    // the results are the same as without the index
+
+    NSMutableArray *indexedResults = [NSMutableArray array];
+    for (int x=0; x<220; x+=7)
+        for (int y=0; y<220; y+=7)
+            [indexedResults addObject:[sprite hitTestPoint:[SPPoint pointWithX:x y:y]] ?: [NSNull null]];
+
+    sprite.usesSpatialIndex = NO;
+    NSInteger i = 0;
+
+    for (int x=0; x<220; x+=7)
+        for (int y=0; y<220; y+=7)
+            XCTAssertEqual(indexedResults[i++], [sprite hitTestPoint:[SPPoint pointWithX:x y:y]] ?: [NSNull null],
+                           @"wrong result at (%d, %d)", x, y);
+}
+
 - (void)testSize
 {
     SPQuad *quad1 = [SPQuad quadWithWidth:100 height:100];
@@ -256,6 +256,57 @@
     XCTAssertTrue([localPoint isEqualToPoint:expectedPoint], @"wrong local point");
 }
 
+- (void)testCachedTransformations
+{
+    SPSprite *root = [[SPSprite alloc] init];
+    SPSprite *sprite = [[SPSprite alloc] init];
+    SPSprite *sprite2 = [[SPSprite alloc] init];
+    SPSprite *sprite3 = [[SPSprite alloc] init];
+    [root addChild:sprite];
+    [sprite addChild:sprite2];
+    [root addChild:sprite3];
+
+    SPPoint *localPoint = [SPPoint pointWithX:0 y:0];
+    SPPoint *globalPoint = [sprite2 localToGlobal:localPoint];
+    XCTAssertTrue([globalPoint isEqualToPoint:localPoint], @"wrong global point");
+
+    // changes of an ancestor must reach the cached matrices of its descendants
+
+    sprite.x = 10;
+    sprite.rotation = PI_HALF;
+    globalPoint = [sprite2 localToGlobal:[SPPoint pointWithX:1 y:0]];
+    XCTAssertTrue([globalPoint isEqualToPoint:[SPPoint pointWithX:10 y:1]], @"wrong global point");
+
+    sprite3.y = 5;
+    SPMatrix *matrix = [sprite2 transformationMatrixToSpace:sprite3];
+    SPMatrix *expectedMatrix = [SPMatrix matrixWithA:0 b:1 c:-1 d:0 tx:10 ty:-5];
+    XCTAssertTrue([matrix isEqualToMatrix:expectedMatrix], @"wrong matrix: %@", matrix);
+
+    // the same goes for the cached inverse 3D matrix of the target space
+
+    matrix = [[sprite2 transformationMatrix3DToSpace:sprite3] convertTo2D];
+    XCTAssertTrue([matrix isEqualToMatrix:expectedMatrix], @"wrong 3D matrix: %@", matrix);
+
+    sprite3.y = 10;
+    matrix = [[sprite2 transformationMatrix3DToSpace:sprite3] convertTo2D];
+    expectedMatrix = [SPMatrix matrixWithA:0 b:1 c:-1 d:0 tx:10 ty:-10];
+    XCTAssertTrue([matrix isEqualToMatrix:expectedMatrix], @"wrong 3D matrix: %@", matrix);
+
+    sprite3.y = 5;
+
+    // so must moving an object into another parent
+
+    [sprite3 addChild:sprite2];
+    globalPoint = [sprite2 localToGlobal:localPoint];
+    XCTAssertTrue([globalPoint isEqualToPoint:[SPPoint pointWithX:0 y:5]], @"wrong global point");
+
+    localPoint = [sprite2 globalToLocal:globalPoint];
+    XCTAssertTrue([localPoint isEqualToPoint:[SPPoint pointWithX:0 y:0]], @"wrong local point");
+
+    [sprite2 removeFromParent];
+    XCTAssertThrows([sprite2 transformationMatrixToSpace:sprite3], @"object is not connected");
+}
+
 - (void)testHitTestPoint
 {
     SPQuad *quad = [[SPQuad alloc] initWithWidth:25 height:10];
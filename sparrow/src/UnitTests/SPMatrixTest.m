@@ -118,6 +118,31 @@
     XCTAssertTrue(SPIsFloatEqual(10.0f, ctPoint.y), @"wrong y value: %f", ctPoint.y);    
 }
 
+- (void)testMatrixValue
+{
+    SPMatrixValue value = countMatrix.matrixValue;
+    SPMatrix *matrix = [SPMatrix matrixWithValue:value];
+    XCTAssertTrue([countMatrix isEqualToMatrix:matrix], @"wrong matrix: %@", matrix);
+
+    SPMatrix *countDownMatrix = [[SPMatrix alloc] initWithA:9 b:8 c:7 d:6 tx:5 ty:4];
+    [matrix appendMatrix:countDownMatrix];
+    value = SPMatrixValueAppend(value, countDownMatrix.matrixValue);
+    XCTAssertTrue([matrix isEqualToMatrix:[SPMatrix matrixWithValue:value]], @"values differ after append");
+
+    [matrix prependMatrix:countDownMatrix];
+    value = SPMatrixValuePrepend(value, countDownMatrix.matrixValue);
+    XCTAssertTrue([matrix isEqualToMatrix:[SPMatrix matrixWithValue:value]], @"values differ after prepend");
+
+    [countMatrix invert];
+    value = SPMatrixValueInvert(SPMatrixValueMake(1, 2, 3, 4, 5, 6));
+    XCTAssertTrue([countMatrix isEqualToMatrix:[SPMatrix matrixWithValue:value]], @"values differ after invert");
+
+    SPPoint *point = [countMatrix transformPointWithX:10 y:20];
+    SPPointValue pointValue = SPMatrixValueTransformPoint(value, 10, 20);
+    XCTAssertTrue(SPIsFloatEqual(point.x, pointValue.x), @"wrong x value: %f", pointValue.x);
+    XCTAssertTrue(SPIsFloatEqual(point.y, pointValue.y), @"wrong y value: %f", pointValue.y);
+}
+
 - (BOOL)checkMatrixValues:(SPMatrix *)matrix a:(float)a b:(float)b c:(float)c d:(float)d 
                        tx:(float)tx ty:(float)ty
 {
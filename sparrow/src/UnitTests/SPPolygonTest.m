@@ -0,0 +1,171 @@
+//
+//  SPPolygonTest.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPTestCase.h"
+
+@interface SPPolygonTest : SPTestCase
+
+@end
+
+@implementation SPPolygonTest
+
+- (void)testTriangulateConcavePolygon
+{
+    // an 'L' shape, in both directions
+    GLKVector2 vertices[] = { {0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4} };
+    SPPolygon *polygon = [[SPPolygon alloc] initWithVertices:vertices count:6];
+
+    SPIndexData *indexData = [polygon triangulate:nil];
+    XCTAssertEqual(12, indexData.numIndices, @"wrong number of indices");
+    XCTAssertEqualWithAccuracy(7.0f, [self areaOfTriangles:indexData polygon:polygon], E, @"wrong area");
+
+    [polygon reverse];
+    indexData = [polygon triangulate:nil];
+    XCTAssertEqual(12, indexData.numIndices, @"wrong number of indices");
+    XCTAssertEqualWithAccuracy(7.0f, [self areaOfTriangles:indexData polygon:polygon], E, @"wrong area");
+}
+
+- (void)testTriangulateAppendsIndices
+{
+    SPPolygon *polygon = [SPPolygon rectangleWithX:0 y:0 width:10 height:10];
+    SPIndexData *indexData = [[SPIndexData alloc] init];
+    [indexData appendTriangleWithA:0 b:1 c:2];
+
+    [polygon triangulate:indexData];
+    XCTAssertEqual(9, indexData.numIndices, @"indices were not appended");
+    XCTAssertEqual(2, indexData.indices[2], @"existing indices were overwritten");
+}
+
+- (void)testHoles
+{
+    GLKVector2 outline[] = { {0, 0}, {10, 0}, {10, 10}, {0, 10} };
+    GLKVector2 hole[] = { {2, 2}, {2, 4}, {4, 4}, {4, 2} };
+
+    SPPolygon *polygon = [[SPPolygon alloc] initWithVertices:outline count:4];
+    [polygon addHoleWithVertices:hole count:4];
+    [polygon addHole:[SPPolygon rectangleWithX:6 y:6 width:2 height:2]];
+
+    XCTAssertEqual(2, polygon.numHoles, @"wrong number of holes");
+    XCTAssertEqual(12, polygon.numVertices, @"hole vertices were not appended");
+    XCTAssertEqualWithAccuracy(92.0f, fabsf(polygon.area), E, @"wrong area");
+    XCTAssertFalse(polygon.isConvex, @"polygon with holes can't be convex");
+    XCTAssertTrue(polygon.isSimple, @"holes were treated as intersections");
+
+    XCTAssertTrue([polygon containsPointWithX:1 y:1], @"wrong hit test");
+    XCTAssertFalse([polygon containsPointWithX:3 y:3], @"point inside hole was hit");
+    XCTAssertFalse([polygon containsPointWithX:7 y:7], @"point inside hole was hit");
+
+    // each hole adds two triangles to those of the outline
+
+    SPIndexData *indexData = [polygon triangulate:nil];
+    XCTAssertEqual((12 - 2 + 2 * 2) * 3, indexData.numIndices, @"wrong number of indices");
+    XCTAssertEqualWithAccuracy(92.0f, [self areaOfTriangles:indexData polygon:polygon], E, @"wrong area");
+
+    SPPolygon *copy = [polygon copy];
+    XCTAssertEqual(2, copy.numHoles, @"holes were not copied");
+
+    polygon.numVertices = 8;
+    XCTAssertEqual(1, polygon.numHoles, @"cropped hole was kept");
+}
+
+- (void)testDegenerateContours
+{
+    GLKVector2 outline[] = { {0, 0}, {10, 0}, {10, 10}, {0, 10} };
+    GLKVector2 hole[] = { {2, 2}, {2, 4}, {4, 4}, {4, 2} };
+
+    // a hole cropped to less than a triangle is removed, along with its remaining vertices
+
+    SPPolygon *polygon = [[SPPolygon alloc] initWithVertices:outline count:4];
+    [polygon addHoleWithVertices:hole count:4];
+    [polygon addHole:[SPPolygon rectangleWithX:6 y:6 width:2 height:2]];
+    polygon.numVertices = 10;
+
+    XCTAssertEqual(1, polygon.numHoles, @"degenerate hole was kept");
+    XCTAssertEqual(8, polygon.numVertices, @"vertices of degenerate hole were kept");
+    XCTAssertEqualWithAccuracy(96.0f, [self areaOfTriangles:[polygon triangulate:nil] polygon:polygon],
+                               E, @"wrong area");
+
+    // an outline with less than three vertices yields no triangles, and neither does a hole
+    // on its own; none of its vertices may be referenced
+
+    polygon = [[SPPolygon alloc] initWithVertices:outline count:2];
+    [polygon addHoleWithVertices:hole count:4];
+
+    SPIndexData *indexData = [polygon triangulate:nil];
+    for (NSInteger i=0; i<indexData.numIndices; ++i)
+        XCTAssertTrue(indexData.indices[i] >= 2, @"degenerate outline was triangulated");
+}
+
+- (void)testTriangulateLargePolygon
+{
+    // a star with 10000 vertices, which is far beyond what ear clipping handles in time
+    NSInteger numVertices = 10000;
+    SPPolygon *polygon = [self starWithNumVertices:numVertices];
+
+    SPIndexData *indexData = [polygon triangulate:nil];
+    XCTAssertEqual((numVertices - 2) * 3, indexData.numIndices, @"wrong number of indices");
+    XCTAssertEqualWithAccuracy(fabsf(polygon.area), [self areaOfTriangles:indexData polygon:polygon],
+                               fabsf(polygon.area) * 0.01f, @"triangles overlap");
+}
+
+- (void)testTriangulationPerformance
+{
+    SPPolygon *polygon = [self starWithNumVertices:10000];
+
+    [self measureBlock:^
+    {
+        [polygon triangulate:nil];
+    }];
+}
+
+- (void)testImmutablePolygonsRejectHoles
+{
+    SPPolygon *circle = [SPPolygon circleWithX:0 y:0 radius:10];
+    GLKVector2 hole[] = { {-1, -1}, {1, -1}, {0, 1} };
+
+    XCTAssertThrows([circle addHoleWithVertices:hole count:3], @"immutable polygon was modified");
+}
+
+- (SPPolygon *)starWithNumVertices:(NSInteger)numVertices
+{
+    // a star is concave at every other vertex, the worst case for ear clipping
+    GLKVector2 *vertices = malloc(sizeof(GLKVector2) * numVertices);
+
+    for (NSInteger i=0; i<numVertices; ++i)
+    {
+        float angle = i * 2.0f * PI / numVertices;
+        float radius = i % 2 ? 100.0f : 60.0f;
+        vertices[i] = GLKVector2Make(cosf(angle) * radius, sinf(angle) * radius);
+    }
+
+    SPPolygon *polygon = [[SPPolygon alloc] initWithVertices:vertices count:numVertices];
+    free(vertices);
+    return polygon;
+}
+
+- (float)areaOfTriangles:(SPIndexData *)indexData polygon:(SPPolygon *)polygon
+{
+    // if the triangles don't overlap, their areas sum up to that of the polygon
+    float area = 0.0f;
+
+    for (NSInteger i=0; i<indexData.numIndices; i += 3)
+    {
+        GLKVector2 a = [polygon vertexAtIndex:indexData.indices[i]];
+        GLKVector2 b = [polygon vertexAtIndex:indexData.indices[i+1]];
+        GLKVector2 c = [polygon vertexAtIndex:indexData.indices[i+2]];
+
+        area += fabsf((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / 2.0f;
+    }
+
+    return area;
+}
+
+@end
@@ -0,0 +1,151 @@
+//
+//  SPProfilerTest.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPTestCase.h"
+
+#import <pthread.h>
+
+@interface SPProfilerTest : SPTestCase
+
+@end
+
+@implementation SPProfilerTest
+
+#if SP_PROFILER
+
+- (void)tearDown
+{
+    [SPProfiler stopCapture];
+    [super tearDown];
+}
+
+- (void)testZonesOutsideOfCapture
+{
+    [SPProfiler stopCapture];
+    {
+        SP_PROFILE_ZONE("test.ignored");
+    }
+
+    XCTAssertFalse(SPProfiler.isCapturing, @"profiler should not capture");
+    XCTAssertEqual(0, [self eventsNamed:@"test.ignored"].count, @"zone recorded without capture");
+}
+
+- (void)testNestedZones
+{
+    [SPProfiler startCapture];
+    {
+        SP_PROFILE_ZONE("test.outer");
+        {
+            SP_PROFILE_ZONE("test.inner");
+            [NSThread sleepForTimeInterval:0.001];
+        }
+    }
+    [SPProfiler stopCapture];
+
+    {
+        SP_PROFILE_ZONE("test.afterCapture");
+    }
+
+    NSDictionary *outer = [self eventsNamed:@"test.outer"].firstObject;
+    NSDictionary *inner = [self eventsNamed:@"test.inner"].firstObject;
+
+    XCTAssertNotNil(outer, @"outer zone missing");
+    XCTAssertNotNil(inner, @"inner zone missing");
+    XCTAssertEqualObjects(@"X", outer[@"ph"], @"wrong event phase");
+    XCTAssertEqualObjects(outer[@"tid"], inner[@"tid"], @"zones should share a thread");
+    XCTAssertTrue([inner[@"dur"] doubleValue] >= 1000.0, @"wrong duration");
+    XCTAssertTrue([outer[@"ts"] doubleValue] <= [inner[@"ts"] doubleValue], @"inner zone starts too early");
+    XCTAssertTrue([outer[@"dur"] doubleValue] >= [inner[@"dur"] doubleValue], @"outer zone too short");
+    XCTAssertEqual(0, [self eventsNamed:@"test.afterCapture"].count, @"zone recorded after capture");
+}
+
+- (void)testZonesOnOtherThreads
+{
+    [SPProfiler startCapture];
+
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^
+    {
+        SP_PROFILE_ZONE("test.background");
+    });
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    {
+        SP_PROFILE_ZONE("test.foreground");
+    }
+
+    [SPProfiler stopCapture];
+
+    NSDictionary *background = [self eventsNamed:@"test.background"].firstObject;
+    NSDictionary *foreground = [self eventsNamed:@"test.foreground"].firstObject;
+
+    XCTAssertNotNil(background, @"zone of background thread missing");
+    XCTAssertNotEqualObjects(background[@"tid"], foreground[@"tid"], @"threads were not separated");
+}
+
+- (void)testZonesOfExitedThreads
+{
+    // the buffer of an exited thread is only recycled after its zones were exported
+
+    [SPProfiler startCapture];
+    [self runThreadWithZone:"test.exited"];
+    [self runThreadWithZone:"test.exited"];
+    [SPProfiler stopCapture];
+
+    XCTAssertEqual(2, [self eventsNamed:@"test.exited"].count, @"zones of exited threads missing");
+
+    [SPProfiler startCapture];
+    [self runThreadWithZone:"test.recycled"];
+    [SPProfiler stopCapture];
+
+    XCTAssertEqual(1, [self eventsNamed:@"test.recycled"].count, @"zone of new thread missing");
+    XCTAssertEqual(0, [self eventsNamed:@"test.exited"].count, @"zones of previous capture exported");
+}
+
+static void *recordZone(void *name)
+{
+    SP_PROFILE_ZONE((const char *)name);
+    return NULL;
+}
+
+- (void)runThreadWithZone:(const char *)name
+{
+    pthread_t thread;
+    pthread_create(&thread, NULL, recordZone, (void *)name);
+    pthread_join(thread, NULL); // the thread's destructors have run afterwards
+}
+
+- (void)testCaptureNumFrames
+{
+    [SPProfiler captureNumFrames:2];
+    XCTAssertTrue(SPProfiler.isCapturing, @"pending capture not reported");
+
+    for (int i=0; i<3; ++i)
+    {
+        [SPProfiler beginFrame];
+        SP_PROFILE_ZONE("test.frame");
+    }
+
+    XCTAssertFalse(SPProfiler.isCapturing, @"capture did not stop");
+    XCTAssertEqual(2, [self eventsNamed:@"test.frame"].count, @"wrong number of frames captured");
+}
+
+- (NSArray *)eventsNamed:(NSString *)name
+{
+    NSData *data = [[SPProfiler traceJSON] dataUsingEncoding:NSUTF8StringEncoding];
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"name == %@", name];
+    return [trace[@"traceEvents"] filteredArrayUsingPredicate:predicate];
+}
+
+#endif
+
+@end
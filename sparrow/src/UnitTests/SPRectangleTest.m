@@ -136,6 +136,43 @@
     XCTAssertTrue([[rect uniteWithRectangle:innerRect] isEqualToRectangle:rect], @"wrong union");
 }
 
+- (void)testBoundsAfterTransformation
+{
+    SPRectangle *rect = [SPRectangle rectangleWithX:-10 y:5 width:10 height:20];
+    SPMatrix *matrix = [SPMatrix matrixWithTranslationX:-5 translationY:10];
+    SPRectangle *expectedRect = [SPRectangle rectangleWithX:-15 y:15 width:10 height:20];
+    SPRectangle *bounds = [rect boundsAfterTransformation:matrix];
+    XCTAssertTrue([bounds isEqualToRectangle:expectedRect], @"wrong bounds: %@", bounds);
+
+    matrix = [SPMatrix matrixWithRotation:PI_HALF];
+    expectedRect = [SPRectangle rectangleWithX:-25 y:-10 width:20 height:10];
+    bounds = [rect boundsAfterTransformation:matrix];
+    XCTAssertTrue([bounds isEqualToRectangle:expectedRect], @"wrong bounds: %@", bounds);
+}
+
+- (void)testRectValue
+{
+    SPRectValue value = SPRectValueMake(-5, -10, 10, 20);
+    SPRectangle *rect = [SPRectangle rectangleWithValue:value];
+    XCTAssertTrue([rect isEqualToRectangle:[SPRectangle rectangleWithX:-5 y:-10 width:10 height:20]],
+                  @"wrong rectangle: %@", rect);
+
+    SPRectValue other = SPRectValueMake(-15, -20, 15, 15);
+    XCTAssertTrue(SPRectValueIntersects(value, other), @"rectangles should intersect");
+    XCTAssertTrue([[SPRectangle rectangleWithValue:SPRectValueIntersection(value, other)] isEqualToRectangle:
+                   [SPRectangle rectangleWithX:-5 y:-10 width:5 height:5]], @"wrong intersection shape");
+    XCTAssertTrue([[SPRectangle rectangleWithValue:SPRectValueUnion(value, other)] isEqualToRectangle:
+                   [SPRectangle rectangleWithX:-15 y:-20 width:20 height:30]], @"wrong union");
+
+    XCTAssertTrue(SPRectValueContainsPoint(value, 5, 10), @"point on the edge should be contained");
+    XCTAssertFalse(SPRectValueContainsPoint(value, 6, 0), @"point outside should not be contained");
+
+    SPMatrix *matrix = [SPMatrix matrixWithRotation:PI_HALF];
+    SPRectValue bounds = SPMatrixValueTransformRect(matrix.matrixValue, value);
+    XCTAssertTrue([[SPRectangle rectangleWithValue:bounds] isEqualToRectangle:
+                   [rect boundsAfterTransformation:matrix]], @"wrong bounds");
+}
+
 - (void)testNilArguments
 {
     SPRectangle *rect = [SPRectangle rectangleWithX:0 y:0 width:10 height:20];
@@ -0,0 +1,843 @@
+//
+//  SPRenderSupportTest.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPTestCase.h"
+
+@interface SPRenderSupportTest : SPTestCase
+
+@end
+
+@implementation SPRenderSupportTest
+{
+    SGLRecorderRef _recorder;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    _recorder = sglRecorderCreate();
+    sglRecorderBegin(_recorder);
+}
+
+- (void)tearDown
+{
+    sglRecorderEnd(_recorder);
+    sglRecorderRelease(_recorder);
+
+    [super tearDown];
+}
+
+- (SPSprite *)spriteWithNumQuads:(int)numQuads
+{
+    SPSprite *sprite = [SPSprite sprite];
+
+    for (int i=0; i<numQuads; ++i)
+    {
+        SPQuad *quad = [SPQuad quadWithWidth:10 height:10 color:0xff0000];
+        quad.x = i * 10;
+        [sprite addChild:quad];
+    }
+
+    return sprite;
+}
+
+- (void)testBatching
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:10];
+
+    [sprite render:support];
+    [support finishQuadBatch];
+
+    XCTAssertEqual(1, support.numDrawCalls, @"quads were not batched");
+    XCTAssertEqual(1, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of recorded draw calls");
+    XCTAssertEqual(60, sglRecorderGetNumElementsDrawn(_recorder), @"wrong number of indices drawn");
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) >= 40 * sizeof(SPVertex),
+                  @"vertex data was not uploaded");
+}
+
+- (void)testBatchingBeyond16BitIndices
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPQuad *quad = [SPQuad quadWithWidth:10 height:10];
+
+    for (int i=0; i<20000; ++i)
+        [support batchQuad:quad];
+
+    [support finishQuadBatch];
+
+    XCTAssertEqual(1, support.numDrawCalls, @"large batch was split");
+    XCTAssertEqual(2, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of recorded draw ranges");
+    XCTAssertEqual(120000, sglRecorderGetNumElementsDrawn(_recorder), @"wrong number of indices drawn");
+}
+
+- (SPQuadBatch *)quadBatchWithNumQuads:(int)numQuads
+{
+    SPQuadBatch *quadBatch = [SPQuadBatch quadBatch];
+    SPQuad *quad = [SPQuad quadWithWidth:10 height:10];
+
+    for (int i=0; i<numQuads; ++i)
+        [quadBatch addQuad:quad];
+
+    return quadBatch;
+}
+
+- (uint)boundIndexBuffer
+{
+    int name = 0;
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &name);
+    return name;
+}
+
+- (void)testQuadBatchesShareIndexBuffer
+{
+    SPContext *context = [[SPContext alloc] init];
+    [context makeCurrentContext];
+
+    SPMatrix3D *matrix = [SPMatrix3D matrix3DWithIdentity];
+    SPQuadBatch *quadBatch = [self quadBatchWithNumQuads:10];
+    SPQuadBatch *otherBatch = [self quadBatchWithNumQuads:10];
+
+    [quadBatch renderWithMvpMatrix3D:matrix alpha:1.0f blendMode:SPBlendModeNormal];
+    uint indexBufferName = [self boundIndexBuffer];
+    XCTAssertNotEqual(0, indexBufferName, @"no index buffer bound");
+
+    sglRecorderReset(_recorder);
+    [otherBatch renderWithMvpMatrix3D:matrix alpha:1.0f blendMode:SPBlendModeNormal];
+
+    XCTAssertEqual(indexBufferName, [self boundIndexBuffer], @"index buffer was not shared");
+    XCTAssertEqual(1, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of draw calls");
+    XCTAssertEqual((NSInteger)(otherBatch.capacity * 4 * sizeof(SPVertex)), sglRecorderGetNumBytesUploaded(_recorder),
+                   @"batch uploaded more than its vertices");
+
+    [SPContext setCurrentContext:nil];
+}
+
+- (void)testQuadBatchWithoutContextOwnsIndexBuffer
+{
+    SPMatrix3D *matrix = [SPMatrix3D matrix3DWithIdentity];
+    SPQuadBatch *quadBatch = [self quadBatchWithNumQuads:10];
+
+    [quadBatch renderWithMvpMatrix3D:matrix alpha:1.0f blendMode:SPBlendModeNormal];
+    XCTAssertNotEqual(0, [self boundIndexBuffer], @"no index buffer bound");
+
+    // the indices are only uploaded once
+
+    sglRecorderReset(_recorder);
+    [quadBatch renderWithMvpMatrix3D:matrix alpha:1.0f blendMode:SPBlendModeNormal];
+
+    XCTAssertEqual(1, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of draw calls");
+    XCTAssertEqual(0, sglRecorderGetNumBytesUploaded(_recorder), @"unchanged batch was uploaded");
+}
+
+- (void)testDynamicBatchesStreamUsedVertices
+{
+    SPContext *context = [[SPContext alloc] init];
+    [context makeCurrentContext];
+
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:10];
+    NSInteger numBytes = 40 * sizeof(SPVertex);
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(numBytes, support.numVertexBytesUploaded, @"wrong number of bytes uploaded");
+    XCTAssertEqual(1, [self numCommandsNamed:"glMapBufferRange"], @"vertices were not streamed");
+    XCTAssertEqual(0, [self numCommandsNamed:"glBufferSubData"], @"vertices were uploaded synchronously");
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(numBytes, support.numVertexBytesUploaded, @"wrong number of bytes uploaded");
+    XCTAssertEqual(numBytes, sglRecorderGetNumBytesUploaded(_recorder), @"more than the used vertices were uploaded");
+    XCTAssertEqual(0, [self numCommandsNamed:"glBufferData"], @"stream buffer was reallocated");
+
+    [SPContext setCurrentContext:nil];
+}
+
+- (void)testBlendModeChangeBreaksBatch
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:10];
+    [sprite childAtIndex:5].blendMode = SPBlendModeAdd;
+    support.reordersBatches = NO;
+
+    [sprite render:support];
+    [support finishQuadBatch];
+
+    XCTAssertEqual(3, support.numDrawCalls, @"wrong number of draw calls");
+    XCTAssertEqual(3, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of recorded draw calls");
+}
+
+- (void)testBatchReordering
+{
+    // quads with alternating states that don't overlap: A B A B A B
+
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:6];
+    support.reordersBatches = YES;
+
+    for (int i=1; i<6; i+=2)
+        [sprite childAtIndex:i].blendMode = SPBlendModeAdd;
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(2, support.numDrawCalls, @"interleaved batches were not merged");
+    XCTAssertEqual(2, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of recorded draw calls");
+    XCTAssertEqual(2, support.numMergedBatches, @"wrong number of merged batches");
+    XCTAssertEqual(0, support.numRejectedMerges, @"wrong number of rejected merges");
+
+    // now they overlap; the drawing order must be kept
+
+    for (int i=0; i<6; ++i)
+        [sprite childAtIndex:i].x = i * 5;
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(6, support.numDrawCalls, @"overlapping batches were merged");
+    XCTAssertEqual(0, support.numMergedBatches, @"wrong number of merged batches");
+    XCTAssertEqual(4, support.numRejectedMerges, @"wrong number of rejected merges");
+}
+
+- (void)testBatchReorderingSkipsOverlappingBatch
+{
+    // A B A, with the second A overlapping B, but not the first A
+
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:3];
+    [sprite childAtIndex:1].blendMode = SPBlendModeAdd;
+    [sprite childAtIndex:2].x = 15;
+    support.reordersBatches = YES;
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(3, support.numDrawCalls, @"wrong number of draw calls");
+    XCTAssertEqual(1, support.numRejectedMerges, @"wrong number of rejected merges");
+}
+
+- (void)testOptimizeKeepsVisibleOrder
+{
+    SPSprite *sprite = [self spriteWithNumQuads:4];
+    [sprite childAtIndex:1].blendMode = SPBlendModeAdd;
+    [sprite childAtIndex:3].blendMode = SPBlendModeAdd;
+
+    NSMutableArray *quadBatches = [SPQuadBatch compileObject:sprite];
+    XCTAssertEqual(4, quadBatches.count, @"wrong number of compiled batches");
+
+    [SPQuadBatch optimize:quadBatches];
+    XCTAssertEqual(2, quadBatches.count, @"separate batches were not merged");
+
+    [sprite childAtIndex:2].x = 5;
+
+    quadBatches = [SPQuadBatch compileObject:sprite];
+    [SPQuadBatch optimize:quadBatches];
+    XCTAssertEqual(3, quadBatches.count, @"overlapping batch was moved");
+}
+
+- (void)testReset
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    [[self spriteWithNumQuads:2] render:support];
+    [support finishQuadBatch];
+
+    XCTAssertTrue(sglRecorderGetNumCommands(_recorder) > 0, @"no commands recorded");
+    XCTAssertEqual(1, sglRecorderGetNumCommandsOfType(_recorder, SGLCommandTypeDraw), @"wrong draw commands");
+
+    sglRecorderReset(_recorder);
+
+    XCTAssertEqual(0, sglRecorderGetNumCommands(_recorder), @"commands were not reset");
+    XCTAssertEqual(0, sglRecorderGetNumDrawCalls(_recorder), @"counters were not reset");
+}
+
+- (void)testNestedRecorders
+{
+    SGLRecorderRef innerRecorder = sglRecorderCreate();
+    sglRecorderBegin(innerRecorder);
+
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    [[self spriteWithNumQuads:2] render:support];
+    [support finishQuadBatch];
+
+    XCTAssertEqual(1, sglRecorderGetNumDrawCalls(innerRecorder), @"inner recorder missed the draw call");
+    XCTAssertEqual(0, sglRecorderGetNumDrawCalls(_recorder), @"outer recorder was not replaced");
+
+    // the outer recorder was begun first, so it must be ended last
+    XCTAssertThrows(sglRecorderEnd(_recorder), @"recorders were ended out of order");
+
+    sglRecorderEnd(innerRecorder);
+    sglRecorderRelease(innerRecorder);
+
+    [support nextFrame];
+    [[self spriteWithNumQuads:2] render:support];
+    [support finishQuadBatch];
+    XCTAssertEqual(1, sglRecorderGetNumDrawCalls(_recorder), @"outer recorder was not restored");
+}
+
+- (void)testRenderCache
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:100];
+    sprite.cachesRendering = YES;
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) >= 400 * sizeof(SPVertex),
+                  @"cache was not uploaded");
+    XCTAssertEqual(SPDirtyFlagNone, [sprite childAtIndex:0].dirtyFlags, @"flags were not cleared");
+
+    // nothing changed: nothing must be uploaded
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(1, support.numDrawCalls, @"wrong number of draw calls");
+    XCTAssertEqual(0, sglRecorderGetNumBytesUploaded(_recorder), @"unchanged cache was uploaded");
+
+    // moving the cached container does not invalidate its cache
+
+    sprite.x = 50;
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(0, sglRecorderGetNumBytesUploaded(_recorder), @"cache was rebuilt after moving it");
+
+    // changing a child does
+
+    [sprite childAtIndex:10].y = 20;
+
+    XCTAssertEqual(SPDirtyFlagTransform, [sprite childAtIndex:10].dirtyFlags, @"wrong dirty flags");
+    XCTAssertTrue(sprite.dirtyFlags & SPDirtyFlagChildren, @"change was not propagated");
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) > 0, @"cache was not rebuilt");
+}
+
+- (void)testRenderCacheInvalidation
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [SPSprite sprite];
+    SPSprite *container = [self spriteWithNumQuads:4];
+    SPQuad *quad = (SPQuad *)[container childAtIndex:0];
+    [sprite addChild:container];
+    sprite.cachesRendering = YES;
+
+    [self renderObject:sprite withSupport:support];
+
+    quad.color = 0x00ff00;
+    [self renderObject:sprite withSupport:support];
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) > 0, @"color change was not detected");
+
+    quad.visible = NO;
+    [self renderObject:sprite withSupport:support];
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) > 0, @"visibility change was not detected");
+
+    [container removeChild:quad];
+    [self renderObject:sprite withSupport:support];
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) > 0, @"removal was not detected");
+
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual(0, sglRecorderGetNumBytesUploaded(_recorder), @"unchanged cache was uploaded");
+}
+
+- (void)testRenderCacheOfCopy
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:4];
+    sprite.cachesRendering = YES;
+
+    SPSprite *copy = [sprite copy];
+    SPDisplayObject *child = [copy childAtIndex:0];
+    XCTAssertEqual(copy, child.parent, @"copied child has the wrong parent");
+
+    [self renderObject:copy withSupport:support];
+    float right = copy.bounds.right;
+
+    // changing a child of the copy must invalidate the caches of the copy
+
+    child.x = right + 100;
+    [self renderObject:copy withSupport:support];
+
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) > 0, @"render cache of copy was not rebuilt");
+    XCTAssertEqualWithAccuracy(right + 100 + child.width, copy.bounds.right, E, @"bounds of copy are stale");
+}
+
+- (void)testRenderCacheBypassedForUnsupportedChildren
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:4];
+    SPSprite3D *sprite3D = [SPSprite3D sprite3D];
+    [sprite3D addChild:[SPQuad quadWithWidth:5 height:5]];
+    [sprite addChild:sprite3D];
+    sprite.cachesRendering = YES;
+
+    [self renderObject:sprite withSupport:support];
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) > 0, @"3D content was cached");
+}
+
+- (void)testParallelRendering
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:1000];
+    sprite.rendersInParallel = YES;
+
+    [self renderObject:sprite withSupport:support];
+
+    NSInteger numProcessors = [NSProcessInfo processInfo].activeProcessorCount;
+    XCTAssertEqual(6000, sglRecorderGetNumElementsDrawn(_recorder), @"wrong number of indices drawn");
+    XCTAssertTrue(support.numDrawCalls <= MAX(1, numProcessors), @"ranges were not batched");
+
+    // nothing changed: the collected batches are drawn again, without uploading anything
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(6000, sglRecorderGetNumElementsDrawn(_recorder), @"wrong number of indices drawn");
+    XCTAssertEqual(0, sglRecorderGetNumBytesUploaded(_recorder), @"unchanged children were collected");
+
+    [sprite childAtIndex:0].x = -10;
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertTrue(sglRecorderGetNumBytesUploaded(_recorder) > 0, @"changed children were not collected");
+
+    // unsupported children: normal rendering
+
+    SPSprite3D *sprite3D = [SPSprite3D sprite3D];
+    [sprite3D addChild:[SPQuad quadWithWidth:5 height:5]];
+    [sprite addChild:sprite3D];
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(6006, sglRecorderGetNumElementsDrawn(_recorder), @"wrong number of indices drawn");
+}
+
+- (void)testSerialRenderingPerformance
+{
+    [self measureRenderingInParallel:NO];
+}
+
+- (void)testParallelRenderingPerformance
+{
+    [self measureRenderingInParallel:YES];
+}
+
+- (void)measureRenderingInParallel:(BOOL)inParallel
+{
+    // like the benchmark scene: all objects are rotated in every frame
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:2000];
+    sprite.rendersInParallel = inParallel;
+
+    [self measureBlock:^
+    {
+        for (int frame=0; frame<30; ++frame)
+        {
+            for (SPDisplayObject *child in sprite) child.rotation += 0.05f;
+            [self renderObject:sprite withSupport:support];
+        }
+    }];
+}
+
+- (void)testCulling
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    [support setProjectionMatrixWithX:0 y:0 width:100 height:100];
+
+    SPSprite *sprite = [self spriteWithNumQuads:10];
+    for (int i=5; i<10; ++i) [sprite childAtIndex:i].x += 200;
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(60, sglRecorderGetNumElementsDrawn(_recorder), @"culling is active per default");
+    XCTAssertEqual(0, support.numCulledObjects, @"wrong number of culled objects");
+
+    sprite.cullsChildren = YES;
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(30, sglRecorderGetNumElementsDrawn(_recorder), @"off-screen quads were drawn");
+    XCTAssertEqual(5, support.numCulledObjects, @"wrong number of culled objects");
+
+    // the current clip rect limits the visible area even more
+
+    sglRecorderReset(_recorder);
+    [support nextFrame];
+    [support pushClipRect:[SPRectangle rectangleWithX:0 y:0 width:15 height:100]];
+    [sprite render:support];
+    [support popClipRect];
+    [support finishQuadBatch];
+
+    XCTAssertEqual(12, sglRecorderGetNumElementsDrawn(_recorder), @"clipped quads were drawn");
+    XCTAssertEqual(8, support.numCulledObjects, @"wrong number of culled objects");
+}
+
+- (void)testMultiTextureBatching
+{
+    // 16 images with 4 interleaved textures: A B C D A B C D ...
+
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [SPSprite sprite];
+    NSMutableArray *textures = [NSMutableArray array];
+    support.reordersBatches = NO;
+
+    for (int i=0; i<4; ++i)
+        [textures addObject:[[SPGLTexture alloc] initWithName:i+1 format:SPTextureFormatRGBA
+                                                        width:16 height:16 containsMipmaps:NO
+                                                        scale:1.0f premultipliedAlpha:YES]];
+    for (int i=0; i<16; ++i)
+    {
+        SPImage *image = [SPImage imageWithTexture:textures[i % 4]];
+        image.x = i * 16;
+        [sprite addChild:image];
+    }
+
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual(16, sglRecorderGetNumDrawCalls(_recorder), @"wrong number of draw calls");
+
+    support.maxNumTexturesPerBatch = 4;
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual(1, sglRecorderGetNumDrawCalls(_recorder), @"textures were not batched");
+    XCTAssertEqual(4, [self numCommandsNamed:"glBindTexture"], @"wrong number of texture bindings");
+
+    support.maxNumTexturesPerBatch = 2;
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual(8, sglRecorderGetNumDrawCalls(_recorder), @"batch did not break when slots ran out");
+
+    support.maxNumTexturesPerBatch = 100;
+    XCTAssertEqual([SPBaseEffect maxNumTextures], support.maxNumTexturesPerBatch, @"value was not clamped");
+}
+
+- (void)testCompactVertexFormat
+{
+    SPContext *context = [[SPContext alloc] init];
+    [context makeCurrentContext];
+
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [SPSprite sprite];
+    SPTexture *texture = [[SPGLTexture alloc] initWithName:1 format:SPTextureFormatRGBA width:16 height:16
+                                           containsMipmaps:NO scale:1.0f premultipliedAlpha:YES];
+    for (int i=0; i<10; ++i)
+    {
+        SPImage *image = [SPImage imageWithTexture:texture];
+        image.x = i * 16;
+        [sprite addChild:image];
+    }
+
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual((NSInteger)(40 * sizeof(SPVertex)), support.numVertexBytesUploaded,
+                   @"wrong number of bytes uploaded");
+
+    // untinted, textured quads only need positions and 16 bit texture coordinates
+
+    support.vertexFormat = SPVertexFormatCompact;
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual(40 * 12, support.numVertexBytesUploaded, @"vertices were not packed");
+    XCTAssertEqual(40 * 12, sglRecorderGetNumBytesUploaded(_recorder), @"vertices were not packed");
+
+    // tinted quads keep their colors
+
+    for (SPDisplayObject *child in sprite) child.alpha = 0.5f;
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual(40 * 16, support.numVertexBytesUploaded, @"colors were left out");
+
+    [SPContext setCurrentContext:nil];
+}
+
+#if SP_RENDER_DIAGNOSTICS
+
+- (void)testRenderDiagnostics
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:10];
+    SPDisplayObject *addedQuad = [sprite childAtIndex:5];
+    addedQuad.blendMode = SPBlendModeAdd;
+    support.reordersBatches = NO;
+
+    XCTAssertNil(support.diagnostics, @"diagnostics recorded without being enabled");
+    support.recordsDiagnostics = YES;
+
+    [self renderObject:sprite withSupport:support];
+
+    SPRenderDiagnostics *diagnostics = support.diagnostics;
+    NSArray<SPBatchRecord*> *batches = diagnostics.batches;
+
+    XCTAssertEqual(3, batches.count, @"wrong number of recorded batches");
+    XCTAssertEqual(10, diagnostics.numQuads, @"wrong number of recorded quads");
+    XCTAssertEqual(2, [diagnostics numBatchesWithReason:SPBatchBreakReasonBlendMode], @"wrong reason");
+    XCTAssertEqual(1, [diagnostics numBatchesWithReason:SPBatchBreakReasonExplicit], @"wrong reason");
+
+    XCTAssertEqual(5, batches[0].numQuads, @"wrong number of quads in batch");
+    XCTAssertEqual(addedQuad, batches[0].object, @"wrong object caused the break");
+    XCTAssertEqual(1, batches[1].numQuads, @"wrong number of quads in batch");
+    XCTAssertEqual(4, batches[2].numQuads, @"wrong number of quads in batch");
+
+    // clip rects end batches, too; the records are reset with each frame
+
+    addedQuad.blendMode = SPBlendModeAuto;
+
+    [support nextFrame];
+    [sprite render:support];
+    [support pushClipRect:[SPRectangle rectangleWithX:0 y:0 width:50 height:50]];
+    [sprite render:support];
+    [support popClipRect];
+    [support finishQuadBatch];
+
+    XCTAssertEqual(2, diagnostics.batches.count, @"records were not reset");
+    XCTAssertEqual(2, [diagnostics numBatchesWithReason:SPBatchBreakReasonClipRect], @"wrong reason");
+
+    NSData *json = [diagnostics.JSONString dataUsingEncoding:NSUTF8StringEncoding];
+    NSDictionary *object = [NSJSONSerialization JSONObjectWithData:json options:0 error:nil];
+    XCTAssertEqualObjects(@2, object[@"numDrawCalls"], @"wrong JSON output");
+    XCTAssertEqualObjects(@2, object[@"reasons"][@"clipRect"], @"wrong JSON output");
+
+    support.recordsDiagnostics = NO;
+    XCTAssertNil(support.diagnostics, @"diagnostics were not disabled");
+}
+
+#endif
+
+- (void)testOverdrawAnalysis
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPOverdrawAnalysis *analysis = [[SPOverdrawAnalysis alloc] initWithWidth:320 height:480];
+    support.overdrawAnalysis = analysis;
+
+    SPSprite *sprite = [SPSprite sprite];
+    SPQuad *quad1 = [SPQuad quadWithWidth:100 height:100];
+    SPQuad *quad2 = [SPQuad quadWithWidth:200 height:100];
+    quad2.x = 50;
+    [sprite addChild:quad1];
+    [sprite addChild:quad2];
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(30000, analysis.numDrawnPixels, @"wrong number of drawn pixels");
+    XCTAssertEqual(25000, analysis.numCoveredPixels, @"wrong number of covered pixels");
+    XCTAssertEqual(2, analysis.maxDepth, @"wrong maximum depth");
+    XCTAssertEqual(2, [analysis depthAtX:75 y:50], @"wrong depth of overlapping region");
+    XCTAssertEqual(1, [analysis depthAtX:200 y:50], @"wrong depth of single quad");
+    XCTAssertEqual(0, [analysis depthAtX:300 y:50], @"wrong depth of empty region");
+    XCTAssertEqualWithAccuracy(30000.0f / (320 * 480), analysis.overdrawFactor, E, @"wrong factor");
+
+    NSArray<SPOverdrawRecord*> *records = [analysis objectsByAreaWithLimit:1];
+    XCTAssertEqual(1, records.count, @"limit was ignored");
+    XCTAssertEqual(quad2, records[0].object, @"wrong object with biggest area");
+    XCTAssertEqual(20000, records[0].numPixels, @"wrong area of object");
+
+    // pixels outside the clip rect are not drawn; the analysis is reset with each frame
+
+    [support nextFrame];
+    [support pushClipRect:[SPRectangle rectangleWithX:0 y:0 width:50 height:50]];
+    [sprite render:support];
+    [support popClipRect];
+    [support finishQuadBatch];
+
+    XCTAssertEqual(2500, analysis.numDrawnPixels, @"clip rect was ignored");
+    XCTAssertEqual(1, analysis.maxDepth, @"analysis was not reset");
+}
+
+- (void)testOcclusionCulling
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPOverdrawAnalysis *analysis = [[SPOverdrawAnalysis alloc] initWithWidth:320 height:480];
+    support.overdrawAnalysis = analysis;
+
+    SPQuad *background = [SPQuad quadWithWidth:320 height:480 color:0x0000ff];
+    SPQuad *hiddenPanel = [SPQuad quadWithWidth:100 height:100];
+    hiddenPanel.x = hiddenPanel.y = 10;
+    SPQuad *partlyHiddenPanel = [SPQuad quadWithWidth:100 height:100];
+    partlyHiddenPanel.x = 150;
+    SPQuad *overlay = [SPQuad quadWithWidth:200 height:200 color:0xff0000];
+    SPQuad *translucentQuad = [SPQuad quadWithWidth:320 height:480];
+    translucentQuad.alpha = 0.5f;
+
+    SPSprite *panels = [SPSprite sprite];
+    [panels addChild:hiddenPanel];
+    [panels addChild:partlyHiddenPanel];
+
+    SPSprite *sprite = [SPSprite sprite];
+    [sprite addChild:background];
+    [sprite addChild:panels];
+    [sprite addChild:overlay];
+    [sprite addChild:translucentQuad];
+
+    [self renderObject:sprite withSupport:support];
+    NSInteger numPixelsWithoutCulling = analysis.numDrawnPixels;
+
+    support.cullsOccludedObjects = YES;
+    [support nextFrame];
+    [support findOccludedObjectsOf:sprite];
+    [sprite render:support];
+    [support finishQuadBatch];
+
+    XCTAssertTrue([support isObjectOccluded:hiddenPanel], @"hidden quad not detected");
+    XCTAssertFalse([support isObjectOccluded:partlyHiddenPanel], @"partly hidden quad was culled");
+    XCTAssertFalse([support isObjectOccluded:background], @"translucent quad occluded an object");
+    XCTAssertEqual(1, support.numOccludedObjects, @"wrong number of occluded objects");
+    XCTAssertEqual(numPixelsWithoutCulling - 10000, analysis.numDrawnPixels, @"hidden quad was drawn");
+
+    // rotated quads don't occlude anything
+
+    overlay.rotation = 0.1f;
+    [support nextFrame];
+    [support findOccludedObjectsOf:sprite];
+
+    XCTAssertEqual(0, support.numOccludedObjects, @"rotated quad occluded an object");
+
+    // flattened sprites neither occlude anything nor have occluded descendants
+
+    overlay.rotation = 0.0f;
+    [overlay removeFromParent];
+    SPSprite *flattenedOverlay = [SPSprite sprite];
+    [flattenedOverlay addChild:overlay];
+    [flattenedOverlay addChild:[SPQuad quadWithWidth:100 height:100]];
+    [sprite addChild:flattenedOverlay atIndex:sprite.numChildren - 1];
+    [flattenedOverlay flatten];
+
+    [support nextFrame];
+    [support findOccludedObjectsOf:sprite];
+
+    XCTAssertEqual(0, support.numOccludedObjects, @"flattened sprite occluded an object");
+
+    [sprite addChild:[SPQuad quadWithWidth:320 height:480] atIndex:sprite.numChildren - 1];
+    [support nextFrame];
+    [support findOccludedObjectsOf:sprite];
+
+    XCTAssertTrue([support isObjectOccluded:flattenedOverlay], @"hidden flattened sprite not detected");
+    XCTAssertFalse([support isObjectOccluded:overlay], @"child of flattened sprite was tested");
+}
+
+- (void)testClipsQuadsOnCPU
+{
+    SPContext *context = [[SPContext alloc] init];
+    [context makeCurrentContext];
+
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPOverdrawAnalysis *analysis = [[SPOverdrawAnalysis alloc] initWithWidth:320 height:480];
+    support.overdrawAnalysis = analysis;
+
+    // like the panes of a scrolling list: each one is clipped to a part of its contents
+
+    SPSprite *sprite = [SPSprite sprite];
+    for (int i=0; i<10; ++i)
+    {
+        SPSprite *pane = [self spriteWithNumQuads:1];
+        pane.x = i * 20;
+        pane.clipRect = [SPRectangle rectangleWithX:0 y:0 width:5 height:10];
+        [sprite addChild:pane];
+    }
+
+    [self renderObject:sprite withSupport:support];
+    XCTAssertEqual(10, support.numDrawCalls, @"clip rects should end batches per default");
+
+    support.clipsQuads = YES;
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(1, support.numDrawCalls, @"clip rects broke the batch");
+    XCTAssertEqual(0, [self numCommandsNamed:"glScissor"], @"scissor rectangle was used");
+    XCTAssertEqual(500, analysis.numDrawnPixels, @"quads were not clipped");
+    XCTAssertEqual(1, [analysis depthAtX:24 y:5], @"clipped quad was moved");
+    XCTAssertEqual(0, [analysis depthAtX:25 y:5], @"clipped area was drawn");
+
+    // rotated quads can't be cut, so they fall back to the scissor rectangle
+
+    [[sprite childAtIndex:5] childAtIndex:0].rotation = 0.1f;
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(3, support.numDrawCalls, @"wrong number of draw calls");
+    XCTAssertEqual(1, [self numCommandsNamed:"glScissor"], @"scissor rectangle was not used");
+
+    support.clipsQuads = NO;
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(10, support.numDrawCalls, @"clip rects should end batches");
+
+    [SPContext setCurrentContext:nil];
+}
+
+- (void)testRectangularMasks
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPOverdrawAnalysis *analysis = [[SPOverdrawAnalysis alloc] initWithWidth:320 height:480];
+    support.overdrawAnalysis = analysis;
+
+    SPQuad *mask = [SPQuad quadWithWidth:25 height:10];
+    SPSprite *maskedSprite = [self spriteWithNumQuads:10];
+    maskedSprite.x = 10;
+    maskedSprite.mask = mask;
+    support.clipsQuads = YES;
+
+    SPSprite *sprite = [self spriteWithNumQuads:2];
+    [sprite addChild:maskedSprite];
+
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(1, support.numClippingMasks, @"rectangular mask was not replaced");
+    XCTAssertEqual(0, support.numStencilMasks, @"rectangular mask was drawn");
+    XCTAssertEqual(1, support.numDrawCalls, @"mask broke the batch");
+    XCTAssertEqual(0, [self numCommandsNamed:"glStencilOp"], @"stencil buffer was used");
+    XCTAssertEqual(200 + 250, analysis.numDrawnPixels, @"mask was not applied");
+    XCTAssertEqual(1, [analysis depthAtX:34 y:5], @"masked area was cut off");
+    XCTAssertEqual(0, [analysis depthAtX:35 y:5], @"area outside of mask was drawn");
+
+    // rotated masks still need the stencil buffer
+
+    mask.rotation = 0.1f;
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(0, support.numClippingMasks, @"rotated mask was replaced");
+    XCTAssertEqual(1, support.numStencilMasks, @"rotated mask was not drawn");
+    XCTAssertTrue([self numCommandsNamed:"glStencilOp"] > 0, @"stencil buffer was not used");
+}
+
+- (void)testGeometryAllocationsPerFrame
+{
+    SPRenderSupport *support = [[SPRenderSupport alloc] init];
+    SPSprite *sprite = [self spriteWithNumQuads:100];
+    [sprite addChild:[self spriteWithNumQuads:10]];
+    sprite.cullsChildren = YES;
+    for (SPDisplayObject *child in sprite) child.rotation = 0.5f;
+
+    [self renderObject:sprite withSupport:support];
+
+    // like the benchmark scene: rotate all objects, then render another frame
+
+    NSInteger numAllocations = [self numGeometryAllocations];
+    for (SPDisplayObject *child in sprite) child.rotation += 0.05f;
+    [self renderObject:sprite withSupport:support];
+
+    XCTAssertEqual(0, [self numGeometryAllocations] - numAllocations,
+                   @"temporary geometry objects were allocated while rendering");
+}
+
+- (NSInteger)numGeometryAllocations
+{
+    return [SPPoint numAllocations] + [SPRectangle numAllocations] + [SPMatrix numAllocations];
+}
+
+- (NSInteger)numCommandsNamed:(const char *)name
+{
+    NSInteger count = 0;
+
+    for (NSInteger i=0; i<sglRecorderGetNumCommands(_recorder); ++i)
+        if (strcmp(sglRecorderGetCommandAtIndex(_recorder, i)->name, name) == 0) ++count;
+
+    return count;
+}
+
+- (void)renderObject:(SPDisplayObject *)object withSupport:(SPRenderSupport *)support
+{
+    sglRecorderReset(_recorder);
+
+    [support nextFrame];
+    [object render:support];
+    [support finishQuadBatch];
+}
+
+@end
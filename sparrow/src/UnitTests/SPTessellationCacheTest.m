@@ -0,0 +1,148 @@
+//
+//  SPTessellationCacheTest.m
+//  Sparrow
+//
+//  Created by Robert Carone on 10/17/15.
+//  Copyright 2011-2014 Gamua. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the Simplified BSD License.
+//
+
+#import "SPTestCase.h"
+
+@interface SPTessellationCacheTest : SPTestCase
+
+@end
+
+@implementation SPTessellationCacheTest
+
+- (void)testHitsAndMisses
+{
+    SPTessellationCache *cache = [[SPTessellationCache alloc] init];
+
+    SPTessellation *circle = [cache tessellationOfEllipseWithRadiusX:10 radiusY:10];
+    SPTessellation *rectangle = [cache tessellationOfRectangleWithWidth:10 height:10];
+
+    XCTAssertEqual(2, cache.numMisses, @"wrong number of misses");
+    XCTAssertEqual(0, cache.numHits, @"wrong number of hits");
+    XCTAssertEqual(2, cache.numTessellations, @"tessellations were not stored");
+
+    XCTAssertEqual(circle, [cache tessellationOfEllipseWithRadiusX:10 radiusY:10], @"circle was not cached");
+    XCTAssertEqual(rectangle, [cache tessellationOfRectangleWithWidth:10 height:10], @"rectangle was not cached");
+    XCTAssertNotEqual(circle, [cache tessellationOfEllipseWithRadiusX:10 radiusY:20], @"wrong ellipse returned");
+
+    XCTAssertEqual(2, cache.numHits, @"wrong number of hits");
+    XCTAssertEqual(3, cache.numMisses, @"wrong number of misses");
+    XCTAssertEqualWithAccuracy(0.4f, cache.hitRate, E, @"wrong hit rate");
+    XCTAssertTrue(cache.savedTime > 0.0, @"saved time was not accumulated");
+
+    [cache resetStatistics];
+    XCTAssertEqual(0, cache.numHits, @"statistics were not reset");
+    XCTAssertEqual(0.0f, cache.hitRate, @"statistics were not reset");
+
+    [cache purge];
+    XCTAssertEqual(0, cache.numTessellations, @"cache was not purged");
+    XCTAssertEqual(0, cache.numVertices, @"cache was not purged");
+}
+
+- (void)testTessellationsMatchPolygons
+{
+    SPTessellationCache *cache = [[SPTessellationCache alloc] init];
+    SPPolygon *ellipse = [SPPolygon elipseWithX:0 y:0 radiusX:30 radiusY:20];
+    SPTessellation *tessellation = [cache tessellationOfEllipseWithRadiusX:30 radiusY:20];
+
+    XCTAssertEqual(ellipse.numVertices, tessellation.vertexData.numVertices, @"wrong number of vertices");
+    XCTAssertEqual([ellipse triangulate:nil].numIndices, tessellation.indexData.numIndices,
+                   @"wrong number of indices");
+
+    for (NSInteger i=0; i<ellipse.numVertices; ++i)
+    {
+        GLKVector2 expected = [ellipse vertexAtIndex:i];
+        GLKVector2 actual = [tessellation.vertexData vertexAtIndex:i].position;
+        XCTAssertTrue(GLKVector2AllEqualToVector2(expected, actual), @"wrong vertex at index %d", (int)i);
+    }
+}
+
+- (void)testPolygonsAreCachedByContent
+{
+    SPTessellationCache *cache = [[SPTessellationCache alloc] init];
+    GLKVector2 vertices[] = { {0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4} };
+
+    SPPolygon *polygon = [[SPPolygon alloc] initWithVertices:vertices count:6];
+    SPPolygon *equalPolygon = [[SPPolygon alloc] initWithVertices:vertices count:6];
+    SPTessellation *tessellation = [cache tessellationOfPolygon:polygon];
+
+    XCTAssertEqual(tessellation, [cache tessellationOfPolygon:equalPolygon], @"equal polygon was not found");
+    XCTAssertNotEqual(polygon, tessellation.polygon, @"mutable polygon was not copied");
+    XCTAssertThrows([tessellation.polygon setVertexWithX:5 y:0 atIndex:1], @"cached polygon is mutable");
+
+    // modifying the polygon must neither change the cached copy nor find it
+
+    [polygon setVertexWithX:5 y:0 atIndex:1];
+    XCTAssertEqual(4.0f, [tessellation.polygon vertexAtIndex:1].x, @"cached polygon was modified");
+    XCTAssertNotEqual(tessellation, [cache tessellationOfPolygon:polygon], @"modified polygon was found");
+
+    // holes are part of the key
+
+    [equalPolygon addHole:[SPPolygon rectangleWithX:0.25f y:0.25f width:0.5f height:0.5f]];
+    XCTAssertNotEqual(tessellation, [cache tessellationOfPolygon:equalPolygon], @"holes were ignored");
+    XCTAssertEqual(1, cache.numHits, @"wrong number of hits");
+}
+
+- (void)testLeastRecentlyUsedShapesAreDiscarded
+{
+    // rectangles have 4 vertices each, so the cache fits 3 of them
+    SPTessellationCache *cache = [[SPTessellationCache alloc] initWithCapacity:12];
+
+    SPTessellation *first = [cache tessellationOfRectangleWithWidth:1 height:1];
+    [cache tessellationOfRectangleWithWidth:2 height:2];
+    [cache tessellationOfRectangleWithWidth:3 height:3];
+    XCTAssertEqual(12, cache.numVertices, @"wrong number of vertices");
+
+    // using the first rectangle again makes the second one the oldest
+
+    [cache tessellationOfRectangleWithWidth:1 height:1];
+    [cache tessellationOfRectangleWithWidth:4 height:4];
+
+    XCTAssertEqual(3, cache.numTessellations, @"cache exceeded its capacity");
+    XCTAssertEqual(first, [cache tessellationOfRectangleWithWidth:1 height:1], @"recently used shape was discarded");
+
+    [cache resetStatistics];
+    [cache tessellationOfRectangleWithWidth:2 height:2];
+    XCTAssertEqual(1, cache.numMisses, @"oldest shape was kept");
+
+    // shapes that exceed the capacity are returned, but not stored
+
+    SPTessellation *circle = [cache tessellationOfEllipseWithRadiusX:100 radiusY:100];
+    XCTAssertNotNil(circle, @"big shape was not created");
+    XCTAssertEqual(12, cache.numVertices, @"big shape was stored");
+
+    cache.capacity = 4;
+    XCTAssertEqual(1, cache.numTessellations, @"lowering the capacity did not discard shapes");
+    XCTAssertEqual(4, cache.numVertices, @"wrong number of vertices");
+}
+
+- (void)testCanvasTranslatesCachedShapes
+{
+    SPCanvas *canvas = [[SPCanvas alloc] init];
+    [canvas drawCircleWithX:100 y:100 radius:10];
+    [canvas drawRectangleWithX:200 y:0 width:10 height:10];
+    [canvas drawCircleWithX:0 y:0 radius:10];
+
+    // the circles have 15 sides, so they don't reach their radius in every direction
+    SPRectangle *bounds = canvas.bounds;
+    XCTAssertEqualWithAccuracy(-10.0f, bounds.x, 0.5f, @"wrong bounds");
+    XCTAssertEqualWithAccuracy(210.0f, bounds.right, E, @"wrong bounds");
+    XCTAssertEqualWithAccuracy(110.0f, bounds.bottom, 0.5f, @"wrong bounds");
+
+    XCTAssertNotNil([canvas hitTestPoint:[SPPoint pointWithX:105 y:95]], @"translated circle was not hit");
+    XCTAssertNotNil([canvas hitTestPoint:[SPPoint pointWithX:205 y:5]], @"translated rectangle was not hit");
+    XCTAssertNil([canvas hitTestPoint:[SPPoint pointWithX:100 y:80]], @"wrong hit test");
+    XCTAssertNil([canvas hitTestPoint:[SPPoint pointWithX:5 y:15]], @"wrong hit test");
+
+    SPCanvas *copy = [canvas copy];
+    XCTAssertNotNil([copy hitTestPoint:[SPPoint pointWithX:105 y:95]], @"offsets were not copied");
+}
+
+@end
@@ -57,4 +57,18 @@
     XCTAssertTrue([expectedNames isEqualToArray:names], @"wrong names array");
 }
 
+- (void)testOpaqueRegions
+{
+    SPTexture *texture = [[SPTexture alloc] initWithWidth:100 height:100];
+    SPTextureAtlas *atlas = [[SPTextureAtlas alloc] initWithTexture:texture];
+    SPRectangle *region = [SPRectangle rectangleWithX:0 y:0 width:50 height:50];
+
+    [atlas addRegion:region withName:@"transparent"];
+    [atlas addRegion:region withName:@"opaque" frame:nil rotated:NO opaque:YES];
+
+    XCTAssertFalse(texture.opaque, @"texture with alpha channel reported as opaque");
+    XCTAssertFalse([atlas textureByName:@"transparent"].opaque, @"region should not be opaque");
+    XCTAssertTrue([atlas textureByName:@"opaque"].opaque, @"opaque flag of region was lost");
+}
+
 @end
\ No newline at end of file
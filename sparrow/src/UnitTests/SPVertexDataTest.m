@@ -220,6 +220,134 @@
     [self compareVertex:vertex        withVertex:[targetData vertexAtIndex:4]];
 }
 
+- (void)testCopyTransformedFromIndex
+{
+    SPVertex defaultVertex = [self defaultVertex];
+    SPVertex vertex = [self anyVertex];
+    SPVertexData *sourceData = [[SPVertexData alloc] init];
+
+    [sourceData appendVertex:defaultVertex];
+    [sourceData appendVertex:vertex];
+
+    SPVertexData *targetData = [[SPVertexData alloc] initWithSize:1 premultipliedAlpha:NO];
+    SPMatrix *matrix = [[SPMatrix alloc] init];
+    [matrix translateXBy:10.0f yBy:20.0f];
+
+    [sourceData copyTransformedToVertexData:targetData atIndex:0 matrix:matrix fromIndex:1 numVertices:1];
+
+    SPVertex expectedVertex = vertex;
+    expectedVertex.position.x = 11.0f;
+    expectedVertex.position.y = 22.0f;
+
+    [self compareVertex:expectedVertex withVertex:[targetData vertexAtIndex:0]];
+}
+
+- (void)testCopyWithinSameData
+{
+    SPVertexData *vertexData = [[SPVertexData alloc] initWithSize:4];
+
+    for (int i=0; i<4; ++i)
+        [vertexData setPositionWithX:i y:i atIndex:i];
+
+    // the source and target ranges overlap
+    [vertexData copyTransformedToVertexData:vertexData atIndex:1 matrix:nil fromIndex:0 numVertices:3];
+
+    float expectedX[] = { 0, 0, 1, 2 };
+    for (int i=0; i<4; ++i)
+        XCTAssertEqual(expectedX[i], [vertexData vertexAtIndex:i].position.x, @"wrong vertex at index %d", i);
+}
+
+- (void)testTransformKernels
+{
+    int numVertices = 1003;
+    SPVertexData *vertexData = [[SPVertexData alloc] initWithSize:numVertices];
+    SPVertexData *referenceData = [[SPVertexData alloc] initWithSize:numVertices];
+
+    for (int i=0; i<numVertices; ++i)
+    {
+        SPVertex vertex = [self anyVertex];
+        vertex.position = GLKVector2Make(i * 0.5f, 3.0f - i * 0.25f);
+
+        // distinct attributes per vertex reveal any lanes the shuffles might mix up
+        vertex.texCoords = GLKVector2Make(i * 0.001f, 1.0f - i * 0.001f);
+        vertex.color = SPVertexColorMake(i % 256, (i * 7) % 256, (i * 13) % 256, 255 - i % 256);
+        vertexData.vertices[i] = referenceData.vertices[i] = vertex;
+    }
+
+    SPMatrix *matrix = [[SPMatrix alloc] initWithA:1.5f b:0.3f c:-0.7f d:2.0f tx:10.0f ty:-5.0f];
+    GLKMatrix3 glkMatrix = [matrix convertToGLKMatrix3];
+
+    SPVertexTransformPositions(vertexData.vertices, numVertices, glkMatrix);
+    SPVertexTransformPositionsScalar(referenceData.vertices, numVertices, glkMatrix);
+
+    [self compareVertexData:vertexData withVertexData:referenceData];
+}
+
+- (void)testPackVertices
+{
+    SPVertexData *vertexData = [[SPVertexData alloc] initWithSize:2];
+    SPVertex vertex = [self anyVertex];
+    vertex.texCoords = GLKVector2Make(0.25f, 1.0f);
+    vertexData.vertices[1] = vertex;
+
+    SPVertexLayout standard = SPVertexLayoutMake(SPVertexFormatStandard);
+    XCTAssertEqual(20, (int)sizeof(SPVertex), @"SPVertex grew");
+    XCTAssertEqual((int)sizeof(SPVertex), standard.stride, @"standard layout differs from SPVertex");
+    XCTAssertEqual((int)offsetof(SPVertex, color), standard.color, @"standard layout differs from SPVertex");
+    XCTAssertEqual(-1, standard.textureSlot, @"standard layout contains a texture slot");
+
+    SPVertexLayout slotted = SPVertexLayoutMake(SPVertexFormatTextureSlot);
+    XCTAssertEqual(24, slotted.stride, @"wrong stride");
+    XCTAssertEqual(20, slotted.textureSlot, @"texture slot was not appended");
+
+    SPVertexFormat format = SPVertexFormatHalfPositions | SPVertexFormatShortTexCoords;
+    SPVertexLayout layout = SPVertexLayoutMake(format);
+    XCTAssertEqual(12, layout.stride, @"wrong stride");
+
+    char buffer[24];
+    XCTAssertEqual(12, [vertexData packVerticesInFormat:format intoBuffer:buffer atIndex:1 numVertices:1],
+                   @"wrong number of bytes written");
+
+    __fp16 *position = (__fp16 *)buffer;
+    ushort *texCoords = (ushort *)(buffer + layout.texCoords);
+    SPVertexColor *color = (SPVertexColor *)(buffer + layout.color);
+
+    XCTAssertEqual(1.0f, (float)position[0], @"wrong x coordinate");
+    XCTAssertEqual(2.0f, (float)position[1], @"wrong y coordinate");
+    XCTAssertEqual(16384, texCoords[0], @"wrong u coordinate");
+    XCTAssertEqual(65535, texCoords[1], @"wrong v coordinate");
+    XCTAssertEqual(127, color->a, @"wrong alpha");
+
+    layout = SPVertexLayoutMake(SPVertexFormatCompact);
+    XCTAssertEqual(8, layout.stride, @"compact layout contains more than positions");
+}
+
+- (void)testTransformPerformance
+{
+    [self measureTransformWithKernel:SPVertexTransformPositions];
+}
+
+- (void)testScalarTransformPerformance
+{
+    [self measureTransformWithKernel:SPVertexTransformPositionsScalar];
+}
+
+- (void)measureTransformWithKernel:(void (*)(SPVertex *, NSInteger, GLKMatrix3))kernel
+{
+    int numVertices = 4 * 8192;
+    int numIterations = 100;
+
+    SPVertexData *vertexData = [[SPVertexData alloc] initWithSize:numVertices];
+    SPMatrix *matrix = [[SPMatrix alloc] initWithA:0.99f b:0.01f c:-0.01f d:0.99f tx:0.5f ty:-0.5f];
+    GLKMatrix3 glkMatrix = [matrix convertToGLKMatrix3];
+
+    [self measureBlock:^
+    {
+        for (int i=0; i<numIterations; ++i)
+            kernel(vertexData.vertices, numVertices, glkMatrix);
+    }];
+}
+
 - (SPVertex)defaultVertex
 {
     SPVertex vertex = {